@@ -0,0 +1,126 @@
+#include "bars.h"
+#include <cmath>
+#include <cstdlib>
+
+bool parseBarSpec(const std::string &text, BarSpec &spec)
+{
+    size_t colon = text.find(':');
+    if (colon == std::string::npos)
+        return false;
+    std::string type = text.substr(0, colon);
+    const char *begin = text.c_str() + colon + 1;
+    char *end = nullptr;
+    double size = std::strtod(begin, &end);
+    if (end == begin || *end != '\0' || !(size > 0.0))
+        return false;
+    if (type == "time")
+        spec.type = BarType::TIME;
+    else if (type == "tick")
+        spec.type = BarType::TICK;
+    else if (type == "volume")
+        spec.type = BarType::VOLUME;
+    else
+        return false;
+    // Time bars bucket by whole milliseconds and tick bars count whole ticks: both need an integer
+    // of at least 1 (a fractional period would truncate, possibly to zero)
+    if (spec.type != BarType::VOLUME && (size < 1.0 || size != std::floor(size) || size > 1e15))
+        return false;
+    spec.size = size;
+    return true;
+}
+
+const char *barTypeName(BarType type)
+{
+    switch (type)
+    {
+    case BarType::TIME:
+        return "time";
+    case BarType::TICK:
+        return "tick";
+    case BarType::VOLUME:
+        return "volume";
+    }
+    return "unknown";
+}
+
+MarketTick barToTick(const Bar &bar)
+{
+    MarketTick tick;
+    tick.venue = bar.venue.str();
+    tick.symbol = bar.symbol.str();
+    tick.price = bar.close;
+    tick.size = bar.volume;
+    tick.exchange_recv_ts_ms = bar.exchange_recv_ts_ms;
+    tick.ingest_ts_ms = bar.ingest_ts_ms;
+    tick.ingest_ns = bar.ingest_ns;
+    return tick;
+}
+
+BarAggregator::BarAggregator(const BarSpec &spec) : spec_(spec)
+{
+}
+
+int64_t BarAggregator::bucketStart(int64_t ts_ms) const
+{
+    int64_t period = static_cast<int64_t>(spec_.size);
+    return ts_ms - ts_ms % period;
+}
+
+void BarAggregator::open(Bar &bar, const MarketTick &tick, int64_t ts_ms)
+{
+    bar.venue = tick.venue;
+    bar.symbol = tick.symbol;
+    bar.open = bar.high = bar.low = tick.price;
+    bar.close = tick.price;
+    bar.volume = 0.0;
+    bar.ticks = 0;
+    bar.start_ts_ms = spec_.type == BarType::TIME ? bucketStart(ts_ms) : ts_ms;
+}
+
+bool BarAggregator::onTick(const MarketTick &tick, Bar &closed)
+{
+    int64_t ts_ms = tick.ingest_ts_ms;
+    InstrumentId instrument(tick.venue, tick.symbol);
+    auto it = bars_.find(instrument);
+    if (it == bars_.end())
+        it = bars_.emplace(instrument, Bar{}).first;
+    Bar &bar = it->second;
+
+    bool emitted = false;
+    if (bar.ticks == 0)
+    {
+        open(bar, tick, ts_ms);
+    }
+    else if (spec_.type == BarType::TIME && bucketStart(ts_ms) != bar.start_ts_ms)
+    {
+        // This tick belongs to a later bucket: close the previous one without it
+        bar.end_ts_ms = bar.start_ts_ms + static_cast<int64_t>(spec_.size);
+        closed = bar;
+        ++bars_closed_;
+        emitted = true;
+        open(bar, tick, ts_ms);
+    }
+
+    if (tick.price > bar.high)
+        bar.high = tick.price;
+    if (tick.price < bar.low)
+        bar.low = tick.price;
+    bar.close = tick.price;
+    bar.volume += tick.size;
+    ++bar.ticks;
+    bar.exchange_recv_ts_ms = tick.exchange_recv_ts_ms;
+    bar.ingest_ts_ms = tick.ingest_ts_ms;
+    bar.ingest_ns = tick.ingest_ns;
+
+    bool full = (spec_.type == BarType::TICK && bar.ticks >= static_cast<uint32_t>(spec_.size)) ||
+                (spec_.type == BarType::VOLUME && bar.volume >= spec_.size);
+    if (full)
+    {
+        bar.end_ts_ms = ts_ms;
+        closed = bar;
+        ++bars_closed_;
+        bar.ticks = 0;
+        return true;
+    }
+    return emitted;
+}
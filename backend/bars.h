@@ -0,0 +1,68 @@
+#pragma once
+
+#include "data_source.h"
+#include "fixed_string.h"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+enum class BarType
+{
+    TIME,   // fixed wall-clock buckets of `size` ms, aligned to the epoch
+    TICK,   // every `size` ticks
+    VOLUME  // once accumulated size reaches `size`
+};
+
+struct BarSpec
+{
+    BarType type{BarType::TIME};
+    double size{1000.0};
+};
+
+// Parses "time:MS", "tick:N" or "volume:V"; MS and N must be whole numbers >= 1, V above 0
+bool parseBarSpec(const std::string &text, BarSpec &spec);
+const char *barTypeName(BarType type);
+
+struct Bar
+{
+    VenueId venue;
+    SymbolId symbol;
+    double open{0.0};
+    double high{0.0};
+    double low{0.0};
+    double close{0.0};
+    double volume{0.0};
+    uint32_t ticks{0};
+    int64_t start_ts_ms{0};
+    int64_t end_ts_ms{0};
+    // Stamps of the closing tick, carried through for latency accounting
+    int64_t exchange_recv_ts_ms{-1};
+    int64_t ingest_ts_ms{-1};
+    int64_t ingest_ns{-1};
+};
+
+// A closed bar presented as a tick at its close, with the bar's volume as size
+MarketTick barToTick(const Bar &bar);
+
+// OHLCV aggregation per instrument (venue and symbol); O(1) per tick. Bars close on the tick that completes them:
+// time bars on the first tick of the next bucket (no timer, so quiet periods emit no empty
+// bars), tick and volume bars on the tick that reaches the threshold (volume is not split).
+class BarAggregator
+{
+public:
+    explicit BarAggregator(const BarSpec &spec);
+
+    // Returns true and fills `closed` when this tick completes a bar
+    bool onTick(const MarketTick &tick, Bar &closed);
+
+    const BarSpec &spec() const { return spec_; }
+    uint64_t getBarsClosed() const { return bars_closed_; }
+
+private:
+    void open(Bar &bar, const MarketTick &tick, int64_t ts_ms);
+    int64_t bucketStart(int64_t ts_ms) const;
+
+    BarSpec spec_;
+    std::unordered_map<InstrumentId, Bar> bars_;
+    uint64_t bars_closed_{0};
+};
@@ -0,0 +1,321 @@
+#include "coinbase_parser.h"
+#include <charconv>
+#include <cstring>
+
+// Cursor helpers over [p, end); each returns false on malformed input
+
+static void skip_ws(const char *&p, const char *end)
+{
+    while (p < end && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t'))
+        ++p;
+}
+
+static bool expect(const char *&p, const char *end, char c)
+{
+    skip_ws(p, end);
+    if (p >= end || *p != c)
+        return false;
+    ++p;
+    return true;
+}
+
+// The raw text between the quotes; escapes are skipped over, not decoded (no field we read has any)
+static bool read_string(const char *&p, const char *end, std::string_view &out)
+{
+    if (!expect(p, end, '"'))
+        return false;
+    const char *start = p;
+    for (;;)
+    {
+        auto quote = static_cast<const char *>(std::memchr(p, '"', static_cast<size_t>(end - p)));
+        if (!quote)
+            return false;
+        // Escaped if preceded by an odd run of backslashes
+        const char *b = quote;
+        while (b > start && b[-1] == '\\')
+            --b;
+        p = quote + 1;
+        if ((quote - b) % 2 == 0)
+        {
+            out = std::string_view(start, static_cast<size_t>(quote - start));
+            return true;
+        }
+    }
+}
+
+static bool skip_value(const char *&p, const char *end)
+{
+    skip_ws(p, end);
+    if (p >= end)
+        return false;
+    if (*p == '"')
+    {
+        std::string_view ignored;
+        return read_string(p, end, ignored);
+    }
+    if (*p == '{' || *p == '[')
+    {
+        // Strings may hold brackets, so walk them rather than counting blindly
+        int depth = 0;
+        while (p < end)
+        {
+            char c = *p;
+            if (c == '"')
+            {
+                std::string_view ignored;
+                if (!read_string(p, end, ignored))
+                    return false;
+                continue;
+            }
+            if (c == '{' || c == '[')
+                ++depth;
+            else if (c == '}' || c == ']')
+            {
+                if (--depth == 0)
+                {
+                    ++p;
+                    return true;
+                }
+            }
+            ++p;
+        }
+        return false;
+    }
+    // Number, true, false or null
+    while (p < end && *p != ',' && *p != '}' && *p != ']')
+        ++p;
+    return true;
+}
+
+// Calls on_member(key) for each member of an object; on_member consumes the value
+template <typename F>
+static bool for_each_member(const char *&p, const char *end, F &&on_member)
+{
+    if (!expect(p, end, '{'))
+        return false;
+    skip_ws(p, end);
+    if (p < end && *p == '}')
+    {
+        ++p;
+        return true;
+    }
+    for (;;)
+    {
+        std::string_view key;
+        if (!read_string(p, end, key) || !expect(p, end, ':') || !on_member(key))
+            return false;
+        skip_ws(p, end);
+        if (p < end && *p == ',')
+        {
+            ++p;
+            continue;
+        }
+        return expect(p, end, '}');
+    }
+}
+
+// Calls on_element() for each element of an array; on_element consumes it
+template <typename F>
+static bool for_each_element(const char *&p, const char *end, F &&on_element)
+{
+    if (!expect(p, end, '['))
+        return false;
+    skip_ws(p, end);
+    if (p < end && *p == ']')
+    {
+        ++p;
+        return true;
+    }
+    for (;;)
+    {
+        if (!on_element())
+            return false;
+        skip_ws(p, end);
+        if (p < end && *p == ',')
+        {
+            ++p;
+            continue;
+        }
+        return expect(p, end, ']');
+    }
+}
+
+// A number, bare or quoted (Coinbase quotes prices and sizes)
+template <typename T>
+static bool read_number(const char *&p, const char *end, T &out)
+{
+    skip_ws(p, end);
+    if (p < end && *p == '"')
+    {
+        std::string_view text;
+        if (!read_string(p, end, text))
+            return false;
+        return std::from_chars(text.data(), text.data() + text.size(), out).ec == std::errc();
+    }
+    const char *start = p;
+    if (!skip_value(p, end))
+        return false;
+    return std::from_chars(start, p, out).ec == std::errc();
+}
+
+static bool parse_trade(const char *&p, const char *end, CoinbaseTrade &trade)
+{
+    return for_each_member(p, end, [&](std::string_view key)
+                           {
+        if (key == "price")
+            return read_number(p, end, trade.price);
+        if (key == "size")
+            return read_number(p, end, trade.size);
+        if (key == "product_id")
+            return read_string(p, end, trade.product_id);
+        if (key == "trade_id")
+            return read_string(p, end, trade.trade_id);
+        if (key == "side")
+        {
+            std::string_view side;
+            if (!read_string(p, end, side))
+                return false;
+            trade.buy = side == "BUY";
+            return true;
+        }
+        if (key == "time")
+        {
+            std::string_view text;
+            if (!read_string(p, end, text))
+                return false;
+            if (!parseIso8601Ms(text, trade.time_ms))
+                trade.time_ms = -1;
+            return true;
+        }
+        return skip_value(p, end); });
+}
+
+static bool parse_event(const char *&p, const char *end, CoinbaseMessage &out)
+{
+    return for_each_member(p, end, [&](std::string_view key)
+                           {
+        if (key == "type")
+        {
+            std::string_view type;
+            if (!read_string(p, end, type))
+                return false;
+            out.snapshot = out.snapshot || type == "snapshot";
+            return true;
+        }
+        if (key == "trades")
+        {
+            return for_each_element(p, end, [&]
+                                    {
+                out.trades.emplace_back();
+                return parse_trade(p, end, out.trades.back()); });
+        }
+        return skip_value(p, end); });
+}
+
+bool parseCoinbaseMessage(std::string_view msg, CoinbaseMessage &out)
+{
+    out.channel = {};
+    out.sequence_num = -1;
+    out.timestamp_ms = -1;
+    out.snapshot = false;
+    out.trades.clear();
+    const char *p = msg.data();
+    const char *end = p + msg.size();
+    return for_each_member(p, end, [&](std::string_view key)
+                           {
+        if (key == "channel")
+            return read_string(p, end, out.channel);
+        if (key == "sequence_num")
+            return read_number(p, end, out.sequence_num);
+        if (key == "timestamp")
+        {
+            std::string_view text;
+            if (!read_string(p, end, text))
+                return false;
+            if (!parseIso8601Ms(text, out.timestamp_ms))
+                out.timestamp_ms = -1;
+            return true;
+        }
+        if (key == "events")
+        {
+            return for_each_element(p, end, [&]
+                                    { return parse_event(p, end, out); });
+        }
+        return skip_value(p, end); });
+}
+
+// Fixed-width decimal field; false unless every character is a digit
+static bool digits(const char *p, int n, int &out)
+{
+    int v = 0;
+    for (int i = 0; i < n; ++i)
+    {
+        unsigned d = static_cast<unsigned>(p[i] - '0');
+        if (d > 9)
+            return false;
+        v = v * 10 + static_cast<int>(d);
+    }
+    out = v;
+    return true;
+}
+
+// Days since 1970-01-01 of a proleptic Gregorian date (H. Hinnant's days_from_civil)
+static int64_t days_from_civil(int y, int m, int d)
+{
+    y -= m <= 2;
+    int64_t era = (y >= 0 ? y : y - 399) / 400;
+    int64_t yoe = y - era * 400;
+    int64_t doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+bool parseIso8601Ms(std::string_view text, int64_t &ms)
+{
+    // YYYY-MM-DDTHH:MM:SS is 19 fixed characters
+    const char *s = text.data();
+    size_t n = text.size();
+    int year, month, day, hour, minute, second;
+    if (n < 19 || s[4] != '-' || s[7] != '-' || (s[10] != 'T' && s[10] != ' ') || s[13] != ':' || s[16] != ':' ||
+        !digits(s, 4, year) || !digits(s + 5, 2, month) || !digits(s + 8, 2, day) || !digits(s + 11, 2, hour) ||
+        !digits(s + 14, 2, minute) || !digits(s + 17, 2, second) || month < 1 || month > 12 || day < 1 || day > 31 ||
+        hour > 23 || minute > 59 || second > 60)
+        return false;
+
+    size_t i = 19;
+    int millis = 0;
+    if (i < n && s[i] == '.')
+    {
+        ++i;
+        int places = 0;
+        while (i < n && static_cast<unsigned>(s[i] - '0') <= 9)
+        {
+            if (places < 3)
+                millis = millis * 10 + (s[i] - '0');
+            ++places;
+            ++i;
+        }
+        if (places == 0)
+            return false;
+        for (; places < 3; ++places)
+            millis *= 10;
+    }
+
+    int64_t offset_min = 0;
+    if (i < n && (s[i] == '+' || s[i] == '-'))
+    {
+        int oh, om;
+        if (n - i < 6 || s[i + 3] != ':' || !digits(s + i + 1, 2, oh) || !digits(s + i + 4, 2, om))
+            return false;
+        offset_min = (s[i] == '+' ? 1 : -1) * (oh * 60 + om);
+        i += 6;
+    }
+    else if (i < n && s[i] == 'Z')
+        ++i;
+    if (i != n)
+        return false;
+
+    int64_t secs = days_from_civil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second - offset_min * 60;
+    ms = secs * 1000 + millis;
+    return true;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// One trade of a Coinbase Advanced Trade market_trades event. The views point into the message
+// buffer and are valid only while it is.
+struct CoinbaseTrade
+{
+    std::string_view product_id;
+    std::string_view trade_id;
+    double price{0.0};
+    double size{0.0};
+    int64_t time_ms{-1}; // exchange trade time, epoch ms (-1 if absent or malformed)
+    bool buy{false};
+};
+
+// Top-level fields of one Coinbase WebSocket message, plus its trades when it is a
+// market_trades message
+struct CoinbaseMessage
+{
+    std::string_view channel; // "market_trades", "subscriptions", "heartbeats", ...
+    int64_t sequence_num{-1};
+    int64_t timestamp_ms{-1};
+    bool snapshot{false}; // any event of type "snapshot" (the backlog sent on subscribe)
+    std::vector<CoinbaseTrade> trades;
+};
+
+// Parses a message in place: a single pass over the bytes with no copies and no allocation once
+// `out.trades` has grown to the largest batch seen (reuse one CoinbaseMessage). Numbers are read
+// with std::from_chars. Every trade of every event is kept, in message order. False if the text
+// is not a JSON object; fields it does not know are skipped.
+bool parseCoinbaseMessage(std::string_view msg, CoinbaseMessage &out);
+
+// "2019-08-14T20:42:27.265Z" (any number of fraction digits, Z or +HH:MM / -HH:MM) to epoch ms;
+// false if malformed
+bool parseIso8601Ms(std::string_view text, int64_t &ms);
@@ -19,6 +19,8 @@ Config parseArgs(int argc, char **argv)
                 cfg.source = SourceType::LIVE;
             else if (std::strcmp(v, "replay") == 0)
                 cfg.source = SourceType::REPLAY;
+            else if (std::strcmp(v, "load") == 0)
+                cfg.source = SourceType::LOAD;
         }
         else if (starts_with(a, "--exchange="))
         {
@@ -32,6 +34,33 @@ Config parseArgs(int argc, char **argv)
         {
             cfg.symbol = std::string(a + 9);
         }
+        else if (starts_with(a, "--products="))
+        {
+            std::string s = std::string(a + 11);
+            size_t pos = 0;
+            while (pos < s.size())
+            {
+                size_t comma = s.find(',', pos);
+                std::string product = s.substr(pos, comma == std::string::npos ? std::string::npos : comma - pos);
+                if (!product.empty())
+                    cfg.products.push_back(product);
+                if (comma == std::string::npos)
+                    break;
+                pos = comma + 1;
+            }
+        }
+        else if (starts_with(a, "--feed_connections="))
+        {
+            cfg.feed_connections = std::atoi(a + 19);
+        }
+        else if (starts_with(a, "--feed_url="))
+        {
+            cfg.feed_url = std::string(a + 11);
+        }
+        else if (starts_with(a, "--feed_ca="))
+        {
+            cfg.feed_ca = std::string(a + 10);
+        }
         else if (starts_with(a, "--replay_file="))
         {
             cfg.replay_file = std::string(a + 14);
@@ -40,6 +69,38 @@ Config parseArgs(int argc, char **argv)
         {
             cfg.replay_speed = std::atof(a + 15);
         }
+        else if (starts_with(a, "--replay_threads="))
+        {
+            cfg.replay_threads = std::atoi(a + 17);
+        }
+        else if (starts_with(a, "--replay_from="))
+        {
+            cfg.replay_from = std::string(a + 14);
+        }
+        else if (starts_with(a, "--load_symbols="))
+        {
+            cfg.load_symbols = std::atoi(a + 15);
+        }
+        else if (starts_with(a, "--load_venues="))
+        {
+            cfg.load_venues = std::atoi(a + 14);
+        }
+        else if (starts_with(a, "--load_rate="))
+        {
+            cfg.load_rate = std::atof(a + 12);
+        }
+        else if (starts_with(a, "--load_ticks="))
+        {
+            cfg.load_ticks = std::atoll(a + 13);
+        }
+        else if (starts_with(a, "--load_model="))
+        {
+            cfg.load_model = std::string(a + 13);
+        }
+        else if (starts_with(a, "--load_seed="))
+        {
+            cfg.load_seed = std::strtoull(a + 12, nullptr, 10);
+        }
         else if (starts_with(a, "--latency_mode="))
         {
             const char *v = a + 15;
@@ -75,6 +136,21 @@ Config parseArgs(int argc, char **argv)
         {
             cfg.strategy = std::string(a + 11);
         }
+        else if (starts_with(a, "--strategies="))
+        {
+            std::string s = std::string(a + 13);
+            size_t pos = 0;
+            while (pos < s.size())
+            {
+                size_t comma = s.find(',', pos);
+                std::string name = s.substr(pos, comma == std::string::npos ? std::string::npos : comma - pos);
+                if (!name.empty())
+                    cfg.strategy_group.push_back(name);
+                if (comma == std::string::npos)
+                    break;
+                pos = comma + 1;
+            }
+        }
         else if (starts_with(a, "--lookback="))
         {
             cfg.strategy_lookback = std::atoi(a + 11);
@@ -83,6 +159,109 @@ Config parseArgs(int argc, char **argv)
         {
             cfg.strategy_order_qty = std::atoi(a + 12);
         }
+        else if (starts_with(a, "--risk_max_position="))
+        {
+            cfg.risk_max_position = std::atoi(a + 20);
+        }
+        else if (starts_with(a, "--risk_max_notional="))
+        {
+            cfg.risk_max_notional = std::atof(a + 20);
+        }
+        else if (starts_with(a, "--risk_max_orders_per_sec="))
+        {
+            cfg.risk_max_orders_per_sec = std::atof(a + 26);
+        }
+        else if (starts_with(a, "--risk_price_band_pct="))
+        {
+            cfg.risk_price_band_pct = std::atof(a + 22);
+        }
+        else if (starts_with(a, "--snapshot_file="))
+        {
+            cfg.snapshot_file = std::string(a + 16);
+        }
+        else if (starts_with(a, "--snapshot_interval_ms="))
+        {
+            cfg.snapshot_interval_ms = std::atoi(a + 23);
+        }
+        else if (starts_with(a, "--journal_file="))
+        {
+            cfg.journal_file = std::string(a + 15);
+        }
+        else if (starts_with(a, "--journal_sync_ms="))
+        {
+            cfg.journal_sync_ms = std::atoi(a + 18);
+        }
+        else if (starts_with(a, "--shards="))
+        {
+            cfg.shards = std::atoi(a + 9);
+        }
+        else if (starts_with(a, "--shard_first_core="))
+        {
+            cfg.shard_first_core = std::atoi(a + 19);
+        }
+        else if (std::strcmp(a, "--restore_snapshot") == 0)
+        {
+            cfg.restore_snapshot = true;
+        }
+        else if (starts_with(a, "--warmup_file="))
+        {
+            cfg.warmup_file = std::string(a + 14);
+        }
+        else if (starts_with(a, "--warmup_ticks="))
+        {
+            cfg.warmup_ticks = std::atoi(a + 15);
+        }
+        else if (std::strcmp(a, "--static_pipeline") == 0)
+        {
+            cfg.static_pipeline = true;
+        }
+        else if (starts_with(a, "--bars="))
+        {
+            cfg.bars = std::string(a + 7);
+        }
+        else if (std::strcmp(a, "--no_trace") == 0)
+        {
+            cfg.trace = false;
+        }
+        else if (starts_with(a, "--log_level="))
+        {
+            cfg.log_level = std::string(a + 12);
+        }
+        else if (starts_with(a, "--log_rate="))
+        {
+            cfg.log_rate = std::atoi(a + 11);
+        }
+        else if (starts_with(a, "--log_file="))
+        {
+            cfg.log_file = std::string(a + 11);
+        }
+        else if (starts_with(a, "--record_file="))
+        {
+            cfg.record_file = std::string(a + 14);
+        }
+        else if (starts_with(a, "--record_format="))
+        {
+            cfg.record_format = std::string(a + 16);
+        }
+        else if (starts_with(a, "--record_rotate_mb="))
+        {
+            cfg.record_rotate_mb = std::atoi(a + 19);
+        }
     }
     return cfg;
 }
+
+const char *sourceTypeName(SourceType source)
+{
+    switch (source)
+    {
+    case SourceType::SYNTHETIC:
+        return "synthetic";
+    case SourceType::LIVE:
+        return "live";
+    case SourceType::REPLAY:
+        return "replay";
+    default:
+        return "load";
+    }
+}
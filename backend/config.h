@@ -2,12 +2,15 @@
 
 #include <string>
 #include <map>
+#include <vector>
+#include <cstdint>
 
 enum class SourceType
 {
     SYNTHETIC,
     LIVE,
-    REPLAY
+    REPLAY,
+    LOAD
 };
 enum class ExchangeType
 {
@@ -26,13 +29,65 @@ struct Config
     SourceType source{SourceType::SYNTHETIC};
     ExchangeType exchange{ExchangeType::COINBASE};
     std::string symbol{"BTC-USD"};
+    // --source=live: products to subscribe (empty = symbol), spread over feed_connections
+    // connections to feed_url; feed_ca verifies the server (empty = no verification)
+    std::vector<std::string> products;
+    int feed_connections{1};
+    std::string feed_url{"wss://advanced-trade-ws.coinbase.com"};
+    std::string feed_ca;
     std::string replay_file{"./ticks.ndjson"};
     double replay_speed{1.0};
+    int replay_threads{1}; // NDJSON decode workers (0 = one per core)
+    std::string replay_from; // start time: epoch ms or HH:MM[:SS] UTC on the recording's first day
+    // --source=load: deterministic high-rate generator (see LoadGeneratorConfig)
+    int load_symbols{8};
+    int load_venues{4};
+    double load_rate{100000.0}; // ticks/sec, 0 = unpaced
+    int64_t load_ticks{0};      // 0 = until stopped
+    std::string load_model{"gbm"};
+    uint64_t load_seed{42};
     LatencyMode latency_mode{LatencyMode::BOTH};
     std::map<std::string, double> modelled_latency_ms{{"SYNTH", 20.0}, {"COINBASE", 30.0}, {"LSE", 70.0}};
     std::string strategy{"momentum"}; // momentum|mean_reversion|breakout|vwap_reversion
     int strategy_lookback{3};
     int strategy_order_qty{100};
+    // Pre-trade risk limits (0 disables a check)
+    int risk_max_position{10000};
+    double risk_max_notional{0.0};
+    double risk_max_orders_per_sec{50.0};
+    double risk_price_band_pct{5.0};
+    // OrderBook snapshots (disabled when snapshot_file is empty)
+    std::string snapshot_file;
+    int snapshot_interval_ms{1000};
+    bool restore_snapshot{false};
+    // Write-ahead journal of orders and fills (disabled when journal_file is empty)
+    std::string journal_file;
+    int journal_sync_ms{5};
+    // Symbol-sharded execution (0 = single book/strategy on the feed thread)
+    int shards{0};
+    int shard_first_core{0};
+    // Strategy group mode: run these strategies side by side on one feed (overrides --shards)
+    std::vector<std::string> strategy_group;
+    // Warm strategies from the tail of a tick recording before going live (disabled when empty)
+    std::string warmup_file;
+    int warmup_ticks{500}; // per venue/symbol
+    // Compile-time composed strategy->risk->book pipeline instead of the virtual/std::function path
+    bool static_pipeline{false};
+    // Drive the strategy with closed OHLCV bars ("time:MS", "tick:N", "volume:V"; empty = every tick)
+    std::string bars;
+    // Hot-path trace rings behind /trace (on by default; --no_trace turns recording off)
+    bool trace{true};
+    // Async trade/order log: level (debug|info|warn|error|off), lines per second (0 = unlimited),
+    // file (empty = stdout). Latency events are logged at debug.
+    std::string log_level{"info"};
+    int log_rate{1000};
+    std::string log_file;
+    // Record the live tick stream for replay (disabled when record_file is empty); files rotate
+    // at record_rotate_mb (0 = never)
+    std::string record_file;
+    std::string record_format{"ndjson"}; // ndjson|binary|archive
+    int record_rotate_mb{256};
 };
 
 Config parseArgs(int argc, char **argv);
+const char *sourceTypeName(SourceType source);
@@ -1,9 +1,16 @@
 #pragma once
 
 #include <string>
+#include <chrono>
 #include <cstdint>
 #include <functional>
 
+// Monotonic nanosecond stamp for in-process stage latencies; not comparable across processes
+inline int64_t steadyNowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
 struct MarketTick
 {
     std::string venue;
@@ -12,6 +19,7 @@ struct MarketTick
     double size;
     int64_t exchange_recv_ts_ms;
     int64_t ingest_ts_ms;
+    int64_t ingest_ns{-1}; // steadyNowNs() when the source emitted the tick
 };
 
 class IDataSource
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <ostream>
+#include <string>
+
+// Inline, NUL-padded string of at most N-1 characters. Copying, comparing and hashing never
+// touch the heap, so it can sit in orders and trades on the hot path. Longer input is truncated.
+template <size_t N>
+struct FixedString
+{
+    char data[N];
+
+    FixedString() { std::memset(data, 0, N); }
+    FixedString(const char *s) { assign(s, std::strlen(s)); }
+    FixedString(const std::string &s) { assign(s.data(), s.size()); }
+
+    void assign(const char *s, size_t len)
+    {
+        size_t n = len < N - 1 ? len : N - 1;
+        std::memcpy(data, s, n);
+        std::memset(data + n, 0, N - n);
+    }
+
+    const char *c_str() const { return data; }
+    size_t size() const { return ::strnlen(data, N); }
+    bool empty() const { return data[0] == '\0'; }
+    std::string str() const { return std::string(data, size()); }
+
+    friend bool operator==(const FixedString &a, const FixedString &b) { return std::memcmp(a.data, b.data, N) == 0; }
+    friend bool operator!=(const FixedString &a, const FixedString &b) { return !(a == b); }
+    // Padding is all NUL, so bytewise order matches string order
+    friend bool operator<(const FixedString &a, const FixedString &b) { return std::memcmp(a.data, b.data, N) < 0; }
+    friend std::ostream &operator<<(std::ostream &os, const FixedString &s) { return os << s.data; }
+};
+
+// Field widths match the journal record
+using VenueId = FixedString<16>;
+using SymbolId = FixedString<24>;
+
+// One tradable series: a symbol on a venue. Positions, marks, risk state, strategy history,
+// indicators and bars are all kept per instrument, never per venue alone.
+struct InstrumentId
+{
+    VenueId venue;
+    SymbolId symbol;
+
+    InstrumentId() = default;
+    InstrumentId(const VenueId &v, const SymbolId &s) : venue(v), symbol(s) {}
+
+    std::string str() const { return venue.str() + ":" + symbol.str(); }
+
+    friend bool operator==(const InstrumentId &a, const InstrumentId &b) { return a.venue == b.venue && a.symbol == b.symbol; }
+    friend bool operator!=(const InstrumentId &a, const InstrumentId &b) { return !(a == b); }
+    friend bool operator<(const InstrumentId &a, const InstrumentId &b)
+    {
+        return a.venue < b.venue || (a.venue == b.venue && a.symbol < b.symbol);
+    }
+    friend std::ostream &operator<<(std::ostream &os, const InstrumentId &id) { return os << id.venue << ":" << id.symbol; }
+};
+
+namespace std
+{
+    template <size_t N>
+    struct hash<FixedString<N>>
+    {
+        size_t operator()(const FixedString<N> &s) const
+        {
+            // FNV-1a over the used bytes
+            size_t h = 14695981039346656037ull;
+            for (size_t i = 0; i < N && s.data[i]; ++i)
+                h = (h ^ static_cast<unsigned char>(s.data[i])) * 1099511628211ull;
+            return h;
+        }
+    };
+
+    template <>
+    struct hash<InstrumentId>
+    {
+        size_t operator()(const InstrumentId &id) const
+        {
+            return hash<VenueId>()(id.venue) * 31 ^ hash<SymbolId>()(id.symbol);
+        }
+    };
+}
@@ -0,0 +1,489 @@
+#include "indicator_kernels.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define TRADEPULSE_X86 1
+#endif
+
+// Inner loops shared by every kernel; one table per instruction set
+struct KernelOps
+{
+    // out[i] = carry + d[0] + ... + d[i]; returns the last running value
+    double (*scan_add)(const double *d, size_t n, double carry, double *out);
+    // out[i] = a * x[i] + b * out[i - 1], with out[-1] = prev; returns the last value
+    double (*scan_linear)(const double *x, size_t n, double a, double b, double prev, double *out);
+    // Change of a shifted window sum (d) and sum of squares (d2, optional) when x[i] enters and
+    // old[i] leaves; old may be null while the window is still filling
+    void (*window_diffs)(const double *x, const double *old, size_t n, double shift, double *d, double *d2);
+    // Sums to mean = shift + sum / period and population stddev, in place; stddev may be null
+    void (*mean_std)(double *mean, double *stddev, size_t n, double inv_period, double shift);
+    // Element-wise min(a_lo, b_lo) and max(a_hi, b_hi)
+    void (*min_max)(const double *a_lo, const double *b_lo, const double *a_hi, const double *b_hi, size_t n,
+                    double *lo, double *hi);
+};
+
+static double scanAddScalar(const double *d, size_t n, double carry, double *out)
+{
+    for (size_t i = 0; i < n; ++i)
+        out[i] = carry += d[i];
+    return carry;
+}
+
+static double scanLinearScalar(const double *x, size_t n, double a, double b, double prev, double *out)
+{
+    for (size_t i = 0; i < n; ++i)
+        out[i] = prev = x[i] * a + prev * b;
+    return prev;
+}
+
+static void windowDiffsScalar(const double *x, const double *old, size_t n, double shift, double *d, double *d2)
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        double in = x[i] - shift;
+        double out = old ? old[i] - shift : 0.0;
+        d[i] = in - out;
+        if (d2)
+            d2[i] = in * in - out * out;
+    }
+}
+
+static void meanStdScalar(double *mean, double *stddev, size_t n, double inv_period, double shift)
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        double m = mean[i] * inv_period;
+        mean[i] = shift + m;
+        if (stddev)
+        {
+            double var = stddev[i] * inv_period - m * m;
+            stddev[i] = var > 0.0 ? std::sqrt(var) : 0.0;
+        }
+    }
+}
+
+static void minMaxScalar(const double *a_lo, const double *b_lo, const double *a_hi, const double *b_hi, size_t n,
+                         double *lo, double *hi)
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        lo[i] = std::min(a_lo[i], b_lo[i]);
+        hi[i] = std::max(a_hi[i], b_hi[i]);
+    }
+}
+
+static const KernelOps scalar_ops{scanAddScalar, scanLinearScalar, windowDiffsScalar, meanStdScalar, minMaxScalar};
+
+#ifdef TRADEPULSE_X86
+
+// SSE2 is part of x86-64, so these need no target attribute
+
+static double scanAddSse2(const double *d, size_t n, double carry, double *out)
+{
+    __m128d c = _mm_set1_pd(carry);
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2)
+    {
+        __m128d v = _mm_loadu_pd(d + i);
+        v = _mm_add_pd(v, _mm_unpacklo_pd(_mm_setzero_pd(), v)); // [a, a+b]
+        v = _mm_add_pd(v, c);
+        _mm_storeu_pd(out + i, v);
+        c = _mm_unpackhi_pd(v, v);
+    }
+    return scanAddScalar(d + i, n - i, _mm_cvtsd_f64(c), out + i);
+}
+
+static double scanLinearSse2(const double *x, size_t n, double a, double b, double prev, double *out)
+{
+    const __m128d va = _mm_set1_pd(a);
+    const __m128d vb = _mm_set1_pd(b);
+    const __m128d decay = _mm_set_pd(b * b, b); // weight of the carried value per lane
+    __m128d p = _mm_set1_pd(prev);
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2)
+    {
+        __m128d u = _mm_mul_pd(_mm_loadu_pd(x + i), va);
+        u = _mm_add_pd(u, _mm_mul_pd(vb, _mm_unpacklo_pd(_mm_setzero_pd(), u)));
+        u = _mm_add_pd(u, _mm_mul_pd(decay, p));
+        _mm_storeu_pd(out + i, u);
+        p = _mm_unpackhi_pd(u, u);
+    }
+    return scanLinearScalar(x + i, n - i, a, b, _mm_cvtsd_f64(p), out + i);
+}
+
+static void windowDiffsSse2(const double *x, const double *old, size_t n, double shift, double *d, double *d2)
+{
+    const __m128d s = _mm_set1_pd(shift);
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2)
+    {
+        __m128d in = _mm_sub_pd(_mm_loadu_pd(x + i), s);
+        __m128d out = old ? _mm_sub_pd(_mm_loadu_pd(old + i), s) : _mm_setzero_pd();
+        _mm_storeu_pd(d + i, _mm_sub_pd(in, out));
+        if (d2)
+            _mm_storeu_pd(d2 + i, _mm_sub_pd(_mm_mul_pd(in, in), _mm_mul_pd(out, out)));
+    }
+    windowDiffsScalar(x + i, old ? old + i : nullptr, n - i, shift, d + i, d2 ? d2 + i : nullptr);
+}
+
+static void meanStdSse2(double *mean, double *stddev, size_t n, double inv_period, double shift)
+{
+    const __m128d inv = _mm_set1_pd(inv_period);
+    const __m128d s = _mm_set1_pd(shift);
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2)
+    {
+        __m128d m = _mm_mul_pd(_mm_loadu_pd(mean + i), inv);
+        _mm_storeu_pd(mean + i, _mm_add_pd(s, m));
+        if (stddev)
+        {
+            __m128d var = _mm_sub_pd(_mm_mul_pd(_mm_loadu_pd(stddev + i), inv), _mm_mul_pd(m, m));
+            _mm_storeu_pd(stddev + i, _mm_sqrt_pd(_mm_max_pd(var, _mm_setzero_pd())));
+        }
+    }
+    meanStdScalar(mean + i, stddev ? stddev + i : nullptr, n - i, inv_period, shift);
+}
+
+static void minMaxSse2(const double *a_lo, const double *b_lo, const double *a_hi, const double *b_hi, size_t n,
+                       double *lo, double *hi)
+{
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2)
+    {
+        _mm_storeu_pd(lo + i, _mm_min_pd(_mm_loadu_pd(a_lo + i), _mm_loadu_pd(b_lo + i)));
+        _mm_storeu_pd(hi + i, _mm_max_pd(_mm_loadu_pd(a_hi + i), _mm_loadu_pd(b_hi + i)));
+    }
+    minMaxScalar(a_lo + i, b_lo + i, a_hi + i, b_hi + i, n - i, lo + i, hi + i);
+}
+
+static const KernelOps sse2_ops{scanAddSse2, scanLinearSse2, windowDiffsSse2, meanStdSse2, minMaxSse2};
+
+// AVX2 bodies are compiled for AVX2 only here and reached only after the CPU check
+
+#define TRADEPULSE_AVX2 __attribute__((target("avx2")))
+
+// [a, b, c, d] -> [0, a, b, c]
+TRADEPULSE_AVX2 static inline __m256d shiftOne(__m256d v)
+{
+    return _mm256_blend_pd(_mm256_permute4x64_pd(v, _MM_SHUFFLE(2, 1, 0, 0)), _mm256_setzero_pd(), 0x1);
+}
+
+// [a, b, c, d] -> [0, 0, a, b]
+TRADEPULSE_AVX2 static inline __m256d shiftTwo(__m256d v)
+{
+    return _mm256_permute2f128_pd(v, v, 0x08);
+}
+
+TRADEPULSE_AVX2 static double scanAddAvx2(const double *d, size_t n, double carry, double *out)
+{
+    __m256d c = _mm256_set1_pd(carry);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m256d v = _mm256_loadu_pd(d + i);
+        v = _mm256_add_pd(v, shiftOne(v));
+        v = _mm256_add_pd(v, shiftTwo(v));
+        v = _mm256_add_pd(v, c);
+        _mm256_storeu_pd(out + i, v);
+        c = _mm256_permute4x64_pd(v, _MM_SHUFFLE(3, 3, 3, 3));
+    }
+    return scanAddScalar(d + i, n - i, _mm256_cvtsd_f64(c), out + i);
+}
+
+TRADEPULSE_AVX2 static double scanLinearAvx2(const double *x, size_t n, double a, double b, double prev, double *out)
+{
+    const __m256d va = _mm256_set1_pd(a);
+    const __m256d vb = _mm256_set1_pd(b);
+    const __m256d vb2 = _mm256_set1_pd(b * b);
+    const __m256d decay = _mm256_set_pd(b * b * b * b, b * b * b, b * b, b);
+    __m256d p = _mm256_set1_pd(prev);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m256d u = _mm256_mul_pd(_mm256_loadu_pd(x + i), va);
+        u = _mm256_add_pd(u, _mm256_mul_pd(vb, shiftOne(u)));
+        u = _mm256_add_pd(u, _mm256_mul_pd(vb2, shiftTwo(u)));
+        u = _mm256_add_pd(u, _mm256_mul_pd(decay, p));
+        _mm256_storeu_pd(out + i, u);
+        p = _mm256_permute4x64_pd(u, _MM_SHUFFLE(3, 3, 3, 3));
+    }
+    return scanLinearScalar(x + i, n - i, a, b, _mm256_cvtsd_f64(p), out + i);
+}
+
+TRADEPULSE_AVX2 static void windowDiffsAvx2(const double *x, const double *old, size_t n, double shift, double *d, double *d2)
+{
+    const __m256d s = _mm256_set1_pd(shift);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m256d in = _mm256_sub_pd(_mm256_loadu_pd(x + i), s);
+        __m256d out = old ? _mm256_sub_pd(_mm256_loadu_pd(old + i), s) : _mm256_setzero_pd();
+        _mm256_storeu_pd(d + i, _mm256_sub_pd(in, out));
+        if (d2)
+            _mm256_storeu_pd(d2 + i, _mm256_sub_pd(_mm256_mul_pd(in, in), _mm256_mul_pd(out, out)));
+    }
+    windowDiffsScalar(x + i, old ? old + i : nullptr, n - i, shift, d + i, d2 ? d2 + i : nullptr);
+}
+
+TRADEPULSE_AVX2 static void meanStdAvx2(double *mean, double *stddev, size_t n, double inv_period, double shift)
+{
+    const __m256d inv = _mm256_set1_pd(inv_period);
+    const __m256d s = _mm256_set1_pd(shift);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m256d m = _mm256_mul_pd(_mm256_loadu_pd(mean + i), inv);
+        _mm256_storeu_pd(mean + i, _mm256_add_pd(s, m));
+        if (stddev)
+        {
+            __m256d var = _mm256_sub_pd(_mm256_mul_pd(_mm256_loadu_pd(stddev + i), inv), _mm256_mul_pd(m, m));
+            _mm256_storeu_pd(stddev + i, _mm256_sqrt_pd(_mm256_max_pd(var, _mm256_setzero_pd())));
+        }
+    }
+    meanStdScalar(mean + i, stddev ? stddev + i : nullptr, n - i, inv_period, shift);
+}
+
+TRADEPULSE_AVX2 static void minMaxAvx2(const double *a_lo, const double *b_lo, const double *a_hi, const double *b_hi,
+                                       size_t n, double *lo, double *hi)
+{
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        _mm256_storeu_pd(lo + i, _mm256_min_pd(_mm256_loadu_pd(a_lo + i), _mm256_loadu_pd(b_lo + i)));
+        _mm256_storeu_pd(hi + i, _mm256_max_pd(_mm256_loadu_pd(a_hi + i), _mm256_loadu_pd(b_hi + i)));
+    }
+    minMaxScalar(a_lo + i, b_lo + i, a_hi + i, b_hi + i, n - i, lo + i, hi + i);
+}
+
+static const KernelOps avx2_ops{scanAddAvx2, scanLinearAvx2, windowDiffsAvx2, meanStdAvx2, minMaxAvx2};
+
+#endif
+
+static const KernelOps &opsFor(SimdLevel level)
+{
+#ifdef TRADEPULSE_X86
+    if (level == SimdLevel::AVX2)
+        return avx2_ops;
+    if (level == SimdLevel::SSE2)
+        return sse2_ops;
+#endif
+    (void)level;
+    return scalar_ops;
+}
+
+SimdLevel detectSimdLevel()
+{
+#ifdef TRADEPULSE_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return SimdLevel::AVX2;
+    if (__builtin_cpu_supports("sse2"))
+        return SimdLevel::SSE2;
+#endif
+    return SimdLevel::SCALAR;
+}
+
+static std::atomic<int> active_level{-1};
+
+SimdLevel activeSimdLevel()
+{
+    int level = active_level.load(std::memory_order_relaxed);
+    if (level < 0)
+    {
+        level = static_cast<int>(detectSimdLevel());
+        active_level.store(level, std::memory_order_relaxed);
+    }
+    return static_cast<SimdLevel>(level);
+}
+
+SimdLevel setSimdLevel(SimdLevel level)
+{
+    SimdLevel effective = std::min(level, detectSimdLevel());
+    active_level.store(static_cast<int>(effective), std::memory_order_relaxed);
+    return effective;
+}
+
+const char *simdLevelName(SimdLevel level)
+{
+    switch (level)
+    {
+    case SimdLevel::SCALAR:
+        return "scalar";
+    case SimdLevel::SSE2:
+        return "sse2";
+    case SimdLevel::AVX2:
+        return "avx2";
+    }
+    return "unknown";
+}
+
+static constexpr double NaN = std::numeric_limits<double>::quiet_NaN();
+// The running sums are recomputed exactly at every block start, so add/subtract rounding
+// never spans more than one block (the per-tick registry does the same once per lap)
+static constexpr size_t BLOCK = 1024;
+
+// Window sums of (x - shift) and optionally their squares for every i, partial while filling
+static void windowSums(const KernelOps &ops, const double *x, size_t n, size_t period, double shift, double *sum,
+                       double *sum_sq)
+{
+    size_t block = std::max(BLOCK, period);
+    std::vector<double> d(block);
+    std::vector<double> d2(sum_sq ? block : 0);
+    double s = 0.0;
+    double s2 = 0.0;
+    for (size_t b = 0; b < n; b += block)
+    {
+        size_t len = std::min(block, n - b);
+        if (b >= period)
+        {
+            s = 0.0;
+            s2 = 0.0;
+            for (size_t j = b - period; j < b; ++j)
+            {
+                double v = x[j] - shift;
+                s += v;
+                s2 += v * v;
+            }
+        }
+        // block >= period, so only the first block has inputs with nothing leaving the window
+        size_t filling = b < period ? std::min(len, period - b) : 0;
+        double *d2p = sum_sq ? d2.data() : nullptr;
+        if (filling > 0)
+            ops.window_diffs(x + b, nullptr, filling, shift, d.data(), d2p);
+        if (len > filling)
+            ops.window_diffs(x + b + filling, x + b + filling - period, len - filling, shift, d.data() + filling,
+                             d2p ? d2p + filling : nullptr);
+        s = ops.scan_add(d.data(), len, s, sum + b);
+        if (sum_sq)
+            s2 = ops.scan_add(d2p, len, s2, sum_sq + b);
+    }
+}
+
+// Column scratch reused across calls on one thread: first-touch page faults on fresh
+// multi-megabyte buffers would otherwise cost more than the kernels themselves
+enum ScratchSlot
+{
+    SCRATCH_A,
+    SCRATCH_B,
+    SCRATCH_C,
+    SCRATCH_D,
+    SCRATCH_E,
+    SCRATCH_F,
+    SCRATCH_SLOTS
+};
+
+static double *scratch(ScratchSlot slot, size_t n)
+{
+    static thread_local std::vector<double> buffers[SCRATCH_SLOTS];
+    if (buffers[slot].size() < n)
+        buffers[slot].resize(n);
+    return buffers[slot].data();
+}
+
+static void fillNaN(double *out, size_t count)
+{
+    if (out)
+        std::fill(out, out + count, NaN);
+}
+
+void rollingSum(const double *x, size_t n, int period, double *sum)
+{
+    size_t p = static_cast<size_t>(std::max(1, period));
+    windowSums(opsFor(activeSimdLevel()), x, n, p, 0.0, sum, nullptr);
+    fillNaN(sum, std::min(n, p - 1));
+}
+
+void rollingMeanStd(const double *x, size_t n, int period, double *mean, double *stddev)
+{
+    if (n == 0)
+        return;
+    const KernelOps &ops = opsFor(activeSimdLevel());
+    size_t p = static_cast<size_t>(std::max(1, period));
+    // Sums are taken relative to the first price to keep the variance precise
+    double shift = x[0];
+    windowSums(ops, x, n, p, shift, mean, stddev);
+    ops.mean_std(mean, stddev, n, 1.0 / static_cast<double>(p), shift);
+    fillNaN(mean, std::min(n, p - 1));
+    fillNaN(stddev, std::min(n, p - 1));
+}
+
+void emaSeries(const double *x, size_t n, int period, double *ema)
+{
+    if (n == 0)
+        return;
+    size_t p = static_cast<size_t>(std::max(1, period));
+    double k = 2.0 / (static_cast<double>(p) + 1.0);
+    ema[0] = x[0];
+    opsFor(activeSimdLevel()).scan_linear(x + 1, n - 1, k, 1.0 - k, x[0], ema + 1);
+    fillNaN(ema, std::min(n, p - 1));
+}
+
+void rsiSeries(const double *x, size_t n, int period, double *rsi)
+{
+    size_t p = static_cast<size_t>(std::max(1, period));
+    fillNaN(rsi, std::min(n, p));
+    if (n <= p)
+        return;
+    // Column j holds the change into price j + 1; losing changes are counted separately so an
+    // all-gain window is detected exactly rather than through a rounded loss sum
+    size_t m = n - 1;
+    double *gains = scratch(SCRATCH_A, m);
+    double *losses = scratch(SCRATCH_B, m);
+    double *downs = scratch(SCRATCH_C, m);
+    for (size_t j = 0; j < m; ++j)
+    {
+        double diff = x[j + 1] - x[j];
+        gains[j] = diff > 0 ? diff : 0.0;
+        losses[j] = diff < 0 ? -diff : 0.0;
+        downs[j] = diff < 0 ? 1.0 : 0.0;
+    }
+    const KernelOps &ops = opsFor(activeSimdLevel());
+    double *gain_sum = scratch(SCRATCH_D, m);
+    double *loss_sum = scratch(SCRATCH_E, m);
+    double *down_count = scratch(SCRATCH_F, m);
+    windowSums(ops, gains, m, p, 0.0, gain_sum, nullptr);
+    windowSums(ops, losses, m, p, 0.0, loss_sum, nullptr);
+    windowSums(ops, downs, m, p, 0.0, down_count, nullptr);
+    for (size_t j = p - 1; j < m; ++j)
+    {
+        double rs = down_count[j] == 0.0 ? 0.0 : gain_sum[j] / loss_sum[j];
+        rsi[j + 1] = 100.0 - 100.0 / (1.0 + rs);
+    }
+}
+
+void rollingMinMax(const double *x, size_t n, int period, double *min, double *max)
+{
+    size_t p = static_cast<size_t>(std::max(1, period));
+    fillNaN(min, std::min(n, p - 1));
+    fillNaN(max, std::min(n, p - 1));
+    if (n < p)
+        return;
+    // Extrema from each block start up to i (prefix) and from i to the block end (suffix);
+    // the window ending at i spans at most two blocks, so it is max(suffix[i-p+1], prefix[i])
+    double *pre_lo = scratch(SCRATCH_A, n);
+    double *pre_hi = scratch(SCRATCH_B, n);
+    double *suf_lo = scratch(SCRATCH_C, n);
+    double *suf_hi = scratch(SCRATCH_D, n);
+    for (size_t b = 0; b < n; b += p)
+    {
+        size_t end = std::min(n, b + p);
+        pre_lo[b] = pre_hi[b] = x[b];
+        for (size_t i = b + 1; i < end; ++i)
+        {
+            pre_lo[i] = std::min(pre_lo[i - 1], x[i]);
+            pre_hi[i] = std::max(pre_hi[i - 1], x[i]);
+        }
+        suf_lo[end - 1] = suf_hi[end - 1] = x[end - 1];
+        for (size_t i = end - 1; i-- > b;)
+        {
+            suf_lo[i] = std::min(suf_lo[i + 1], x[i]);
+            suf_hi[i] = std::max(suf_hi[i + 1], x[i]);
+        }
+    }
+    opsFor(activeSimdLevel()).min_max(suf_lo, pre_lo + p - 1, suf_hi, pre_hi + p - 1, n - p + 1, min + p - 1, max + p - 1);
+}
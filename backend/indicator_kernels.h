@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+
+// Whole-array indicator kernels for backtests, where a venue's full price column is known up
+// front. Output i describes the window ending at input i; entries before the first full window
+// are NaN, so signal rules written as plain comparisons come out false there.
+//
+// The inner loops exist in scalar, SSE2 and AVX2 form. The widest form the CPU supports is
+// picked on first use; setSimdLevel() overrides it (benchmarks, debugging).
+
+enum class SimdLevel
+{
+    SCALAR,
+    SSE2,
+    AVX2
+};
+
+SimdLevel detectSimdLevel();
+SimdLevel activeSimdLevel();
+// Returns the level actually in effect, clamped to what the CPU supports
+SimdLevel setSimdLevel(SimdLevel level);
+const char *simdLevelName(SimdLevel level);
+
+// Rolling sum over `period` inputs
+void rollingSum(const double *x, size_t n, int period, double *sum);
+// Rolling mean and population standard deviation, as IndicatorType::SMA / STDDEV;
+// stddev may be null
+void rollingMeanStd(const double *x, size_t n, int period, double *mean, double *stddev);
+// EMA with k = 2/(period+1) seeded with x[0], as IndicatorType::EMA; ready from index period-1
+void emaSeries(const double *x, size_t n, int period, double *ema);
+// RSI from the summed gains and losses of the last `period` price changes, as RsiStrategy
+// (no smoothing; no losses in the window gives 0); ready from index period
+void rsiSeries(const double *x, size_t n, int period, double *rsi);
+// Rolling minimum and maximum in three compares per element for any period (van Herk /
+// Gil-Werman block prefix and suffix extrema)
+void rollingMinMax(const double *x, size_t n, int period, double *min, double *max);
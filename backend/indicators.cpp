@@ -0,0 +1,171 @@
+#include "indicators.h"
+#include <cmath>
+
+int IndicatorRegistry::unitFor(UnitKind kind, int period)
+{
+    for (size_t i = 0; i < units_.size(); ++i)
+    {
+        if (units_[i].kind == kind && units_[i].period == period)
+            return static_cast<int>(i);
+    }
+    units_.push_back(Unit{kind, period});
+    return static_cast<int>(units_.size() - 1);
+}
+
+int IndicatorRegistry::declare(const IndicatorSpec &spec)
+{
+    IndicatorSpec s = spec;
+    if (s.period < 1)
+        s.period = 1;
+    for (size_t i = 0; i < indicators_.size(); ++i)
+    {
+        if (indicators_[i].type == s.type && indicators_[i].period == s.period)
+            return static_cast<int>(i);
+    }
+    if (indicators_.size() >= static_cast<size_t>(IndicatorSnapshot::MAX_INDICATORS))
+        return -1;
+
+    UnitKind kind = UnitKind::WINDOW;
+    if (s.type == IndicatorType::EMA)
+        kind = UnitKind::EMA;
+    else if (s.type == IndicatorType::VWAP)
+        kind = UnitKind::VWAP;
+    indicator_unit_.push_back(unitFor(kind, s.period));
+    indicators_.push_back(s);
+    return static_cast<int>(indicators_.size() - 1);
+}
+
+void IndicatorRegistry::clear()
+{
+    indicators_.clear();
+    indicator_unit_.clear();
+    units_.clear();
+    instruments_.clear();
+}
+
+void IndicatorRegistry::advance(const Unit &unit, UnitState &state, const MarketTick &tick)
+{
+    switch (unit.kind)
+    {
+    case UnitKind::WINDOW:
+    {
+        if (state.ring.empty())
+        {
+            state.ring.assign(unit.period, 0.0);
+            state.shift = tick.price;
+        }
+        double x = tick.price - state.shift;
+        if (state.count == unit.period)
+        {
+            double old = state.ring[state.head];
+            state.sum -= old;
+            state.sum_sq -= old * old;
+        }
+        else
+        {
+            ++state.count;
+        }
+        state.ring[state.head] = x;
+        state.sum += x;
+        state.sum_sq += x * x;
+        if (++state.head == unit.period)
+        {
+            // Re-sum once per lap so rounding from add/subtract never accumulates
+            state.head = 0;
+            state.sum = 0.0;
+            state.sum_sq = 0.0;
+            for (int i = 0; i < state.count; ++i)
+            {
+                state.sum += state.ring[i];
+                state.sum_sq += state.ring[i] * state.ring[i];
+            }
+        }
+        break;
+    }
+    case UnitKind::EMA:
+    {
+        double k = 2.0 / (unit.period + 1);
+        state.ema = state.count == 0 ? tick.price : tick.price * k + state.ema * (1.0 - k);
+        if (state.count < unit.period)
+            ++state.count;
+        break;
+    }
+    case UnitKind::VWAP:
+    {
+        if (state.ring.empty())
+        {
+            state.ring.assign(unit.period, 0.0);
+            state.volume.assign(unit.period, 0.0);
+        }
+        double v = tick.size > 0 ? tick.size : 1.0;
+        if (state.count == unit.period)
+        {
+            state.sum -= state.ring[state.head];
+            state.sum_volume -= state.volume[state.head];
+        }
+        else
+        {
+            ++state.count;
+        }
+        state.ring[state.head] = tick.price * v;
+        state.volume[state.head] = v;
+        state.sum += tick.price * v;
+        state.sum_volume += v;
+        if (++state.head == unit.period)
+        {
+            state.head = 0;
+            state.sum = 0.0;
+            state.sum_volume = 0.0;
+            for (int i = 0; i < state.count; ++i)
+            {
+                state.sum += state.ring[i];
+                state.sum_volume += state.volume[i];
+            }
+        }
+        break;
+    }
+    }
+}
+
+const IndicatorSnapshot &IndicatorRegistry::update(const MarketTick &tick)
+{
+    Instrument &inst = instruments_[InstrumentId(tick.venue, tick.symbol)];
+    if (inst.units.size() < units_.size())
+        inst.units.resize(units_.size());
+
+    for (size_t i = 0; i < units_.size(); ++i)
+        advance(units_[i], inst.units[i], tick);
+
+    IndicatorSnapshot &snap = inst.snapshot;
+    snap.ready_mask = 0;
+    for (size_t i = 0; i < indicators_.size(); ++i)
+    {
+        const IndicatorSpec &spec = indicators_[i];
+        const UnitState &state = inst.units[indicator_unit_[i]];
+        double n = static_cast<double>(state.count);
+        double value = 0.0;
+        switch (spec.type)
+        {
+        case IndicatorType::SMA:
+            value = state.shift + state.sum / n;
+            break;
+        case IndicatorType::STDDEV:
+        {
+            double mean = state.sum / n;
+            double var = state.sum_sq / n - mean * mean;
+            value = var > 0.0 ? std::sqrt(var) : 0.0;
+            break;
+        }
+        case IndicatorType::EMA:
+            value = state.ema;
+            break;
+        case IndicatorType::VWAP:
+            value = state.sum / (state.sum_volume > 0 ? state.sum_volume : 1.0);
+            break;
+        }
+        snap.values[i] = value;
+        if (state.count >= spec.period)
+            snap.ready_mask |= 1u << i;
+    }
+    return snap;
+}
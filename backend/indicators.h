@@ -0,0 +1,89 @@
+#pragma once
+
+#include "data_source.h"
+#include "fixed_string.h"
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+enum class IndicatorType
+{
+    SMA,    // rolling mean of price
+    STDDEV, // rolling population standard deviation of price
+    EMA,    // exponential moving average of price, ready after `period` samples
+    VWAP    // rolling volume-weighted average price (unit size when a tick has none)
+};
+
+struct IndicatorSpec
+{
+    IndicatorType type;
+    int period;
+};
+
+// Values of every declared indicator for one instrument after the latest tick
+struct IndicatorSnapshot
+{
+    static constexpr int MAX_INDICATORS = 16;
+
+    double values[MAX_INDICATORS];
+    uint32_t ready_mask{0};
+
+    bool ready(int handle) const { return handle >= 0 && (ready_mask >> handle) & 1u; }
+    double value(int handle) const { return values[handle]; }
+};
+
+// Per-instrument indicator cache. Strategies declare what they need (deduplicated by type
+// and period, and SMA/STDDEV of one period share a window); update() then advances each
+// unique indicator once per tick in O(1) and every consumer reads the same snapshot.
+class IndicatorRegistry
+{
+public:
+    // Returns a handle into IndicatorSnapshot, or -1 if the registry is full
+    int declare(const IndicatorSpec &spec);
+    const IndicatorSnapshot &update(const MarketTick &tick);
+    void clear();
+    size_t size() const { return indicators_.size(); }
+
+private:
+    enum class UnitKind
+    {
+        WINDOW,
+        EMA,
+        VWAP
+    };
+
+    struct Unit
+    {
+        UnitKind kind;
+        int period;
+    };
+
+    // Running state of one unit for one instrument
+    struct UnitState
+    {
+        std::vector<double> ring;   // prices (WINDOW) or price*size (VWAP)
+        std::vector<double> volume; // VWAP only
+        int head{0};
+        int count{0};
+        double shift{0.0}; // WINDOW sums are taken relative to the first price to keep variance precise
+        double sum{0.0};
+        double sum_sq{0.0};
+        double sum_volume{0.0};
+        double ema{0.0};
+    };
+
+    struct Instrument
+    {
+        std::vector<UnitState> units;
+        IndicatorSnapshot snapshot;
+    };
+
+    int unitFor(UnitKind kind, int period);
+    void advance(const Unit &unit, UnitState &state, const MarketTick &tick);
+
+    std::vector<IndicatorSpec> indicators_;
+    std::vector<int> indicator_unit_;
+    std::vector<Unit> units_;
+    std::map<InstrumentId, Instrument> instruments_;
+};
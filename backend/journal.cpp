@@ -0,0 +1,283 @@
+#include "journal.h"
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <set>
+#include <unistd.h>
+#include <vector>
+
+template <size_t N>
+static void copy_field(char (&dst)[N], const FixedString<N> &src)
+{
+    std::memcpy(dst, src.data, N);
+}
+
+static int64_t to_ms(const std::chrono::system_clock::time_point &tp)
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(tp.time_since_epoch()).count();
+}
+
+Journal::Journal(const std::string &path, uint64_t epoch, uint64_t base_epoch, int sync_interval_ms, size_t queue_capacity)
+    : path_(path), epoch_(epoch), base_epoch_(base_epoch), sync_interval_ms_(sync_interval_ms), fd_(-1), queue_(queue_capacity),
+      next_seq_(0), records_written_(0), records_lost_(0), syncs_(0), failed_(false), running_(false), file_bytes_(0)
+{
+}
+
+Journal::~Journal()
+{
+    stop();
+}
+
+bool Journal::start()
+{
+    if (running_)
+        return true;
+    fd_ = ::open(path_.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (fd_ < 0)
+    {
+        std::cerr << "Failed to open journal " << path_ << std::endl;
+        return false;
+    }
+    // A crash can leave a torn record at the end; cut it off so appended records stay aligned
+    off_t size = ::lseek(fd_, 0, SEEK_END);
+    file_bytes_ = size > 0 ? static_cast<uint64_t>(size) - static_cast<uint64_t>(size) % sizeof(JournalRecord) : 0;
+    if (size > 0 && static_cast<uint64_t>(size) != file_bytes_ && ::ftruncate(fd_, static_cast<off_t>(file_bytes_)) != 0)
+    {
+        std::cerr << "Failed to truncate torn record in journal " << path_ << std::endl;
+        ::close(fd_);
+        fd_ = -1;
+        return false;
+    }
+    failed_ = false;
+    JournalRecord marker{};
+    marker.type = JournalRecordType::EPOCH;
+    marker.id = base_epoch_;
+    marker.ts_ms = to_ms(std::chrono::system_clock::now());
+    push(marker);
+    running_ = true;
+    writer_thread_ = std::thread(&Journal::run, this);
+    return true;
+}
+
+void Journal::stop()
+{
+    if (!running_)
+        return;
+    running_ = false;
+    if (writer_thread_.joinable())
+        writer_thread_.join();
+    ::close(fd_);
+    fd_ = -1;
+}
+
+void Journal::recordOrder(const Order &order, uint32_t book)
+{
+    JournalRecord rec{};
+    rec.type = JournalRecordType::ORDER;
+    rec.side = order.side == OrderSide::BUY ? 0 : 1;
+    rec.quantity = order.quantity;
+    rec.price = order.price;
+    rec.ts_ms = to_ms(order.timestamp);
+    rec.exchange_recv_ts_ms = order.exchange_recv_ts_ms;
+    rec.ingest_ts_ms = order.ingest_ts_ms;
+    rec.id = order.id;
+    rec.book = book;
+    copy_field(rec.venue, order.venue);
+    copy_field(rec.symbol, order.symbol);
+    push(rec);
+}
+
+void Journal::recordTrade(const Trade &trade)
+{
+    JournalRecord rec{};
+    rec.type = JournalRecordType::TRADE;
+    rec.side = trade.side == OrderSide::BUY ? 0 : 1;
+    rec.quantity = trade.quantity;
+    rec.price = trade.price;
+    rec.pnl = trade.pnl;
+    rec.ts_ms = trade.order_executed_ts_ms;
+    rec.exchange_recv_ts_ms = trade.exchange_recv_ts_ms;
+    rec.ingest_ts_ms = trade.ingest_ts_ms;
+    rec.id = trade.id;
+    rec.book = trade.book;
+    copy_field(rec.venue, trade.venue);
+    copy_field(rec.symbol, trade.symbol);
+    push(rec);
+}
+
+void Journal::push(const JournalRecord &record)
+{
+    JournalRecord rec = record;
+    rec.seq = next_seq_.fetch_add(1, std::memory_order_relaxed);
+    rec.epoch = epoch_;
+    // Audit records are never dropped: if the writer falls a full ring behind, back-pressure
+    while (!queue_.tryPush(rec))
+        std::this_thread::yield();
+}
+
+uint64_t Journal::getRecordsWritten() const
+{
+    return records_written_.load(std::memory_order_relaxed);
+}
+
+uint64_t Journal::getRecordsLost() const
+{
+    return records_lost_.load(std::memory_order_relaxed);
+}
+
+bool Journal::failed() const
+{
+    return failed_.load(std::memory_order_relaxed);
+}
+
+uint64_t Journal::getSyncs() const
+{
+    return syncs_.load(std::memory_order_relaxed);
+}
+
+void Journal::run()
+{
+    std::vector<char> batch;
+    batch.reserve(WRITE_BATCH_BYTES);
+    auto last_sync = std::chrono::steady_clock::now();
+    bool dirty = false;
+    JournalRecord rec;
+
+    for (;;)
+    {
+        bool stopping = !running_;
+        while (batch.size() + sizeof(JournalRecord) <= WRITE_BATCH_BYTES && queue_.tryPop(rec))
+        {
+            const char *p = reinterpret_cast<const char *>(&rec);
+            batch.insert(batch.end(), p, p + sizeof(rec));
+        }
+
+        if (!batch.empty() && failed_)
+        {
+            // Journaling stopped after a write error; keep draining so producers never block on the ring
+            records_lost_.fetch_add(batch.size() / sizeof(JournalRecord), std::memory_order_relaxed);
+            batch.clear();
+        }
+        else if (!batch.empty())
+        {
+            size_t off = 0;
+            int err = 0;
+            while (off < batch.size())
+            {
+                ssize_t n = ::write(fd_, batch.data() + off, batch.size() - off);
+                if (n < 0 && errno == EINTR)
+                    continue;
+                if (n <= 0)
+                {
+                    err = n < 0 ? errno : ENOSPC;
+                    break;
+                }
+                off += static_cast<size_t>(n);
+            }
+            size_t whole = off / sizeof(JournalRecord);
+            records_written_.fetch_add(whole, std::memory_order_relaxed);
+            file_bytes_ += whole * sizeof(JournalRecord);
+            if (off < batch.size())
+            {
+                // Drop a torn record so the file stays a whole number of records, then stop: a gap
+                // in the middle of the journal would replay as a book that never existed
+                if (off % sizeof(JournalRecord) != 0 && ::ftruncate(fd_, static_cast<off_t>(file_bytes_)) != 0)
+                    std::cerr << "Failed to truncate journal " << path_ << " after a partial write" << std::endl;
+                size_t lost = batch.size() / sizeof(JournalRecord) - whole;
+                records_lost_.fetch_add(lost, std::memory_order_relaxed);
+                failed_ = true;
+                std::cerr << "Journal write failed: " << std::strerror(err) << "; journaling stopped after "
+                          << records_written_.load() << " records" << std::endl;
+            }
+            batch.clear();
+            dirty = true;
+        }
+
+        // Group commit: one fdatasync covers every record written since the previous one
+        auto now = std::chrono::steady_clock::now();
+        if (dirty && (stopping || now - last_sync >= std::chrono::milliseconds(sync_interval_ms_)))
+        {
+            ::fdatasync(fd_);
+            syncs_.fetch_add(1, std::memory_order_relaxed);
+            last_sync = now;
+            dirty = false;
+        }
+
+        if (stopping && queue_.sizeApprox() == 0)
+            break;
+        if (queue_.sizeApprox() == 0)
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+}
+
+bool Journal::read(const std::string &path, const std::function<void(const JournalRecord &)> &on_record)
+{
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+    std::vector<char> buf(WRITE_BATCH_BYTES);
+    size_t filled = 0;
+    for (;;)
+    {
+        ssize_t n = ::read(fd, buf.data() + filled, buf.size() - filled);
+        if (n <= 0)
+            break;
+        filled += static_cast<size_t>(n);
+        size_t whole = filled - filled % sizeof(JournalRecord);
+        for (size_t off = 0; off < whole; off += sizeof(JournalRecord))
+        {
+            JournalRecord rec;
+            std::memcpy(&rec, buf.data() + off, sizeof(rec));
+            on_record(rec);
+        }
+        // Keep a partial trailing record (torn write) for the next read
+        std::memmove(buf.data(), buf.data() + whole, filled - whole);
+        filled -= whole;
+    }
+    ::close(fd);
+    return true;
+}
+
+int Journal::replayInto(const std::string &path, OrderBook &order_book, uint64_t snapshot_epoch)
+{
+    int applied = 0;
+    int base = order_book.getTradeCount();
+    uint32_t book = order_book.bookId();
+    // Without a snapshot, rebuild the history of the most recent run that started from an empty
+    // book (epoch 0 covers journals written before epochs)
+    if (snapshot_epoch == 0 && !read(path, [&](const JournalRecord &rec)
+                                     {
+            if (rec.type == JournalRecordType::EPOCH && rec.id == 0)
+                snapshot_epoch = rec.epoch; }))
+        return -1;
+    // Epochs whose book descends from the snapshot: its own, then each run restored from one of them
+    std::set<uint64_t> lineage{snapshot_epoch};
+    bool ok = read(path, [&](const JournalRecord &rec)
+                   {
+        if (rec.type == JournalRecordType::EPOCH)
+        {
+            if (rec.id != 0 && lineage.count(rec.id))
+                lineage.insert(rec.epoch);
+            return;
+        }
+        if (rec.type != JournalRecordType::TRADE || rec.book != book || !lineage.count(rec.epoch))
+            return;
+        // Trade ids are the book's fill counter; fills already in the restored snapshot are skipped
+        if (rec.epoch == snapshot_epoch && rec.id <= static_cast<uint64_t>(base))
+            return;
+        Order order;
+        order.id = rec.id;
+        order.venue.assign(rec.venue, ::strnlen(rec.venue, sizeof(rec.venue)));
+        order.symbol.assign(rec.symbol, ::strnlen(rec.symbol, sizeof(rec.symbol)));
+        order.side = rec.side == 0 ? OrderSide::BUY : OrderSide::SELL;
+        order.price = rec.price;
+        order.quantity = rec.quantity;
+        order.timestamp = std::chrono::system_clock::time_point(std::chrono::milliseconds(rec.ts_ms));
+        order.exchange_recv_ts_ms = rec.exchange_recv_ts_ms;
+        order.ingest_ts_ms = rec.ingest_ts_ms;
+        order_book.submitOrder(order);
+        ++applied; });
+    return ok ? applied : -1;
+}
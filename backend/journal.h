@@ -0,0 +1,98 @@
+#pragma once
+
+#include "order_book.h"
+#include "lockfree_queue.h"
+#include <string>
+#include <atomic>
+#include <thread>
+#include <functional>
+#include <cstdint>
+
+enum class JournalRecordType : uint8_t
+{
+    ORDER = 1,
+    TRADE = 2,
+    // First record of each run: epoch is the run's, id the epoch of the snapshot it restored (0 = fresh book)
+    EPOCH = 3
+};
+
+// Fixed-size on-disk record; venue and symbol are NUL-padded to their field width
+struct JournalRecord
+{
+    uint64_t seq;
+    JournalRecordType type;
+    uint8_t side; // 0 = BUY, 1 = SELL
+    uint16_t reserved;
+    int32_t quantity;
+    double price;
+    double pnl;
+    int64_t ts_ms; // order created or trade executed
+    int64_t exchange_recv_ts_ms;
+    int64_t ingest_ts_ms;
+    uint64_t id; // order or trade id
+    char venue[16];
+    char symbol[24];
+    // Run that wrote the record (0 in journals from before epochs) and OrderBook::bookId(); trade
+    // ids are only unique within one epoch and book
+    uint64_t epoch;
+    uint32_t book;
+    uint8_t reserved2[12];
+};
+
+static_assert(sizeof(JournalRecord) == 128, "journal record layout changed");
+
+// Append-only journal of orders and fills. Hot-path threads enqueue fixed-size records
+// into a lock-free ring; a writer thread batches them and group-commits with fdatasync.
+// Each run appends under its own epoch, and records which snapshot epoch its book was restored
+// from, so a journal kept across restarts replays only the fills of the current book's history.
+class Journal
+{
+public:
+    // epoch: this run's id (increasing across runs); base_epoch: the epoch of the snapshot the book
+    // was restored from, 0 if it started empty
+    Journal(const std::string &path, uint64_t epoch, uint64_t base_epoch, int sync_interval_ms = 5,
+            size_t queue_capacity = 65536);
+    ~Journal();
+
+    bool start();
+    void stop();
+
+    void recordOrder(const Order &order, uint32_t book);
+    void recordTrade(const Trade &trade);
+
+    uint64_t getRecordsWritten() const;
+    // Records discarded after a write error; once one fails, journaling stops until restarted
+    uint64_t getRecordsLost() const;
+    bool failed() const;
+    uint64_t getSyncs() const;
+
+    // Reads every complete record in order; returns false if the file cannot be opened
+    static bool read(const std::string &path, const std::function<void(const JournalRecord &)> &on_record);
+    // Rolls a book restored from a snapshot taken in snapshot_epoch forward: re-applies its book's
+    // fills from that epoch with ids above the restored trade count, then every fill of the runs
+    // restored from that epoch in turn. Runs that started from an empty book, and other books'
+    // fills, are skipped. snapshot_epoch 0 replays the latest run that started empty, and its
+    // descendants, onto an empty book. Returns fills applied, or -1 if the journal cannot be opened.
+    static int replayInto(const std::string &path, OrderBook &order_book, uint64_t snapshot_epoch = 0);
+
+private:
+    void push(const JournalRecord &record);
+    void run();
+
+    std::string path_;
+    uint64_t epoch_;
+    uint64_t base_epoch_;
+    int sync_interval_ms_;
+    int fd_;
+    BoundedQueue<JournalRecord> queue_;
+    std::atomic<uint64_t> next_seq_;
+    std::atomic<uint64_t> records_written_;
+    std::atomic<uint64_t> records_lost_;
+    std::atomic<uint64_t> syncs_;
+    std::atomic<bool> failed_;
+    std::atomic<bool> running_;
+    std::thread writer_thread_;
+    uint64_t file_bytes_; // journal length, always a whole number of records (writer thread)
+
+    static constexpr size_t WRITE_BATCH_BYTES = 1 << 20;
+};
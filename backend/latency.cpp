@@ -1,8 +1,13 @@
 #include "latency.h"
+#include "trace.h"
+#include <algorithm>
 #include <iostream>
 
 LatencySimulator::LatencySimulator() : running_(false)
 {
+    pending_.reserve(MAX_PENDING_ORDERS);
+    ready_.reserve(MAX_PENDING_ORDERS);
+
     // Set default latencies for different venues
     venue_latencies_["NASDAQ"] = 20.0; // 20ms
     venue_latencies_["LSE"] = 70.0;    // 70ms
@@ -36,30 +41,57 @@ void LatencySimulator::stop()
     }
 }
 
-void LatencySimulator::addOrderDelay(const std::string &order_id, const std::string &venue, std::function<void()> callback)
+void LatencySimulator::addOrderDelay(OrderBook &book, const Order &order)
 {
-    double latency_ms = getVenueLatency(venue);
+    TraceScope trace("addOrderDelay");
+    double latency_ms = getVenueLatency(order.venue);
 
     DelayedOrder delayed_order;
-    delayed_order.order_id = order_id;
-    delayed_order.venue = venue;
+    delayed_order.order = order;
+    delayed_order.book = &book;
     delayed_order.execute_time = std::chrono::system_clock::now() +
                                  std::chrono::milliseconds(static_cast<int>(latency_ms));
-    delayed_order.callback = callback;
+    delayed_order.batch_size = 1;
 
     {
         std::lock_guard<std::mutex> lock(queue_mutex_);
-        delayed_queue_.push(delayed_order);
+        pending_.push_back(delayed_order);
+        pending_depth_.store(pending_.size(), std::memory_order_relaxed);
     }
 
-    // Emit latency event
+    emitLatencyEvent(order, latency_ms);
+}
+
+void LatencySimulator::addOrderBatch(OrderBook &book, const Order *orders, size_t count)
+{
+    if (count == 0)
+        return;
+    TraceScope trace("addOrderBatch");
+    double latency_ms = 0.0;
+    for (size_t i = 0; i < count; ++i)
+        latency_ms = std::max(latency_ms, getVenueLatency(orders[i].venue));
+    auto execute_time = std::chrono::system_clock::now() + std::chrono::milliseconds(static_cast<int>(latency_ms));
+
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        for (size_t i = 0; i < count; ++i)
+            pending_.push_back(DelayedOrder{orders[i], &book, execute_time, i == 0 ? static_cast<uint32_t>(count) : 0u});
+        pending_depth_.store(pending_.size(), std::memory_order_relaxed);
+    }
+
+    for (size_t i = 0; i < count; ++i)
+        emitLatencyEvent(orders[i], latency_ms);
+}
+
+void LatencySimulator::emitLatencyEvent(const Order &order, double latency_ms)
+{
     if (latency_callback_)
     {
         LatencyEvent event;
-        event.venue = venue;
+        event.venue = order.venue;
         event.latency_ms = latency_ms;
         event.timestamp = std::chrono::system_clock::now();
-        event.order_id = order_id;
+        event.order_id = order.id;
         latency_callback_(event);
     }
 }
@@ -74,7 +106,7 @@ void LatencySimulator::setVenueLatency(const std::string &venue, double latency_
     venue_latencies_[venue] = latency_ms;
 }
 
-double LatencySimulator::getVenueLatency(const std::string &venue) const
+double LatencySimulator::getVenueLatency(const VenueId &venue) const
 {
     auto it = venue_latencies_.find(venue);
     return (it != venue_latencies_.end()) ? it->second : 50.0; // Default 50ms
@@ -82,45 +114,51 @@ double LatencySimulator::getVenueLatency(const std::string &venue) const
 
 void LatencySimulator::processDelayedItems()
 {
+    setTraceThreadName("latency");
     while (running_)
     {
-        std::queue<DelayedOrder> ready_orders;
         auto now = std::chrono::system_clock::now();
 
-        // Check for orders ready to execute
+        // Move due orders out, compacting the rest in place so FIFO order is kept. A batch shares
+        // one execute_time, so its entries stay contiguous on both sides.
         {
             std::lock_guard<std::mutex> lock(queue_mutex_);
-            std::queue<DelayedOrder> temp_queue;
-
-            while (!delayed_queue_.empty())
+            size_t kept = 0;
+            for (size_t i = 0; i < pending_.size(); ++i)
             {
-                DelayedOrder order = delayed_queue_.front();
-                delayed_queue_.pop();
-
-                if (order.execute_time <= now)
-                {
-                    ready_orders.push(order);
-                }
+                if (pending_[i].execute_time <= now)
+                    ready_.push_back(pending_[i]);
                 else
-                {
-                    temp_queue.push(order);
-                }
+                    pending_[kept++] = pending_[i];
             }
-
-            delayed_queue_ = temp_queue;
+            pending_.resize(kept);
+            pending_depth_.store(kept, std::memory_order_relaxed);
         }
 
         // Execute ready orders
-        while (!ready_orders.empty())
+        for (size_t i = 0; i < ready_.size();)
         {
-            DelayedOrder order = ready_orders.front();
-            ready_orders.pop();
-
-            if (order.callback)
+            const DelayedOrder &delayed = ready_[i];
+            if (delayed.batch_size <= 1)
+            {
+                delayed.book->submitOrder(delayed.order);
+                ++i;
+                continue;
+            }
+            Order batch[OrderBook::MAX_BATCH_ORDERS];
+            size_t n = 0;
+            size_t end = std::min(ready_.size(), i + delayed.batch_size);
+            for (; i < end; ++i)
             {
-                order.callback();
+                batch[n++] = ready_[i].order;
+                if (n == OrderBook::MAX_BATCH_ORDERS || i + 1 == end)
+                {
+                    delayed.book->submitOrders(batch, n);
+                    n = 0;
+                }
             }
         }
+        ready_.clear();
 
         std::this_thread::sleep_for(std::chrono::milliseconds(PROCESSING_INTERVAL_MS));
     }
@@ -5,24 +5,27 @@
 #include <chrono>
 #include <functional>
 #include <thread>
-#include <queue>
+#include <vector>
 #include <mutex>
 #include <atomic>
+#include "order_book.h"
 
 struct LatencyEvent
 {
-    std::string venue;
+    VenueId venue;
     double latency_ms;
     std::chrono::system_clock::time_point timestamp;
-    std::string order_id;
+    uint64_t order_id;
 };
 
+// Held by value in a preallocated pool; no per-order callback or heap node
 struct DelayedOrder
 {
-    std::string order_id;
-    std::string venue;
+    Order order;
+    OrderBook *book;
     std::chrono::system_clock::time_point execute_time;
-    std::function<void()> callback;
+    // Set on the first entry of a batch: that many contiguous entries execute together
+    uint32_t batch_size;
 };
 
 class LatencySimulator
@@ -34,19 +37,30 @@ public:
     void start();
     void stop();
 
-    void addOrderDelay(const std::string &order_id, const std::string &venue, std::function<void()> callback);
+    // Submits the order to the book once the venue's latency has elapsed
+    void addOrderDelay(OrderBook &book, const Order &order);
+    // One enqueue for the whole batch; it is released when its slowest venue's latency has
+    // elapsed and applied with OrderBook::submitOrders
+    void addOrderBatch(OrderBook &book, const Order *orders, size_t count);
     void setLatencyCallback(std::function<void(const LatencyEvent &)> callback);
 
     // Latency configuration
     void setVenueLatency(const std::string &venue, double latency_ms);
-    double getVenueLatency(const std::string &venue) const;
+    double getVenueLatency(const VenueId &venue) const;
+
+    // Orders waiting out their modelled latency
+    size_t getPendingDepth() const { return pending_depth_.load(std::memory_order_relaxed); }
 
 private:
     void processDelayedItems();
+    void emitLatencyEvent(const Order &order, double latency_ms);
 
-    std::map<std::string, double> venue_latencies_;
-    std::queue<DelayedOrder> delayed_queue_;
+    std::map<VenueId, double> venue_latencies_;
+    // Both reserved to MAX_PENDING_ORDERS up front; they only grow past that under overload
+    std::vector<DelayedOrder> pending_;
+    std::vector<DelayedOrder> ready_;
     std::mutex queue_mutex_;
+    std::atomic<size_t> pending_depth_{0};
 
     std::function<void(const LatencyEvent &)> latency_callback_;
 
@@ -54,4 +68,5 @@ private:
     std::thread processor_thread_;
 
     static constexpr int PROCESSING_INTERVAL_MS = 1;
+    static constexpr size_t MAX_PENDING_ORDERS = 65536;
 };
\ No newline at end of file
@@ -0,0 +1,186 @@
+#include "latency_histogram.h"
+#include <algorithm>
+#include <sstream>
+
+LatencyHistogram::LatencyHistogram()
+{
+    reset();
+}
+
+void LatencyHistogram::reset()
+{
+    for (auto &c : counts_)
+        c.store(0, std::memory_order_relaxed);
+    count_.store(0, std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+}
+
+int LatencyHistogram::bucketFor(uint64_t ns)
+{
+    if (ns < static_cast<uint64_t>(SUB_BUCKETS))
+        return static_cast<int>(ns);
+    int msb = 63 - __builtin_clzll(ns);
+    if (msb > MAX_MSB)
+        return BUCKETS - 1;
+    int shift = msb - SUB_BITS;
+    return SUB_BUCKETS + shift * SUB_BUCKETS + static_cast<int>((ns >> shift) & (SUB_BUCKETS - 1));
+}
+
+int64_t LatencyHistogram::bucketUpper(int bucket)
+{
+    if (bucket < SUB_BUCKETS)
+        return bucket;
+    int shift = (bucket - SUB_BUCKETS) / SUB_BUCKETS;
+    int64_t sub = (bucket - SUB_BUCKETS) % SUB_BUCKETS;
+    int64_t lower = (SUB_BUCKETS + sub) << shift;
+    return lower + (int64_t(1) << shift) - 1;
+}
+
+void LatencyHistogram::record(int64_t ns)
+{
+    if (ns < 0)
+        return;
+    counts_[bucketFor(static_cast<uint64_t>(ns))].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    int64_t seen = max_.load(std::memory_order_relaxed);
+    while (ns > seen && !max_.compare_exchange_weak(seen, ns, std::memory_order_relaxed))
+    {
+    }
+}
+
+int64_t LatencyHistogram::percentile(double q) const
+{
+    // Counts are read bucket by bucket while writers may still add; rank against what was read
+    uint64_t snapshot[BUCKETS];
+    uint64_t total = 0;
+    for (int i = 0; i < BUCKETS; ++i)
+    {
+        snapshot[i] = counts_[i].load(std::memory_order_relaxed);
+        total += snapshot[i];
+    }
+    if (total == 0)
+        return 0;
+    uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(total));
+    if (rank >= total)
+        rank = total - 1;
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKETS; ++i)
+    {
+        seen += snapshot[i];
+        if (seen > rank)
+            return std::min(bucketUpper(i), max());
+    }
+    return max();
+}
+
+const char *latencyStageName(LatencyStage stage)
+{
+    switch (stage)
+    {
+    case LatencyStage::WIRE:
+        return "wire";
+    case LatencyStage::DECIDE:
+        return "decide";
+    case LatencyStage::RISK:
+        return "risk";
+    case LatencyStage::EXECUTE:
+        return "execute";
+    case LatencyStage::BROADCAST:
+        return "broadcast";
+    case LatencyStage::TICK_TO_TRADE:
+        return "tick_to_trade";
+    default:
+        return "unknown";
+    }
+}
+
+StageLatencies::VenueSlot *StageLatencies::slotFor(const VenueId &venue)
+{
+    for (auto &slot : venues_)
+    {
+        int state = slot.state.load(std::memory_order_acquire);
+        if (state == 0)
+        {
+            if (slot.state.compare_exchange_strong(state, 1, std::memory_order_acquire))
+            {
+                slot.venue = venue;
+                slot.state.store(2, std::memory_order_release);
+                return &slot;
+            }
+        }
+        // Another thread is claiming this slot; wait for its venue before comparing
+        while (state == 1)
+            state = slot.state.load(std::memory_order_acquire);
+        if (slot.venue == venue)
+            return &slot;
+    }
+    return nullptr;
+}
+
+void StageLatencies::record(const VenueId &venue, LatencyStage stage, int64_t ns)
+{
+    if (ns < 0)
+        return;
+    int s = static_cast<int>(stage);
+    all_[s].record(ns);
+    if (VenueSlot *slot = slotFor(venue))
+        slot->stages[s].record(ns);
+}
+
+void StageLatencies::recordTrade(const Trade &trade, int64_t broadcast_ns)
+{
+    VenueSlot *slot = slotFor(trade.venue);
+    auto stage = [&](LatencyStage st, int64_t from, int64_t to)
+    {
+        if (from < 0 || to < from)
+            return;
+        int s = static_cast<int>(st);
+        all_[s].record(to - from);
+        if (slot)
+            slot->stages[s].record(to - from);
+    };
+    stage(LatencyStage::DECIDE, trade.ingest_ns, trade.created_ns);
+    stage(LatencyStage::RISK, trade.created_ns, trade.accepted_ns);
+    stage(LatencyStage::EXECUTE, trade.accepted_ns, trade.executed_ns);
+    stage(LatencyStage::BROADCAST, trade.executed_ns, broadcast_ns);
+    stage(LatencyStage::TICK_TO_TRADE, trade.ingest_ns, trade.executed_ns);
+}
+
+void StageLatencies::reset()
+{
+    for (auto &h : all_)
+        h.reset();
+    for (auto &slot : venues_)
+    {
+        for (auto &h : slot.stages)
+            h.reset();
+    }
+}
+
+static void histogramToText(std::ostringstream &oss, const std::string &prefix, const LatencyHistogram &h)
+{
+    oss << prefix << "_count=" << h.count() << "\n";
+    oss << prefix << "_p50_ns=" << h.percentile(0.50) << "\n";
+    oss << prefix << "_p99_ns=" << h.percentile(0.99) << "\n";
+    oss << prefix << "_p999_ns=" << h.percentile(0.999) << "\n";
+    oss << prefix << "_max_ns=" << h.max() << "\n";
+}
+
+std::string StageLatencies::statsToText() const
+{
+    std::ostringstream oss;
+    for (int s = 0; s < STAGES; ++s)
+        histogramToText(oss, latencyStageName(static_cast<LatencyStage>(s)), all_[s]);
+    for (const auto &slot : venues_)
+    {
+        if (slot.state.load(std::memory_order_acquire) != 2)
+            continue;
+        for (int s = 0; s < STAGES; ++s)
+        {
+            if (slot.stages[s].count() == 0)
+                continue;
+            histogramToText(oss, slot.venue.str() + "_" + latencyStageName(static_cast<LatencyStage>(s)), slot.stages[s]);
+        }
+    }
+    return oss.str();
+}
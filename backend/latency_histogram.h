@@ -0,0 +1,84 @@
+#pragma once
+
+#include "fixed_string.h"
+#include "order_book.h"
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Log-linear (HDR-style) histogram of nanosecond durations: 32 linear sub-buckets per power of
+// two, so any recorded value is reported within ~3% up to 2^41 ns (~37 minutes; longer values
+// land in the top bucket). Recording is a relaxed fetch_add, safe from any number of threads;
+// readers see a slightly torn but never corrupt view.
+class LatencyHistogram
+{
+public:
+    LatencyHistogram();
+
+    void record(int64_t ns);
+    void reset();
+
+    uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+    int64_t max() const { return max_.load(std::memory_order_relaxed); }
+    // Upper bound of the bucket holding the q-quantile (0..1), capped at max(); 0 when empty
+    int64_t percentile(double q) const;
+
+private:
+    static constexpr int SUB_BITS = 5;
+    static constexpr int SUB_BUCKETS = 1 << SUB_BITS;
+    static constexpr int MAX_MSB = 40;
+    static constexpr int BUCKETS = SUB_BUCKETS * (MAX_MSB - SUB_BITS + 2);
+
+    static int bucketFor(uint64_t ns);
+    static int64_t bucketUpper(int bucket);
+
+    std::atomic<uint64_t> counts_[BUCKETS];
+    std::atomic<uint64_t> count_{0};
+    std::atomic<int64_t> max_{0};
+};
+
+// Pipeline stages between steady-clock stamps on ticks, orders and trades
+enum class LatencyStage
+{
+    WIRE,          // exchange timestamp -> ingest (wall clocks, ms resolution; live feed only)
+    DECIDE,        // tick ingest -> order built by the strategy
+    RISK,          // order built -> risk accepted and handed to execution
+    EXECUTE,       // handed to execution -> applied to the book (includes the modelled delay)
+    BROADCAST,     // applied -> trade message sent to clients
+    TICK_TO_TRADE, // tick ingest -> applied to the book
+    COUNT
+};
+
+const char *latencyStageName(LatencyStage stage);
+
+// One histogram per stage overall and per venue. Venues claim one of MAX_VENUES slots on first
+// use with a CAS; later venues only count towards the overall histograms.
+class StageLatencies
+{
+public:
+    // Negative durations (missing stamps) are ignored
+    void record(const VenueId &venue, LatencyStage stage, int64_t ns);
+    // Every stage the trade carries stamps for, ending at broadcast_ns
+    void recordTrade(const Trade &trade, int64_t broadcast_ns);
+    void reset();
+
+    // key=value lines: <stage>_count/_p50_ns/_p99_ns/_p999_ns/_max_ns, then the same per venue
+    // prefixed with the venue name
+    std::string statsToText() const;
+
+private:
+    static constexpr int MAX_VENUES = 16;
+    static constexpr int STAGES = static_cast<int>(LatencyStage::COUNT);
+
+    struct VenueSlot
+    {
+        std::atomic<int> state{0}; // 0 free, 1 being claimed, 2 ready
+        VenueId venue;
+        LatencyHistogram stages[STAGES];
+    };
+
+    VenueSlot *slotFor(const VenueId &venue);
+
+    LatencyHistogram all_[STAGES];
+    VenueSlot venues_[MAX_VENUES];
+};
@@ -1,28 +1,284 @@
 #include "live_feed_coinbase.h"
+#include "coinbase_parser.h"
+#include "trace.h"
 #include <boost/asio.hpp>
+#include <boost/asio/ssl/host_name_verification.hpp>
 #include <boost/beast.hpp>
 #include <boost/beast/ssl.hpp>
 #include <boost/beast/websocket.hpp>
 #include <boost/beast/websocket/ssl.hpp>
+#include <algorithm>
 #include <iostream>
 #include <chrono>
+#include <charconv>
+#include <random>
+#include <sstream>
 #include <thread>
 
 using tcp = boost::asio::ip::tcp;
+namespace asio = boost::asio;
+namespace beast = boost::beast;
 namespace ssl = boost::asio::ssl;
 namespace websocket = boost::beast::websocket;
 
-LiveFeedCoinbase::LiveFeedCoinbase(const std::string &symbol) : symbol_(symbol) {}
+static std::string build_subscribe_message(const std::vector<std::string> &product_ids, const char *channel)
+{
+    // Coinbase Advanced public stream subscription (text protocol)
+    // {"type":"subscribe","channel":"market_trades","product_ids":["BTC-USD"]}
+    std::ostringstream oss;
+    oss << "{\"type\":\"subscribe\",\"channel\":\"" << channel << "\",\"product_ids\":[";
+    for (size_t i = 0; i < product_ids.size(); ++i)
+        oss << (i > 0 ? "," : "") << "\"" << product_ids[i] << "\"";
+    oss << "]}";
+    return oss.str();
+}
+
+// One WebSocket connection and its reconnect loop. All handlers run on the feed's io thread.
+class CoinbaseConnection
+{
+public:
+    CoinbaseConnection(LiveFeedCoinbase &feed, asio::io_context &ioc, ssl::context &ctx, int id, std::vector<std::string> products)
+        : feed_(feed), ioc_(ioc), ctx_(ctx), id_(id), resolver_(ioc), retry_timer_(ioc),
+          backoff_ms_(feed.cfg_.backoff_initial_ms), rng_(std::random_device{}())
+    {
+        subscribe_[0] = build_subscribe_message(products, "market_trades");
+        subscribe_[1] = build_subscribe_message(products, "heartbeats");
+        tick_.venue = "COINBASE";
+        tick_.symbol = products.empty() ? std::string() : products[0];
+    }
+
+    void start() { connect(); }
+
+    void close()
+    {
+        stopping_ = true;
+        retry_timer_.cancel();
+        resolver_.cancel();
+        if (ws_ && ws_->is_open())
+            ws_->async_close(websocket::close_code::normal, [](beast::error_code) {});
+        else if (ws_)
+            beast::get_lowest_layer(*ws_).close();
+    }
+
+private:
+    using WsStream = websocket::stream<beast::ssl_stream<beast::tcp_stream>>;
+
+    void connect()
+    {
+        if (stopping_)
+            return;
+        // A fresh stream per attempt; a failed TLS or WebSocket stream cannot be reused
+        ws_ = std::make_unique<WsStream>(ioc_, ctx_);
+        last_seq_ = -1;
+        resolver_.async_resolve(feed_.cfg_.host, feed_.cfg_.port, [this](beast::error_code ec, tcp::resolver::results_type results)
+                                {
+            if (ec)
+                return fail("resolve", ec);
+            beast::get_lowest_layer(*ws_).expires_after(std::chrono::seconds(10));
+            beast::get_lowest_layer(*ws_).async_connect(results, [this](beast::error_code ec, const tcp::endpoint &)
+                                                        { onConnect(ec); }); });
+    }
+
+    void onConnect(beast::error_code ec)
+    {
+        if (ec)
+            return fail("connect", ec);
+        if (!SSL_set_tlsext_host_name(ws_->next_layer().native_handle(), feed_.cfg_.host.c_str()))
+            return fail("sni", beast::error_code(static_cast<int>(::ERR_get_error()), asio::error::get_ssl_category()));
+        ws_->next_layer().async_handshake(ssl::stream_base::client, [this](beast::error_code ec)
+                                          { onTlsHandshake(ec); });
+    }
+
+    void onTlsHandshake(beast::error_code ec)
+    {
+        if (ec)
+            return fail("tls handshake", ec);
+        // The websocket stream takes over timeouts: handshake limit, idle limit with keep-alive pings
+        beast::get_lowest_layer(*ws_).expires_never();
+        websocket::stream_base::timeout timeouts;
+        timeouts.handshake_timeout = std::chrono::seconds(10);
+        timeouts.idle_timeout = std::chrono::seconds(15);
+        timeouts.keep_alive_pings = true;
+        ws_->set_option(timeouts);
+        ws_->set_option(websocket::stream_base::decorator([](websocket::request_type &req)
+                                                          { req.set(beast::http::field::user_agent, std::string("TradePulse/1.0")); }));
+        ws_->async_handshake(feed_.cfg_.host, feed_.cfg_.target, [this](beast::error_code ec)
+                             { onWsHandshake(ec); });
+    }
+
+    void onWsHandshake(beast::error_code ec)
+    {
+        if (ec)
+            return fail("websocket handshake", ec);
+        ws_->text(true);
+        subscribe(0);
+    }
+
+    void subscribe(size_t index)
+    {
+        if (index == 2)
+        {
+            feed_.connected_.fetch_add(1, std::memory_order_relaxed);
+            counted_connected_ = true;
+            std::cout << "Coinbase feed [" << id_ << "]: subscribed" << std::endl;
+            return read();
+        }
+        ws_->async_write(asio::buffer(subscribe_[index]), [this, index](beast::error_code ec, size_t)
+                         {
+            if (ec)
+                return fail("subscribe", ec);
+            subscribe(index + 1); });
+    }
+
+    void read()
+    {
+        buffer_.clear();
+        ws_->async_read(buffer_, [this](beast::error_code ec, size_t)
+                        { onRead(ec); });
+    }
+
+    void onRead(beast::error_code ec)
+    {
+        if (ec)
+            return fail("read", ec);
+        auto now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+        // The flat buffer is one contiguous run of bytes; parse it where it lies
+        auto data = buffer_.data();
+        std::string_view msg(static_cast<const char *>(data.data()), data.size());
+        if (parseCoinbaseMessage(msg, message_))
+        {
+            feed_.messages_.fetch_add(1, std::memory_order_relaxed);
+            // sequence_num counts every message on the connection, whatever its channel
+            if (message_.sequence_num >= 0)
+            {
+                if (last_seq_ >= 0 && message_.sequence_num > last_seq_ + 1)
+                {
+                    uint64_t missed = static_cast<uint64_t>(message_.sequence_num - last_seq_ - 1);
+                    feed_.sequence_gaps_.fetch_add(missed, std::memory_order_relaxed);
+                    std::cerr << "Coinbase feed [" << id_ << "]: sequence gap, " << missed << " message(s) missed after "
+                              << last_seq_ << std::endl;
+                }
+                last_seq_ = message_.sequence_num;
+            }
+            if (message_.channel == "market_trades")
+            {
+                // Data is flowing again: the next failure starts the backoff from the bottom
+                backoff_ms_ = feed_.cfg_.backoff_initial_ms;
+                feed_.emitTrades(message_, tick_, now_ms);
+            }
+        }
+        read();
+    }
+
+    void fail(const char *what, beast::error_code ec)
+    {
+        if (counted_connected_)
+        {
+            feed_.connected_.fetch_sub(1, std::memory_order_relaxed);
+            counted_connected_ = false;
+        }
+        if (stopping_)
+            return;
+        // Jittered so sharded connections dropped together do not reconnect in lockstep
+        std::uniform_real_distribution<double> jitter(0.8, 1.2);
+        int delay_ms = static_cast<int>(backoff_ms_ * jitter(rng_));
+        backoff_ms_ = std::min(backoff_ms_ * 2, feed_.cfg_.backoff_max_ms);
+        std::cerr << "Coinbase feed [" << id_ << "]: " << what << " failed: " << ec.message() << "; reconnecting in "
+                  << delay_ms << " ms" << std::endl;
+        if (ws_)
+        {
+            beast::error_code ignored;
+            beast::get_lowest_layer(*ws_).socket().close(ignored);
+        }
+        retry_timer_.expires_after(std::chrono::milliseconds(delay_ms));
+        retry_timer_.async_wait([this](beast::error_code ec)
+                                {
+            if (ec || stopping_)
+                return;
+            feed_.reconnects_.fetch_add(1, std::memory_order_relaxed);
+            connect(); });
+    }
+
+    LiveFeedCoinbase &feed_;
+    asio::io_context &ioc_;
+    ssl::context &ctx_;
+    int id_;
+    std::string subscribe_[2];
+    tcp::resolver resolver_;
+    asio::steady_timer retry_timer_;
+    std::unique_ptr<WsStream> ws_;
+    beast::flat_buffer buffer_;
+    CoinbaseMessage message_;
+    MarketTick tick_{};
+    int64_t last_seq_{-1};
+    int backoff_ms_;
+    bool stopping_{false};
+    bool counted_connected_{false};
+    std::mt19937 rng_;
+};
+
+struct LiveFeedCoinbase::Session
+{
+    asio::io_context ioc;
+    ssl::context ctx{ssl::context::tlsv12_client};
+    std::vector<std::unique_ptr<CoinbaseConnection>> connections;
+};
+
+LiveFeedCoinbase::LiveFeedCoinbase(const std::string &symbol)
+{
+    cfg_.products = {symbol};
+}
+
+LiveFeedCoinbase::LiveFeedCoinbase(const CoinbaseFeedConfig &cfg) : cfg_(cfg)
+{
+    if (cfg_.products.empty())
+        cfg_.products = {"BTC-USD"};
+    cfg_.connections = std::max(1, std::min(cfg_.connections, static_cast<int>(cfg_.products.size())));
+}
 
 LiveFeedCoinbase::~LiveFeedCoinbase() { stop(); }
 
+bool LiveFeedCoinbase::parseUrl(const std::string &url, CoinbaseFeedConfig &cfg)
+{
+    const std::string scheme = "wss://";
+    if (url.compare(0, scheme.size(), scheme) != 0)
+        return false;
+    std::string rest = url.substr(scheme.size());
+    size_t slash = rest.find('/');
+    std::string authority = rest.substr(0, slash);
+    cfg.target = slash == std::string::npos ? "/" : rest.substr(slash);
+    size_t colon = authority.rfind(':');
+    cfg.host = authority.substr(0, colon);
+    cfg.port = colon == std::string::npos ? "443" : authority.substr(colon + 1);
+    return !cfg.host.empty() && !cfg.port.empty();
+}
+
 void LiveFeedCoinbase::start(std::function<void(const MarketTick &)> on_tick)
 {
     if (running_)
         return;
     running_ = true;
     on_tick_ = on_tick;
-    thread_ = std::thread(&LiveFeedCoinbase::run, this);
+    session_ = std::make_unique<Session>();
+    if (!cfg_.ca_file.empty())
+    {
+        session_->ctx.load_verify_file(cfg_.ca_file);
+        session_->ctx.set_verify_mode(ssl::verify_peer);
+        session_->ctx.set_verify_callback(ssl::host_name_verification(cfg_.host));
+    }
+    std::vector<std::vector<std::string>> shards(static_cast<size_t>(std::max(1, cfg_.connections)));
+    for (size_t i = 0; i < cfg_.products.size(); ++i)
+        shards[i % shards.size()].push_back(cfg_.products[i]);
+    for (size_t i = 0; i < shards.size(); ++i)
+    {
+        session_->connections.push_back(
+            std::make_unique<CoinbaseConnection>(*this, session_->ioc, session_->ctx, static_cast<int>(i), shards[i]));
+        session_->connections.back()->start();
+    }
+    thread_ = std::thread([this]
+                          {
+        setTraceThreadName("feed");
+        session_->ioc.run(); });
 }
 
 void LiveFeedCoinbase::stop()
@@ -30,115 +286,75 @@ void LiveFeedCoinbase::stop()
     if (!running_)
         return;
     running_ = false;
+    // Close every connection politely; the loop returns once nothing is left pending, and is
+    // stopped outright if that takes over a second
+    asio::post(session_->ioc, [this]
+               {
+        for (auto &connection : session_->connections)
+            connection->close(); });
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+    while (!session_->ioc.stopped() && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    session_->ioc.stop();
     if (thread_.joinable())
         thread_.join();
+    // The loop has stopped: handlers still queued are destroyed, never run
+    session_->connections.clear();
+    session_.reset();
+    connected_ = 0;
 }
 
-static std::string build_subscribe_message(const std::string &product_id)
+void LiveFeedCoinbase::emitTrades(const CoinbaseMessage &message, MarketTick &tick, int64_t now_ms)
 {
-    // Coinbase Advanced public trades stream subscription (text protocol)
-    // {"type":"subscribe","channel":"market_trades","product_ids":["BTC-USD"]}
-    std::ostringstream oss;
-    oss << "{\"type\":\"subscribe\",\"channel\":\"market_trades\",\"product_ids\":[\"" << product_id << "\"]}";
-    return oss.str();
-}
-
-void LiveFeedCoinbase::run()
-{
-    try
+    // Batches list trades newest first, often many to the millisecond; emit them in trade_id order
+    // so strategies see time moving forward and the per-product high-water mark only climbs
+    const auto &trades = message.trades;
+    order_.clear();
+    bool numeric_ids = true;
+    for (size_t n = 0; n < trades.size(); ++n)
     {
-        boost::asio::io_context ioc;
-        ssl::context ctx(ssl::context::tlsv12_client);
-        tcp::resolver resolver(ioc);
-        auto const host = std::string("advanced-trade-ws.coinbase.com");
-        auto const port = std::string("443");
-        auto const results = resolver.resolve(host, port);
-        boost::beast::ssl_stream<boost::beast::tcp_stream> tls_stream(ioc, ctx);
-        boost::beast::get_lowest_layer(tls_stream).connect(results);
-        if (!SSL_set_tlsext_host_name(tls_stream.native_handle(), host.c_str()))
+        int64_t trade_id = -1;
+        const auto &id = trades[n].trade_id;
+        if (id.empty() || std::from_chars(id.data(), id.data() + id.size(), trade_id).ptr != id.data() + id.size())
         {
-            return;
+            numeric_ids = false;
+            trade_id = -1;
         }
-        tls_stream.handshake(ssl::stream_base::client);
-        websocket::stream<boost::beast::ssl_stream<boost::beast::tcp_stream>> ws(std::move(tls_stream));
-        ws.set_option(websocket::stream_base::decorator([](websocket::request_type &req)
-                                                        { req.set(boost::beast::http::field::user_agent, std::string("TradePulse/1.0")); }));
-        ws.handshake(host, "/");
-
-        auto sub = build_subscribe_message(symbol_);
-        ws.write(boost::asio::buffer(sub));
-
-        boost::beast::flat_buffer buffer;
-        while (running_)
+        order_.emplace_back(trade_id, n);
+    }
+    if (numeric_ids)
+        std::sort(order_.begin(), order_.end());
+    else if (trades.size() > 1 && trades.front().time_ms > trades.back().time_ms)
+        std::reverse(order_.begin(), order_.end());
+    for (const auto &[trade_id, index] : order_)
+    {
+        const CoinbaseTrade &trade = trades[index];
+        if (!(trade.price > 0.0))
+            continue;
+        if (!trade.product_id.empty())
+            tick.symbol.assign(trade.product_id.data(), trade.product_id.size());
+        // A resubscribe snapshot overlaps what was already delivered, so its trades at or below the
+        // product's high-water mark are skipped; updates are always emitted and only raise the mark
+        if (trade_id >= 0)
         {
-            buffer.clear();
-            ws.read(buffer);
-            auto msg = boost::beast::buffers_to_string(buffer.data());
-            auto now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
-            if (msg.find("\"channel\":\"market_trades\"") == std::string::npos)
-                continue;
-            size_t pos = 0;
-            int emitted = 0;
-            while (true)
+            auto it = last_trade_id_.find(tick.symbol);
+            if (it == last_trade_id_.end())
+                it = last_trade_id_.emplace(tick.symbol, trade_id).first;
+            else if (message.snapshot && trade_id <= it->second)
             {
-                size_t ppos = msg.find("\"price\":\"", pos);
-                if (ppos == std::string::npos)
-                    break;
-                size_t pend = msg.find('"', ppos + 9);
-                if (pend == std::string::npos)
-                    break;
-                std::string price_str = msg.substr(ppos + 9, pend - (ppos + 9));
-                size_t spos = msg.find("\"size\":\"", pend);
-                if (spos == std::string::npos)
-                {
-                    pos = pend + 1;
-                    continue;
-                }
-                size_t send = msg.find('"', spos + 8);
-                if (send == std::string::npos)
-                {
-                    pos = spos + 1;
-                    continue;
-                }
-                std::string size_str = msg.substr(spos + 8, send - (spos + 8));
-                // try to extract exchange nanosecond timestamp and convert to ms
-                int64_t exch_ms = -1;
-                size_t tpos = msg.find("\"time\":\"", send);
-                if (tpos != std::string::npos)
-                {
-                    size_t tend = msg.find('"', tpos + 8);
-                    if (tend != std::string::npos)
-                    {
-                        std::string tstr = msg.substr(tpos + 8, tend - (tpos + 8));
-                        if (tstr.size() >= 13)
-                        {
-                            exch_ms = std::atoll(tstr.substr(0, 13).c_str());
-                        }
-                    }
-                }
-                double price = std::atof(price_str.c_str());
-                double size = std::atof(size_str.c_str());
-                if (price > 0.0)
-                {
-                    MarketTick tick{};
-                    tick.venue = "COINBASE";
-                    tick.symbol = symbol_;
-                    tick.price = price;
-                    tick.size = size;
-                    tick.exchange_recv_ts_ms = exch_ms;
-                    tick.ingest_ts_ms = now_ms;
-                    if (on_tick_)
-                        on_tick_(tick);
-                    emitted++;
-                }
-                pos = send + 1;
-                if (emitted >= 10)
-                    break;
+                duplicates_.fetch_add(1, std::memory_order_relaxed);
+                continue;
             }
+            else
+                it->second = std::max(it->second, trade_id);
         }
-        ws.close(websocket::close_code::normal);
-    }
-    catch (...)
-    {
+        tick.price = trade.price;
+        tick.size = trade.size;
+        tick.exchange_recv_ts_ms = trade.time_ms;
+        tick.ingest_ts_ms = now_ms;
+        tick.ingest_ns = steadyNowNs();
+        trades_.fetch_add(1, std::memory_order_relaxed);
+        if (on_tick_)
+            on_tick_(tick);
     }
 }
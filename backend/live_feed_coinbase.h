@@ -1,22 +1,80 @@
 #pragma once
 
 #include "data_source.h"
+#include "coinbase_parser.h"
 #include <string>
 #include <atomic>
+#include <memory>
 #include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
+struct CoinbaseFeedConfig
+{
+    std::string host{"advanced-trade-ws.coinbase.com"};
+    std::string port{"443"};
+    std::string target{"/"};
+    std::vector<std::string> products{"BTC-USD"};
+    // Products are spread round-robin over this many connections
+    int connections{1};
+    // Reconnect delay doubles from backoff_initial_ms up to backoff_max_ms, with +-20% jitter
+    int backoff_initial_ms{250};
+    int backoff_max_ms{30000};
+    // Verify the server against this CA bundle; empty keeps the previous no-verification behaviour
+    std::string ca_file;
+};
+
+// Coinbase Advanced Trade market_trades feed on Asio async Beast: one io thread drives every
+// connection, so nothing blocks and stop() returns within a second even mid-read. Each
+// connection subscribes its share of the products (plus heartbeats, which keep the subscription
+// alive) and reconnects with backoff on any error or idle timeout, then resubscribes. The
+// per-connection sequence_num is checked for gaps; the snapshot sent on each subscribe refills
+// a gap, and snapshot trades already emitted (by trade_id per product) are skipped so nothing is
+// delivered twice. Ticks carry venue COINBASE and the product as symbol; downstream state is kept
+// per (venue, symbol), so products never share a price series.
 class LiveFeedCoinbase : public IDataSource
 {
 public:
     explicit LiveFeedCoinbase(const std::string &symbol);
+    explicit LiveFeedCoinbase(const CoinbaseFeedConfig &cfg);
     ~LiveFeedCoinbase();
     void start(std::function<void(const MarketTick &)> on_tick) override;
     void stop() override;
 
+    uint64_t getMessages() const { return messages_.load(std::memory_order_relaxed); }
+    uint64_t getTrades() const { return trades_.load(std::memory_order_relaxed); }
+    uint64_t getReconnects() const { return reconnects_.load(std::memory_order_relaxed); }
+    // Sequence numbers skipped, summed over connections
+    uint64_t getSequenceGaps() const { return sequence_gaps_.load(std::memory_order_relaxed); }
+    // Snapshot trades not re-emitted because they were already delivered
+    uint64_t getDuplicates() const { return duplicates_.load(std::memory_order_relaxed); }
+    int getConnected() const { return connected_.load(std::memory_order_relaxed); }
+
+    // wss://host[:port][/path] into cfg's host, port and target
+    static bool parseUrl(const std::string &url, CoinbaseFeedConfig &cfg);
+
 private:
-    void run();
-    std::string symbol_;
+    friend class CoinbaseConnection;
+    struct Session;
+
+    // Every new trade of a market_trades message as a tick, in trade_id order (io thread)
+    void emitTrades(const CoinbaseMessage &message, MarketTick &tick, int64_t now_ms);
+
+    CoinbaseFeedConfig cfg_;
+    std::unique_ptr<Session> session_;
     std::atomic<bool> running_{false};
     std::thread thread_;
     std::function<void(const MarketTick &)> on_tick_;
+    // Highest trade_id emitted per product (io thread only)
+    std::unordered_map<std::string, int64_t> last_trade_id_;
+    // (numeric trade_id or -1, index) of the batch being emitted, reused across messages
+    std::vector<std::pair<int64_t, size_t>> order_;
+
+    std::atomic<uint64_t> messages_{0};
+    std::atomic<uint64_t> trades_{0};
+    std::atomic<uint64_t> reconnects_{0};
+    std::atomic<uint64_t> sequence_gaps_{0};
+    std::atomic<uint64_t> duplicates_{0};
+    std::atomic<int> connected_{0};
 };
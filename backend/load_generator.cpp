@@ -0,0 +1,133 @@
+#include "load_generator.h"
+#include "trace.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+static constexpr double SECONDS_PER_YEAR = 365.0 * 24 * 3600;
+
+LoadGenerator::LoadGenerator(const LoadGeneratorConfig &cfg) : cfg_(cfg), rng_(cfg.seed)
+{
+    cfg_.symbols = std::max(1, cfg_.symbols);
+    cfg_.venues = std::max(1, cfg_.venues);
+    for (int s = 0; s < cfg_.symbols; ++s)
+    {
+        // Spread starting prices so symbols are told apart at a glance
+        double start_price = 100.0 * (1 + s);
+        for (int v = 0; v < cfg_.venues; ++v)
+            instruments_.push_back({"LOAD" + std::to_string(v), "SYM" + std::to_string(s), std::log(start_price), 0.0});
+    }
+
+    // Each instrument is visited once per round, so its model time step is one round
+    double tick_seconds = cfg_.ticks_per_sec > 0 ? 1.0 / cfg_.ticks_per_sec : 0.001;
+    double dt = tick_seconds * static_cast<double>(instruments_.size()) / SECONDS_PER_YEAR;
+    step_mean_ = (cfg_.drift - 0.5 * cfg_.volatility * cfg_.volatility) * dt;
+    step_stddev_ = cfg_.volatility * std::sqrt(dt);
+    jump_prob_ = cfg_.model == PriceModel::JUMP ? cfg_.jump_rate * tick_seconds * static_cast<double>(instruments_.size()) : 0.0;
+    size_innovation_ = std::sqrt(std::max(0.0, 1.0 - cfg_.size_persistence * cfg_.size_persistence));
+}
+
+LoadGenerator::~LoadGenerator()
+{
+    stop();
+}
+
+bool LoadGenerator::parseModel(const std::string &name, PriceModel &model)
+{
+    if (name == "gbm")
+        model = PriceModel::GBM;
+    else if (name == "jump")
+        model = PriceModel::JUMP;
+    else
+        return false;
+    return true;
+}
+
+void LoadGenerator::start(std::function<void(const MarketTick &)> on_tick)
+{
+    if (running_)
+        return;
+    on_tick_ = on_tick;
+    running_ = true;
+    thread_ = std::thread(&LoadGenerator::run, this);
+}
+
+void LoadGenerator::stop()
+{
+    if (!running_)
+        return;
+    running_ = false;
+    if (thread_.joinable())
+        thread_.join();
+}
+
+void LoadGenerator::generate(MarketTick *out, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        Instrument &inst = instruments_[next_];
+        next_ = next_ + 1 == instruments_.size() ? 0 : next_ + 1;
+
+        double z = normal_(rng_);
+        double step = step_mean_ + step_stddev_ * z;
+        if (jump_prob_ > 0.0 && uniform_(rng_) < jump_prob_)
+            step += cfg_.jump_mean + cfg_.jump_stddev * normal_(rng_);
+        inst.log_price += step;
+
+        // Busy, volatile ticks trade larger: persistence plus a pull from |z|
+        inst.size_state = cfg_.size_persistence * inst.size_state + size_innovation_ * normal_(rng_);
+        double log_size = cfg_.size_sigma * inst.size_state + cfg_.size_return_beta * (std::fabs(z) - 0.7979);
+
+        MarketTick &tick = out[i];
+        tick.venue = inst.venue;
+        tick.symbol = inst.symbol;
+        tick.price = std::exp(inst.log_price);
+        tick.size = cfg_.size_median * std::exp(log_size);
+        tick.exchange_recv_ts_ms = -1;
+    }
+}
+
+void LoadGenerator::run()
+{
+    setTraceThreadName("feed");
+    // Batches of about 1 ms of load, so pacing costs one sleep per millisecond at most
+    size_t batch_size = cfg_.ticks_per_sec > 0 ? static_cast<size_t>(std::clamp(cfg_.ticks_per_sec / 1000.0, 1.0, double(MAX_BATCH_TICKS)))
+                                               : MAX_BATCH_TICKS;
+    std::vector<MarketTick> batch(batch_size);
+    auto started = std::chrono::steady_clock::now();
+    uint64_t sent = 0;
+
+    while (running_)
+    {
+        size_t n = batch_size;
+        if (cfg_.max_ticks > 0)
+        {
+            uint64_t left = static_cast<uint64_t>(cfg_.max_ticks) - sent;
+            if (left == 0)
+                break;
+            n = static_cast<size_t>(std::min<uint64_t>(n, left));
+        }
+        generate(batch.data(), n);
+        auto now = std::chrono::time_point_cast<std::chrono::milliseconds>(std::chrono::system_clock::now());
+        int64_t ingest_ts_ms = now.time_since_epoch().count();
+        for (size_t i = 0; i < n; ++i)
+        {
+            MarketTick &tick = batch[i];
+            tick.ingest_ts_ms = ingest_ts_ms;
+            tick.ingest_ns = steadyNowNs();
+            if (on_tick_)
+                on_tick_(tick);
+        }
+        sent += n;
+        generated_.store(sent, std::memory_order_relaxed);
+
+        // Absolute schedule: a slow batch is made up by not sleeping, not by drifting
+        if (cfg_.ticks_per_sec > 0)
+        {
+            auto due = started + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                     std::chrono::duration<double>(static_cast<double>(sent) / cfg_.ticks_per_sec));
+            if (due > std::chrono::steady_clock::now())
+                std::this_thread::sleep_until(due);
+        }
+    }
+}
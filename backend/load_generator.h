@@ -0,0 +1,90 @@
+#pragma once
+
+#include "data_source.h"
+#include <atomic>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+enum class PriceModel
+{
+    GBM,  // geometric Brownian motion
+    JUMP, // GBM plus Poisson-arriving normal log jumps (Merton)
+};
+
+struct LoadGeneratorConfig
+{
+    int symbols{8};
+    int venues{4};
+    double ticks_per_sec{100000.0}; // 0 = as fast as the consumer takes them
+    int64_t max_ticks{0};           // stop after this many (0 = until stopped)
+    PriceModel model{PriceModel::GBM};
+    uint64_t seed{42};
+    // Annualised drift and volatility; one tick advances its instrument by 1 / ticks_per_sec
+    // seconds of model time (1 ms when unpaced)
+    double drift{0.0};
+    double volatility{0.8};
+    // Jump model: expected jumps per instrument per model second, log jump mean and stddev
+    double jump_rate{0.5};
+    double jump_mean{0.0};
+    double jump_stddev{0.02};
+    // Trade sizes are lognormal around size_median; the log size is AR(1) with coefficient
+    // size_persistence and rises with the size of the tick's return (size_return_beta per sigma)
+    double size_median{1.0};
+    double size_sigma{0.8};
+    double size_persistence{0.7};
+    double size_return_beta{0.4};
+};
+
+// Deterministic load source: symbols x venues instruments, each with its own price path, emitted
+// round-robin in batches. A batch is generated into a preallocated buffer, delivered, and then
+// the thread sleeps until the batch's slot in the schedule; there is no sleep or allocation per
+// tick, so rates in the millions per second are limited only by the consumer. The same seed and
+// config always produce the same sequence of (venue, symbol, price, size).
+class LoadGenerator : public IDataSource
+{
+public:
+    explicit LoadGenerator(const LoadGeneratorConfig &cfg);
+    ~LoadGenerator();
+
+    void start(std::function<void(const MarketTick &)> on_tick) override;
+    void stop() override;
+
+    uint64_t getTicksGenerated() const { return generated_.load(std::memory_order_relaxed); }
+
+    static bool parseModel(const std::string &name, PriceModel &model);
+
+private:
+    struct Instrument
+    {
+        std::string venue;
+        std::string symbol;
+        double log_price;
+        double size_state; // AR(1) log-size factor
+    };
+
+    void run();
+    // Fills `count` ticks (everything but the ingest stamps), advancing the model
+    void generate(MarketTick *out, size_t count);
+
+    LoadGeneratorConfig cfg_;
+    std::vector<Instrument> instruments_;
+    size_t next_{0};
+    std::mt19937_64 rng_;
+    std::normal_distribution<double> normal_{0.0, 1.0};
+    std::uniform_real_distribution<double> uniform_{0.0, 1.0};
+    // Per-tick constants of the price and size models
+    double step_mean_{0.0};
+    double step_stddev_{0.0};
+    double jump_prob_{0.0};
+    double size_innovation_{0.0};
+
+    std::function<void(const MarketTick &)> on_tick_;
+    std::atomic<uint64_t> generated_{0};
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+
+    static constexpr size_t MAX_BATCH_TICKS = 4096;
+};
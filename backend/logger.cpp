@@ -0,0 +1,247 @@
+#include "logger.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <iostream>
+#include <unistd.h>
+#include <vector>
+
+template <size_t N>
+static void copy_field(char (&dst)[N], const FixedString<N> &src)
+{
+    std::memcpy(dst, src.data, N);
+}
+
+template <size_t N>
+static void copy_field(char (&dst)[N], const std::string &src)
+{
+    size_t n = std::min(src.size(), N - 1);
+    std::memcpy(dst, src.data(), n);
+    dst[n] = '\0';
+}
+
+static int64_t wallNowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+bool parseLogLevel(const std::string &text, LogLevel &level)
+{
+    static const std::pair<const char *, LogLevel> levels[] = {
+        {"debug", LogLevel::DEBUG}, {"info", LogLevel::INFO}, {"warn", LogLevel::WARN}, {"error", LogLevel::ERROR}, {"off", LogLevel::OFF}};
+    for (const auto &entry : levels)
+    {
+        if (text == entry.first)
+        {
+            level = entry.second;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char *logLevelName(LogLevel level)
+{
+    switch (level)
+    {
+    case LogLevel::DEBUG:
+        return "DEBUG";
+    case LogLevel::INFO:
+        return "INFO";
+    case LogLevel::WARN:
+        return "WARN";
+    case LogLevel::ERROR:
+        return "ERROR";
+    default:
+        return "OFF";
+    }
+}
+
+Logger::Logger(const std::string &path, LogLevel level, int max_per_sec, size_t queue_capacity)
+    : path_(path), fd_(-1), level_(level), max_per_sec_(max_per_sec), queue_(queue_capacity), window_(0),
+      window_count_(0), rate_limited_(0), queue_full_(0), dropped_total_(0), records_written_(0), running_(false)
+{
+}
+
+Logger::~Logger()
+{
+    stop();
+}
+
+bool Logger::start()
+{
+    if (running_)
+        return true;
+    if (path_.empty())
+        fd_ = STDOUT_FILENO;
+    else
+    {
+        fd_ = ::open(path_.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+        if (fd_ < 0)
+        {
+            std::cerr << "Failed to open log file " << path_ << std::endl;
+            return false;
+        }
+    }
+    running_ = true;
+    writer_thread_ = std::thread(&Logger::run, this);
+    return true;
+}
+
+void Logger::stop()
+{
+    if (!running_)
+        return;
+    running_ = false;
+    if (writer_thread_.joinable())
+        writer_thread_.join();
+    if (fd_ != STDOUT_FILENO)
+        ::close(fd_);
+    fd_ = -1;
+}
+
+bool Logger::admit(LogLevel level)
+{
+    if (!running_ || !enabled(level))
+        return false;
+    if (max_per_sec_ <= 0)
+        return true;
+    int64_t window = steadyNowNs() / 1000000000;
+    int64_t current = window_.load(std::memory_order_relaxed);
+    // Whoever moves the window resets the count; racing producers may let a few extra through
+    if (window != current && window_.compare_exchange_strong(current, window, std::memory_order_relaxed))
+        window_count_.store(0, std::memory_order_relaxed);
+    if (window_count_.fetch_add(1, std::memory_order_relaxed) < max_per_sec_)
+        return true;
+    rate_limited_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+void Logger::push(const LogRecord &record)
+{
+    // Unlike the journal, log lines are not worth stalling the trade path for
+    if (!queue_.tryPush(record))
+        queue_full_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Logger::logTrade(const Trade &trade, const std::string &strategy)
+{
+    if (!admit(LogLevel::INFO))
+        return;
+    LogRecord rec{};
+    rec.ts_ns = wallNowNs();
+    rec.event = LogEvent::TRADE;
+    rec.level = LogLevel::INFO;
+    rec.side = trade.side == OrderSide::BUY ? 0 : 1;
+    rec.quantity = trade.quantity;
+    rec.price = trade.price;
+    rec.value = trade.pnl;
+    rec.id = trade.id;
+    copy_field(rec.venue, trade.venue);
+    copy_field(rec.symbol, trade.symbol);
+    copy_field(rec.strategy, strategy);
+    push(rec);
+}
+
+void Logger::logLatency(const VenueId &venue, double latency_ms)
+{
+    if (!admit(LogLevel::DEBUG))
+        return;
+    LogRecord rec{};
+    rec.ts_ns = wallNowNs();
+    rec.event = LogEvent::LATENCY;
+    rec.level = LogLevel::DEBUG;
+    rec.value = latency_ms;
+    copy_field(rec.venue, venue);
+    push(rec);
+}
+
+void Logger::writeAll(const char *data, size_t size)
+{
+    size_t off = 0;
+    while (off < size)
+    {
+        ssize_t n = ::write(fd_, data + off, size - off);
+        if (n <= 0)
+            return;
+        off += static_cast<size_t>(n);
+    }
+}
+
+// "2026-01-02T03:04:05.123456Z"
+static size_t formatTime(int64_t ts_ns, char *out, size_t size)
+{
+    time_t secs = static_cast<time_t>(ts_ns / 1000000000);
+    struct tm tm_utc;
+    gmtime_r(&secs, &tm_utc);
+    size_t n = std::strftime(out, size, "%Y-%m-%dT%H:%M:%S", &tm_utc);
+    return n + std::snprintf(out + n, size - n, ".%06lldZ", static_cast<long long>(ts_ns % 1000000000 / 1000));
+}
+
+static size_t formatRecord(const LogRecord &rec, char *out, size_t size)
+{
+    size_t n = formatTime(rec.ts_ns, out, size);
+    int written = 0;
+    if (rec.event == LogEvent::TRADE)
+        written = std::snprintf(out + n, size - n,
+                                " %s trade strategy=%.24s side=%s venue=%.16s symbol=%.24s qty=%d price=%.2f pnl=%.2f id=T%llu\n",
+                                logLevelName(rec.level), rec.strategy, rec.side == 0 ? "BUY" : "SELL", rec.venue, rec.symbol,
+                                rec.quantity, rec.price, rec.value, static_cast<unsigned long long>(rec.id));
+    else
+        written = std::snprintf(out + n, size - n, " %s latency venue=%.16s latency_ms=%.3f\n", logLevelName(rec.level), rec.venue,
+                                rec.value);
+    return written > 0 ? std::min(n + static_cast<size_t>(written), size - 1) : n;
+}
+
+void Logger::run()
+{
+    std::vector<char> batch(WRITE_BATCH_BYTES);
+    char line[512];
+    LogRecord rec;
+    auto last_report = std::chrono::steady_clock::now();
+
+    for (;;)
+    {
+        bool stopping = !running_;
+        size_t used = 0;
+        // Leaves room for the drop summary line
+        while (used + 2 * sizeof(line) <= batch.size() && queue_.tryPop(rec))
+        {
+            size_t n = formatRecord(rec, line, sizeof(line));
+            std::memcpy(batch.data() + used, line, n);
+            used += n;
+            records_written_.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // Drops are summarised at most once a second
+        auto now = std::chrono::steady_clock::now();
+        uint64_t limited = 0, full = 0;
+        if (stopping || now - last_report >= std::chrono::seconds(1))
+        {
+            limited = rate_limited_.exchange(0, std::memory_order_relaxed);
+            full = queue_full_.exchange(0, std::memory_order_relaxed);
+            last_report = now;
+        }
+        if (limited + full > 0)
+        {
+            dropped_total_.fetch_add(limited + full, std::memory_order_relaxed);
+            size_t n = formatTime(wallNowNs(), line, sizeof(line));
+            int written = std::snprintf(line + n, sizeof(line) - n, " WARN log dropped rate_limited=%llu queue_full=%llu\n",
+                                        static_cast<unsigned long long>(limited), static_cast<unsigned long long>(full));
+            n = std::min(n + static_cast<size_t>(std::max(written, 0)), sizeof(line) - 1);
+            std::memcpy(batch.data() + used, line, n);
+            used += n;
+        }
+
+        if (used > 0)
+            writeAll(batch.data(), used);
+
+        if (stopping && queue_.sizeApprox() == 0)
+            break;
+        if (queue_.sizeApprox() == 0)
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+}
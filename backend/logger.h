@@ -0,0 +1,95 @@
+#pragma once
+
+#include "order_book.h"
+#include "lockfree_queue.h"
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+enum class LogLevel : uint8_t
+{
+    DEBUG,
+    INFO,
+    WARN,
+    ERROR,
+    OFF
+};
+
+bool parseLogLevel(const std::string &text, LogLevel &level);
+const char *logLevelName(LogLevel level);
+
+enum class LogEvent : uint8_t
+{
+    TRADE = 1,
+    LATENCY = 2
+};
+
+// Fixed-size record; the writer thread turns it into text, so producers only copy fields
+struct LogRecord
+{
+    int64_t ts_ns; // wall clock
+    LogEvent event;
+    LogLevel level;
+    uint8_t side; // 0 = BUY, 1 = SELL
+    uint8_t reserved;
+    int32_t quantity;
+    double price;
+    double value; // trade: pnl; latency: modelled latency in ms
+    uint64_t id;
+    char venue[16];
+    char symbol[24];
+    char strategy[24];
+    uint8_t reserved2[24];
+};
+
+static_assert(sizeof(LogRecord) == 128, "log record layout changed");
+
+// Asynchronous structured log for the trade and order paths. Producers filter on level, pass a
+// per-second rate limit and push a LogRecord into a lock-free ring; they never format, lock or
+// touch the output. A writer thread formats records as key=value lines and writes them in
+// batches. Records over the rate limit or arriving while the ring is full are counted and
+// reported as one summary line instead of being written.
+class Logger
+{
+public:
+    // Empty path writes to stdout; max_per_sec 0 disables the rate limit
+    explicit Logger(const std::string &path = "", LogLevel level = LogLevel::INFO, int max_per_sec = 1000,
+                    size_t queue_capacity = 16384);
+    ~Logger();
+
+    bool start();
+    void stop();
+
+    void setLevel(LogLevel level) { level_.store(level, std::memory_order_relaxed); }
+    bool enabled(LogLevel level) const { return level >= level_.load(std::memory_order_relaxed); }
+
+    void logTrade(const Trade &trade, const std::string &strategy);
+    void logLatency(const VenueId &venue, double latency_ms);
+
+    uint64_t getRecordsWritten() const { return records_written_.load(std::memory_order_relaxed); }
+    uint64_t getDropped() const { return dropped_total_.load(std::memory_order_relaxed); }
+
+private:
+    bool admit(LogLevel level);
+    void push(const LogRecord &record);
+    void run();
+    void writeAll(const char *data, size_t size);
+
+    std::string path_;
+    int fd_;
+    std::atomic<LogLevel> level_;
+    int max_per_sec_;
+    BoundedQueue<LogRecord> queue_;
+    // Rate limit: fixed one-second windows of steady time
+    std::atomic<int64_t> window_;
+    std::atomic<int> window_count_;
+    std::atomic<uint64_t> rate_limited_;
+    std::atomic<uint64_t> queue_full_;
+    std::atomic<uint64_t> dropped_total_;
+    std::atomic<uint64_t> records_written_;
+    std::atomic<bool> running_;
+    std::thread writer_thread_;
+
+    static constexpr size_t WRITE_BATCH_BYTES = 64 * 1024;
+};
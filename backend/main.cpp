@@ -8,17 +8,27 @@
 #include "market_feed.h"
 #include "data_source.h"
 #include "order_book.h"
-#include "strategies/strategy_momentum.h"
-#include "strategies/strategy_mean_reversion.h"
-#include "strategies/strategy_breakout.h"
-#include "strategies/strategy_vwap_reversion.h"
-#include "strategies/strategy_macd.h"
-#include "strategies/strategy_rsi.h"
+#include "strategies/strategy_factory.h"
+#include "strategy_slot.h"
+#include "bars.h"
+#include "latency_histogram.h"
+#include "trace.h"
 #include "latency.h"
+#include "risk.h"
+#include "snapshot.h"
+#include "journal.h"
+#include "logger.h"
+#include "metrics.h"
+#include "sharded_engine.h"
+#include "strategy_group.h"
+#include "pipeline.h"
 #include "websocket_server.h"
 #include "config.h"
 #include "replay_feed.h"
 #include "live_feed_coinbase.h"
+#include "load_generator.h"
+#include "tick_recorder.h"
+#include "tick_store.h"
 
 // Global flag for graceful shutdown
 std::atomic<bool> g_shutdown(false);
@@ -48,30 +58,106 @@ int main(int argc, char **argv)
     try
     {
         Config cfg = parseArgs(argc, argv);
+        setTracingEnabled(cfg.trace);
+        // Snapshots cover the main book only; shard lanes and group members keep their own books
+        if (!cfg.snapshot_file.empty() && (cfg.shards > 0 || !cfg.strategy_group.empty()))
+        {
+            std::cerr << "--snapshot_file cannot be combined with --shards or --strategies: positions live in the "
+                         "per-symbol or per-strategy books, which snapshots do not cover"
+                      << std::endl;
+            return 1;
+        }
 
         // Initialize components
         OrderBook order_book;
+        // Journal epoch of this run; snapshots record it, so a restore replays only later fills
+        uint64_t run_epoch = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+        uint64_t restored_epoch = 0; // epoch of the snapshot the book was restored from
+        bool restored = false;
+        if (cfg.restore_snapshot)
+        {
+            auto restore_start = std::chrono::steady_clock::now();
+            if (cfg.snapshot_file.empty())
+                std::cerr << "--restore_snapshot requires --snapshot_file" << std::endl;
+            else if ((restored = SnapshotWriter::restore(order_book, cfg.snapshot_file, &restored_epoch)))
+                std::cout << "Restored snapshot " << cfg.snapshot_file << " (" << order_book.getTradeCount() << " trades, PnL: $"
+                          << order_book.getTotalPnL() << ") in "
+                          << std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - restore_start).count()
+                          << "us" << std::endl;
+            else
+                std::cerr << "Failed to restore snapshot " << cfg.snapshot_file << std::endl;
+            // Roll forward with any fills journaled after the snapshot was taken (a failed restore
+            // starts empty: this run is a fresh history, not a continuation)
+            if (!cfg.journal_file.empty() && restored)
+            {
+                int applied = Journal::replayInto(cfg.journal_file, order_book, restored_epoch);
+                if (applied > 0)
+                    std::cout << "Replayed " << applied << " journaled fills" << std::endl;
+            }
+        }
+        std::unique_ptr<Journal> journal;
+        if (!cfg.journal_file.empty())
+        {
+            journal = std::make_unique<Journal>(cfg.journal_file, run_epoch, restored_epoch, cfg.journal_sync_ms);
+            if (!journal->start())
+                journal.reset();
+        }
+        // Trade and order lines go through the async logger instead of std::cout on the hot path
+        LogLevel log_level = LogLevel::INFO;
+        if (!parseLogLevel(cfg.log_level, log_level))
+            std::cerr << "Invalid log level: " << cfg.log_level << " (expected debug, info, warn, error or off)" << std::endl;
+        Logger logger(cfg.log_file, log_level, cfg.log_rate);
+        logger.start();
+        std::unique_ptr<TickRecorder> recorder;
+        if (!cfg.record_file.empty())
+        {
+            TickRecordFormat record_format = TickRecordFormat::NDJSON;
+            if (!TickRecorder::parseFormat(cfg.record_format, record_format))
+                std::cerr << "Invalid record format: " << cfg.record_format << " (expected ndjson, binary or archive)" << std::endl;
+            recorder = std::make_unique<TickRecorder>(cfg.record_file, record_format,
+                                                      static_cast<uint64_t>(std::max(0, cfg.record_rotate_mb)) << 20);
+            if (!recorder->start())
+                recorder.reset();
+        }
+        std::unique_ptr<SnapshotWriter> snapshot_writer;
+        if (!cfg.snapshot_file.empty() && cfg.snapshot_interval_ms > 0)
+            snapshot_writer = std::make_unique<SnapshotWriter>(order_book, cfg.snapshot_file, cfg.snapshot_interval_ms, run_epoch);
         MarketFeed synth_feed;
-        MomentumStrategy momentum(order_book);
-        MeanReversionStrategy meanrev(order_book);
-        BreakoutStrategy breakout(order_book);
-        VwapReversionStrategy vwap(order_book);
-        MacdStrategy macd(order_book);
-        RsiStrategy rsi(order_book);
-        IStrategy *strategy = &momentum;
-        if (cfg.strategy == std::string("mean_reversion"))
-            strategy = &meanrev;
-        else if (cfg.strategy == std::string("breakout"))
-            strategy = &breakout;
-        else if (cfg.strategy == std::string("vwap_reversion"))
-            strategy = &vwap;
-        else if (cfg.strategy == std::string("macd"))
-            strategy = &macd;
-        else if (cfg.strategy == std::string("rsi"))
-            strategy = &rsi;
-        strategy->setLookback(cfg.strategy_lookback);
-        strategy->setOrderQuantity(cfg.strategy_order_qty);
+        int replay_threads = cfg.replay_threads > 0 ? cfg.replay_threads : std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+        LoadGeneratorConfig load_cfg;
+        load_cfg.symbols = cfg.load_symbols;
+        load_cfg.venues = cfg.load_venues;
+        load_cfg.ticks_per_sec = cfg.load_rate;
+        load_cfg.max_ticks = cfg.load_ticks;
+        load_cfg.seed = cfg.load_seed;
+        if (!LoadGenerator::parseModel(cfg.load_model, load_cfg.model))
+            std::cerr << "Invalid load model: " << cfg.load_model << " (expected gbm or jump)" << std::endl;
+        CoinbaseFeedConfig feed_cfg;
+        if (!LiveFeedCoinbase::parseUrl(cfg.feed_url, feed_cfg))
+            std::cerr << "Invalid feed URL: " << cfg.feed_url << " (expected wss://host[:port][/path])" << std::endl;
+        feed_cfg.connections = std::max(1, cfg.feed_connections);
+        feed_cfg.ca_file = cfg.feed_ca;
+        std::unique_ptr<IStrategy> initial_strategy = makeStrategy(cfg.strategy, order_book);
+        if (!initial_strategy)
+        {
+            cfg.strategy = "momentum";
+            initial_strategy = makeStrategy(cfg.strategy, order_book);
+        }
+        initial_strategy->setLookback(cfg.strategy_lookback);
+        initial_strategy->setOrderQuantity(cfg.strategy_order_qty);
+        // Active strategy on the single-book path; /control swaps and retunes it without stopping the feed
+        StrategySlot strategy_slot;
         LatencySimulator latency_simulator;
+        RiskLimits risk_limits;
+        risk_limits.max_position = cfg.risk_max_position;
+        risk_limits.max_notional = cfg.risk_max_notional;
+        risk_limits.max_orders_per_sec = cfg.risk_max_orders_per_sec;
+        risk_limits.price_band_pct = cfg.risk_price_band_pct;
+        RiskGate risk_gate;
+        risk_gate.setDefaultLimits(risk_limits);
+        for (const auto &kv : order_book.getPositions())
+            risk_gate.setPosition(kv.first, kv.second);
         WebSocketServer websocket_server(8080);
 
         // Setup WebSocket server callbacks
@@ -83,20 +169,234 @@ int main(int argc, char **argv)
 
         std::unique_ptr<IDataSource> dynamic_source;
         IDataSource *source_ptr = nullptr;
+        // The running replay, for the /control replay actions; null for other sources
+        ReplayFeed *replay_feed = nullptr;
+        // The running live feed, for its /metrics counters; null for other sources
+        LiveFeedCoinbase *live_feed = nullptr;
+        auto make_live = [&]() -> std::unique_ptr<IDataSource>
+        {
+            feed_cfg.products = cfg.products.empty() ? std::vector<std::string>{cfg.symbol} : cfg.products;
+            auto feed = std::make_unique<LiveFeedCoinbase>(feed_cfg);
+            live_feed = feed.get();
+            return feed;
+        };
+        auto make_replay = [&]() -> std::unique_ptr<IDataSource>
+        {
+            auto feed = std::make_unique<ReplayFeed>(cfg.replay_file, cfg.replay_speed, replay_threads);
+            if (!cfg.replay_from.empty() && !feed->seek(cfg.replay_from))
+                std::cerr << "Invalid replay start: " << cfg.replay_from << " (expected epoch ms or HH:MM[:SS])" << std::endl;
+            replay_feed = feed.get();
+            return feed;
+        };
+        // /history reads cfg.replay_file through its own index, built on the first request
+        std::unique_ptr<TickStore> history_store;
+        std::mutex history_mutex;
+        // Each HTTP connection runs on its own thread; /control requests hold this so strategy swaps,
+        // source switches and cfg updates run one at a time
+        std::mutex control_mutex;
         bool running = false;
+        std::unique_ptr<ShardedEngine> engine;
+        std::unique_ptr<StrategyGroup> group;
+
+        // Per-stage latency histograms, filled from the steady-clock stamps on ticks, orders and trades
+        StageLatencies stage_latencies;
+
+        // /metrics counters; each label slot sits on its own cache line
+        LabeledCounter ticks_ingested;
+        LabeledCounter orders_emitted;
+        LabeledCounter fills;
+        const MetricLabel source_label(sourceTypeName(cfg.source));
+        MetricLabel engine_strategy; // set when the sharded engine is built
+        // The main book belongs to the slot (the static pipeline runs the slot's initial strategy)
+        auto book_strategy = [&](const OrderBook &book) -> MetricLabel
+        {
+            if (&book == &order_book)
+                return strategy_slot.name();
+            return group ? MetricLabel(group->strategyName(book)) : engine_strategy;
+        };
+
+        // Risk-accepted orders go through the latency gate (if modelled) into their book
+        auto execute_order = [&](OrderBook &book, const Order &order)
+        {
+            orders_emitted.add(book_strategy(book));
+            Order accepted = order;
+            accepted.accepted_ns = steadyNowNs();
+            if (journal)
+                journal->recordOrder(accepted, book.bookId());
+            if (cfg.latency_mode == LatencyMode::MEASURED)
+            {
+                book.submitOrder(accepted);
+            }
+            else
+            {
+                latency_simulator.addOrderDelay(book, accepted);
+            }
+        };
+        // Batches stay together: one latency-gate enqueue, one atomic book apply
+        auto execute_batch = [&](OrderBook &book, const Order *orders, size_t count)
+        {
+            orders_emitted.add(book_strategy(book), count);
+            Order accepted[OrderBook::MAX_BATCH_ORDERS];
+            int64_t now_ns = steadyNowNs();
+            for (size_t done = 0; done < count;)
+            {
+                size_t n = std::min(count - done, OrderBook::MAX_BATCH_ORDERS);
+                for (size_t i = 0; i < n; ++i)
+                {
+                    accepted[i] = orders[done + i];
+                    accepted[i].accepted_ns = now_ns;
+                    if (journal)
+                        journal->recordOrder(accepted[i], book.bookId());
+                }
+                if (cfg.latency_mode == LatencyMode::MEASURED)
+                    book.submitOrders(accepted, n);
+                else
+                    latency_simulator.addOrderBatch(book, accepted, n);
+                done += n;
+            }
+        };
+        using Executor = decltype(Overloaded{execute_order, execute_batch});
+
+        AnyStaticPipeline<Executor> static_pipeline;
+        StrategyParamsMailbox static_params;
+        auto active_strategy_name = [&]() -> const char *
+        {
+            return static_pipeline.active() ? static_pipeline.strategy()->name() : strategy_slot.name();
+        };
+
+        // Bar mode: raw ticks still mark positions and feed the risk gate; the strategy only
+        // sees closed bars
+        std::unique_ptr<BarAggregator> bar_aggregator;
+
+        // Every tick marks open positions before the strategy sees it
+        auto on_tick = [&](const MarketTick &tick)
+        {
+            TraceScope trace("feed_receive");
+            ticks_ingested.add(source_label);
+            if (recorder)
+                recorder->record(tick);
+            if (tick.exchange_recv_ts_ms > 0)
+                stage_latencies.record(tick.venue, LatencyStage::WIRE, (tick.ingest_ts_ms - tick.exchange_recv_ts_ms) * 1000000);
+            if (group)
+            {
+                group->onTick(tick);
+                return;
+            }
+            if (engine)
+            {
+                engine->onTick(tick);
+                return;
+            }
+            if (static_pipeline.active())
+            {
+                StrategyParams params;
+                if (static_params.take(params))
+                    StrategyParamsMailbox::apply(*static_pipeline.strategy(), params);
+                if (!bar_aggregator)
+                {
+                    static_pipeline.onTick(tick);
+                    return;
+                }
+            }
+            order_book.markToMarket(tick);
+            risk_gate.onMarketTick(tick);
+            if (!bar_aggregator)
+            {
+                strategy_slot.onTick(tick);
+                return;
+            }
+            Bar bar;
+            if (!bar_aggregator->onTick(tick, bar))
+                return;
+            if (static_pipeline.active())
+                static_pipeline.onBar(bar);
+            else
+                strategy_slot.onBar(bar);
+            websocket_server.broadcastBar(bar);
+        };
 
         websocket_server.setHttpHandler([&](const std::string &method, const std::string &path, const std::string &req) -> std::string
                                         {
             if (method == "GET" && path.rfind("/info", 0) == 0) {
                 std::ostringstream oss;
-                oss << "strategy=" << strategy->name() << "\n";
+                oss << "strategy=" << active_strategy_name() << "\n";
                 oss << "lookback=" << cfg.strategy_lookback << "\n";
                 oss << "order_qty=" << cfg.strategy_order_qty << "\n";
-                oss << "source=" << (cfg.source == SourceType::SYNTHETIC ? "synthetic" : cfg.source == SourceType::LIVE ? "live" : "replay") << "\n";
+                oss << "source=" << sourceTypeName(cfg.source) << "\n";
                 oss << "symbol=" << cfg.symbol << "\n";
+                oss << "strategy_swaps=" << strategy_slot.getSwaps() << "\n";
+                if (replay_feed) {
+                    oss << "replay_paused=" << (replay_feed->paused() ? 1 : 0) << "\n";
+                    oss << "replay_speed=" << replay_feed->speed() << "\n";
+                    oss << "replay_position_ms=" << replay_feed->position() << "\n";
+                }
                 return oss.str();
             }
+            if (method == "GET" && path.rfind("/latency", 0) == 0) {
+                // /latency?reset=1 clears the histograms after reporting them
+                std::string text = stage_latencies.statsToText();
+                if (path.find("reset=1") != std::string::npos)
+                    stage_latencies.reset();
+                return text;
+            }
+            if (method == "GET" && path.rfind("/metrics", 0) == 0) {
+                // Prometheus text exposition
+                std::ostringstream oss;
+                appendMetricHeader(oss, "tradepulse_ticks_ingested_total", "counter", "Market ticks received from the feed");
+                ticks_ingested.appendTo(oss, "tradepulse_ticks_ingested_total", "source");
+                appendMetricHeader(oss, "tradepulse_orders_emitted_total", "counter", "Risk-accepted orders sent to execution");
+                orders_emitted.appendTo(oss, "tradepulse_orders_emitted_total", "strategy");
+                appendMetricHeader(oss, "tradepulse_fills_total", "counter", "Trades applied by the order books");
+                fills.appendTo(oss, "tradepulse_fills_total", "strategy");
+                appendMetric(oss, "tradepulse_latency_queue_depth", "gauge", "Orders waiting out their modelled venue latency",
+                             latency_simulator.getPendingDepth());
+                appendMetric(oss, "tradepulse_ws_frames_sent_total", "counter", "WebSocket frames sent", websocket_server.getFramesSent());
+                appendMetric(oss, "tradepulse_ws_bytes_sent_total", "counter", "WebSocket bytes sent", websocket_server.getBytesSent());
+                appendMetric(oss, "tradepulse_ws_clients", "gauge", "Connected WebSocket clients",
+                             static_cast<uint64_t>(websocket_server.getConnectedClients()));
+                appendMetricHeader(oss, "tradepulse_dropped_total", "counter", "Messages dropped, by where they were dropped");
+                oss << "tradepulse_dropped_total{stage=\"ws_send\"} " << websocket_server.getFramesDropped() << "\n";
+                oss << "tradepulse_dropped_total{stage=\"log\"} " << logger.getDropped() << "\n";
+                oss << "tradepulse_dropped_total{stage=\"recorder\"} " << (recorder ? recorder->getDropped() : 0) << "\n";
+                oss << "tradepulse_dropped_total{stage=\"journal\"} " << (journal ? journal->getRecordsLost() : 0) << "\n";
+                oss << "tradepulse_dropped_total{stage=\"shard_queue\"} " << (engine ? engine->getDropped() : 0) << "\n";
+                oss << "tradepulse_dropped_total{stage=\"group_queue\"} " << (group ? group->getDropped() : 0) << "\n";
+                appendMetricHeader(oss, "tradepulse_ws_client_send_backlog_bytes", "gauge",
+                                   "Bytes queued in the kernel send buffer per WebSocket client");
+                for (const auto &backlog : websocket_server.getClientBacklogs())
+                    oss << "tradepulse_ws_client_send_backlog_bytes{client=\"" << backlog.first << "\"} " << backlog.second << "\n";
+                if (live_feed) {
+                    appendMetric(oss, "tradepulse_feed_messages_total", "counter", "Messages received from the live feed",
+                                 live_feed->getMessages());
+                    appendMetric(oss, "tradepulse_feed_reconnects_total", "counter", "Live feed reconnect attempts",
+                                 live_feed->getReconnects());
+                    appendMetric(oss, "tradepulse_feed_sequence_gaps_total", "counter",
+                                 "Live feed messages missed, from sequence_num gaps", live_feed->getSequenceGaps());
+                    appendMetric(oss, "tradepulse_feed_duplicate_trades_total", "counter",
+                                 "Snapshot trades skipped after a resubscribe because they were already emitted",
+                                 live_feed->getDuplicates());
+                    appendMetric(oss, "tradepulse_feed_connections", "gauge", "Live feed connections subscribed",
+                                 static_cast<uint64_t>(live_feed->getConnected()));
+                }
+                return oss.str();
+            }
+            if (method == "GET" && path.rfind("/trace", 0) == 0) {
+                // /trace?ms=N: hot-path events of the last N ms (default 1000) as Chrome trace JSON
+                size_t p = path.find("ms=");
+                int64_t window_ms = p != std::string::npos ? std::atoll(path.c_str() + p + 3) : 1000;
+                return traceToChromeJson(window_ms > 0 ? window_ms : 1000);
+            }
+            if (method == "GET" && path.rfind("/risk", 0) == 0) {
+                return risk_gate.statsToText();
+            }
+            if (method == "GET" && path.rfind("/group", 0) == 0) {
+                return group ? group->statsToText() : std::string("strategies=0\n");
+            }
+            if (method == "GET" && path.rfind("/shards", 0) == 0) {
+                return engine ? engine->statsToText() : std::string("shards=0\n");
+            }
             if (method == "GET" && path.rfind("/control", 0) == 0) {
+                std::lock_guard<std::mutex> control_lock(control_mutex);
                 auto qpos = path.find('?');
                 std::string qs = (qpos != std::string::npos) ? path.substr(qpos + 1) : std::string();
                 auto get = [&](const std::string &k) -> std::string {
@@ -113,29 +413,58 @@ int main(int argc, char **argv)
                 std::string qty = get("order_qty");
                 std::string source = get("source");
                 std::string symbol = get("symbol");
+                std::string speed = get("speed");
+                std::string to = get("to");
+
+                // Replay transport: action=pause|resume|seek (seek needs to=epoch ms or HH:MM[:SS]), speed=X
+                if (action == "pause" || action == "resume" || action == "seek" || !speed.empty()) {
+                    if (!replay_feed)
+                        return std::string("no replay running");
+                    if (!speed.empty() && !replay_feed->setSpeed(std::atof(speed.c_str())))
+                        return std::string("invalid speed");
+                    if (action == "seek" && !replay_feed->seek(to))
+                        return std::string("invalid time");
+                    if (action == "pause") replay_feed->pause();
+                    if (action == "resume") replay_feed->resume();
+                    if (!speed.empty()) cfg.replay_speed = replay_feed->speed();
+                }
 
-                if (!strat.empty()) {
-                    if (strat == "momentum") strategy = &momentum; else if (strat == "mean_reversion") strategy = &meanrev;
-                    cfg.strategy = strat;
+                // Strategy and lookback changes build a fresh instance warmed from recent ticks and swap it in on
+                // the next tick; a quantity-only change is posted to the running instance. The static pipeline's
+                // strategy is fixed, so it only takes parameter updates.
+                StrategyParams params;
+                if (!look.empty()) { cfg.strategy_lookback = std::atoi(look.c_str()); params.lookback = cfg.strategy_lookback; }
+                if (!qty.empty()) { cfg.strategy_order_qty = std::atoi(qty.c_str()); params.order_qty = cfg.strategy_order_qty; }
+                if (static_pipeline.active()) {
+                    static_params.post(params);
+                } else if (!strat.empty() || !look.empty()) {
+                    std::string name = strat.empty() ? std::string(strategy_slot.name()) : strat;
+                    std::unique_ptr<IStrategy> next = makeStrategy(name, order_book);
+                    if (!next)
+                        return std::string("unknown strategy");
+                    next->setLookback(cfg.strategy_lookback);
+                    next->setOrderQuantity(cfg.strategy_order_qty);
+                    strategy_slot.swap(std::move(next));
+                    cfg.strategy = name;
+                } else if (!qty.empty()) {
+                    strategy_slot.updateParams(params);
                 }
-                if (!look.empty()) { cfg.strategy_lookback = std::atoi(look.c_str()); strategy->setLookback(cfg.strategy_lookback); }
-                if (!qty.empty()) { cfg.strategy_order_qty = std::atoi(qty.c_str()); strategy->setOrderQuantity(cfg.strategy_order_qty); }
 
                 if (!source.empty()) {
                     if (source == "synthetic") {
                         if (!symbol.empty()) cfg.symbol = symbol;
                         synth_feed.setSymbol(cfg.symbol);
-                        if (dynamic_source) { dynamic_source->stop(); dynamic_source.reset(); }
+                        if (dynamic_source) { dynamic_source->stop(); dynamic_source.reset(); replay_feed = nullptr; live_feed = nullptr; }
                         if (source_ptr == &synth_feed) synth_feed.stop();
                         source_ptr = &synth_feed;
-                        synth_feed.start([&](const MarketTick &tick) { strategy->onMarketTick(tick); });
+                        synth_feed.start(on_tick);
                     } else if (source == "live") {
                         if (source_ptr == &synth_feed) synth_feed.stop();
-                        if (dynamic_source) { dynamic_source->stop(); dynamic_source.reset(); }
-                        if (!symbol.empty()) cfg.symbol = symbol;
-                        dynamic_source = std::make_unique<LiveFeedCoinbase>(cfg.symbol);
+                        if (dynamic_source) { dynamic_source->stop(); dynamic_source.reset(); replay_feed = nullptr; live_feed = nullptr; }
+                        if (!symbol.empty()) { cfg.symbol = symbol; cfg.products.clear(); }
+                        dynamic_source = make_live();
                         source_ptr = dynamic_source.get();
-                        dynamic_source->start([&](const MarketTick &tick) { strategy->onMarketTick(tick); });
+                        dynamic_source->start(on_tick);
                     }
                 }
                 if (action == "stop") {
@@ -146,11 +475,12 @@ int main(int argc, char **argv)
                 if (action == "start") {
                     if (!source_ptr) {
                         if (cfg.source == SourceType::SYNTHETIC) { source_ptr = &synth_feed; }
-                        else if (cfg.source == SourceType::LIVE) { dynamic_source = std::make_unique<LiveFeedCoinbase>(cfg.symbol); source_ptr = dynamic_source.get(); }
-                        else if (cfg.source == SourceType::REPLAY) { dynamic_source = std::make_unique<ReplayFeed>(cfg.replay_file, cfg.replay_speed); source_ptr = dynamic_source.get(); }
+                        else if (cfg.source == SourceType::LIVE) { dynamic_source = make_live(); source_ptr = dynamic_source.get(); }
+                        else if (cfg.source == SourceType::REPLAY) { dynamic_source = make_replay(); source_ptr = dynamic_source.get(); }
+                        else if (cfg.source == SourceType::LOAD) { dynamic_source = std::make_unique<LoadGenerator>(load_cfg); source_ptr = dynamic_source.get(); }
                     }
-                    if (source_ptr == &synth_feed) synth_feed.start([&](const MarketTick &tick) { strategy->onMarketTick(tick); });
-                    else if (dynamic_source) dynamic_source->start([&](const MarketTick &tick) { strategy->onMarketTick(tick); });
+                    if (source_ptr == &synth_feed) synth_feed.start(on_tick);
+                    else if (dynamic_source) dynamic_source->start(on_tick);
                     running = true;
                 }
 
@@ -158,60 +488,172 @@ int main(int argc, char **argv)
             }
             return ""; });
 
+        // /history?symbol=&from=&to=: recorded ticks with from <= ingest_ts_ms < to as NDJSON, streamed in
+        // chunks. from/to are epoch ms or HH:MM[:SS] on the recording's first day; symbol is optional.
+        websocket_server.addHttpStream("/history", "application/x-ndjson",
+                                       [&](const std::string &path, const std::function<bool(const std::string &)> &write) -> std::string
+                                       {
+            auto qpos = path.find('?');
+            std::string qs = (qpos != std::string::npos) ? path.substr(qpos + 1) : std::string();
+            auto get = [&](const std::string &k) -> std::string {
+                size_t p = qs.find(k + "=");
+                if (p == std::string::npos || (p > 0 && qs[p - 1] != '&')) return {};
+                size_t s = p + k.size() + 1;
+                size_t e = qs.find('&', s);
+                return qs.substr(s, e == std::string::npos ? std::string::npos : e - s);
+            };
+            const TickStore *store;
+            {
+                std::lock_guard<std::mutex> lock(history_mutex);
+                if (!history_store) {
+                    auto opened = std::make_unique<TickStore>(cfg.replay_file);
+                    if (!opened->open())
+                        return "cannot open " + cfg.replay_file;
+                    history_store = std::move(opened);
+                }
+                store = history_store.get();
+            }
+            int64_t from = store->firstTs();
+            int64_t to = store->lastTs() + 1;
+            std::string from_s = get("from"), to_s = get("to");
+            if ((!from_s.empty() && !TickStore::parseTime(from_s, store->firstTs(), from)) ||
+                (!to_s.empty() && !TickStore::parseTime(to_s, store->firstTs(), to)))
+                return "from/to must be epoch ms or HH:MM[:SS]";
+            std::string chunk;
+            bool open = true;
+            store->range(from, to, get("symbol"), [&](const MarketTick &tick)
+                         {
+                chunk += ReplayFeed::toLine(tick);
+                if (chunk.size() >= 64 * 1024) {
+                    open = write(chunk);
+                    chunk.clear();
+                }
+                return open; });
+            if (open)
+                write(chunk);
+            return ""; });
+
         synth_feed.setSymbol(cfg.symbol);
         synth_feed.setTickIntervalMs(100);
 
-        // Setup order book callback for trades
-        order_book.setTradeCallback([&](const Trade &trade)
-                                    {
+        // Trade callback shared by the main book, shard books and group members; tagged with the strategy
+        auto on_trade = [&](const Trade &trade, const std::string &strategy_name)
+        {
             // Create WebSocket message
             WebSocketMessage ws_message;
             ws_message.type = "trade";
-            ws_message.venue = trade.venue;
-            ws_message.symbol = trade.symbol;
+            ws_message.venue = trade.venue.str();
+            ws_message.symbol = trade.symbol.str();
             ws_message.price = trade.price;
             ws_message.size = trade.size;
             ws_message.action = (trade.side == OrderSide::BUY) ? "BUY" : "SELL";
             ws_message.modelled_latency_ms = latency_simulator.getVenueLatency(trade.venue);
             ws_message.timestamp = formatTimestamp(trade.timestamp);
             ws_message.pnl = trade.pnl;
-            ws_message.order_id = trade.id;
+            ws_message.order_id = "T" + std::to_string(trade.id);
             ws_message.exchange_recv_ts_ms = trade.exchange_recv_ts_ms;
             ws_message.ingest_ts_ms = trade.ingest_ts_ms;
             ws_message.order_created_ts_ms = trade.order_created_ts_ms;
             ws_message.order_executed_ts_ms = trade.order_executed_ts_ms;
             ws_message.server_broadcast_ts_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+            ws_message.strategy = strategy_name;
             
+            if (journal)
+                journal->recordTrade(trade);
+
             // Broadcast to WebSocket clients
             websocket_server.broadcastMessage(ws_message);
-            
-            std::cout << "Trade executed: " << ws_message.action 
-                      << " " << ws_message.venue 
-                      << " @ $" << ws_message.price 
-                      << " (PnL: $" << ws_message.pnl << ")" << std::endl; });
+            stage_latencies.recordTrade(trade, steadyNowNs());
+            logger.logTrade(trade, strategy_name);
+            fills.add(strategy_name);
+        };
+        order_book.setTradeCallback([&](const Trade &trade)
+                                    { on_trade(trade, active_strategy_name()); });
+        order_book.setTradeBatchCallback([&](const Trade *trades, size_t count)
+                                         {
+            for (size_t i = 0; i < count; ++i)
+                on_trade(trades[i], active_strategy_name()); });
 
-        // Strategy should not submit directly
-        strategy->on_order = [&](const Order &order)
+        // Strategy should not submit directly. The slot wires these into every instance it activates.
+        auto submit_order = [&](const Order &order)
         {
-            if (cfg.latency_mode == LatencyMode::MEASURED)
+            if (risk_gate.check(order) != RiskReject::NONE)
+                return;
+            execute_order(order_book, order);
+        };
+        // Legs rejected by risk are dropped; the accepted ones still execute as one batch
+        auto submit_batch = [&](const Order *orders, size_t count)
+        {
+            Order accepted[OrderBook::MAX_BATCH_ORDERS];
+            size_t n = 0;
+            for (size_t i = 0; i < count; ++i)
+            {
+                if (risk_gate.check(orders[i]) == RiskReject::NONE)
+                    accepted[n++] = orders[i];
+                if (n == OrderBook::MAX_BATCH_ORDERS || (i + 1 == count && n > 0))
+                {
+                    execute_batch(order_book, accepted, n);
+                    n = 0;
+                }
+            }
+        };
+        strategy_slot.setOrderCallbacks(submit_order, submit_batch);
+        strategy_slot.init(std::move(initial_strategy));
+
+        if (cfg.shards > 0 && cfg.strategy_group.empty())
+        {
+            ShardedEngineConfig engine_cfg;
+            engine_cfg.shards = cfg.shards;
+            engine_cfg.first_core = cfg.shard_first_core;
+            engine_cfg.strategy = cfg.strategy;
+            engine_cfg.strategy_lookback = cfg.strategy_lookback;
+            engine_cfg.strategy_order_qty = cfg.strategy_order_qty;
+            engine_cfg.risk_limits = risk_limits;
+            engine_strategy = cfg.strategy;
+            engine = std::make_unique<ShardedEngine>(engine_cfg, execute_order, [&](const Trade &trade)
+                                                     { on_trade(trade, cfg.strategy); });
+        }
+        if (!cfg.strategy_group.empty())
+        {
+            group = std::make_unique<StrategyGroup>(execute_order, on_trade);
+            for (const auto &name : cfg.strategy_group)
+            {
+                if (!group->addStrategy(name, cfg.strategy_lookback, cfg.strategy_order_qty, risk_limits))
+                    std::cerr << "Unknown strategy in group: " << name << std::endl;
+            }
+        }
+        if (cfg.static_pipeline && !engine && !group)
+        {
+            if (static_pipeline.emplace(cfg.strategy, order_book, risk_gate, Overloaded{execute_order, execute_batch}))
             {
-                order_book.submitOrder(order);
+                IStrategy *pipeline_strategy = static_pipeline.strategy();
+                pipeline_strategy->setLookback(cfg.strategy_lookback);
+                pipeline_strategy->setOrderQuantity(cfg.strategy_order_qty);
             }
+            else
+                std::cerr << "Unknown strategy for static pipeline: " << cfg.strategy << std::endl;
+        }
+        if (!cfg.bars.empty())
+        {
+            BarSpec bar_spec;
+            if (!parseBarSpec(cfg.bars, bar_spec))
+                std::cerr << "Invalid bar spec: " << cfg.bars << " (expected time:MS or tick:N with a whole number >= 1, or volume:V > 0)" << std::endl;
+            else if (group || engine)
+                std::cerr << "Bar mode is ignored with --strategies or --shards" << std::endl;
             else
             {
-                latency_simulator.addOrderDelay(order.id, order.venue, [&order_book, order]()
-                                                { order_book.submitOrder(order); });
+                bar_aggregator = std::make_unique<BarAggregator>(bar_spec);
+                std::cout << "Strategy driven by " << barTypeName(bar_spec.type) << " bars of " << bar_spec.size << std::endl;
             }
-        };
+        }
 
         // Setup latency simulator callback
         latency_simulator.setLatencyCallback([&](const LatencyEvent &event)
                                              {
-            std::cout << "Latency event: " << event.venue 
-                      << " - " << event.latency_ms << "ms" << std::endl;
+            logger.logLatency(event.venue, event.latency_ms);
             WebSocketMessage latency_msg;
             latency_msg.type = "latency";
-            latency_msg.venue = event.venue;
+            latency_msg.venue = event.venue.str();
             latency_msg.symbol = "";
             latency_msg.price = 0.0;
             latency_msg.size = 0.0;
@@ -231,8 +673,53 @@ int main(int argc, char **argv)
         std::cout << "Starting WebSocket server..." << std::endl;
         websocket_server.start();
 
+        // Rebuild indicator state from the recording's tail so strategies can trade on the first live tick
+        if (!cfg.warmup_file.empty())
+        {
+            std::vector<MarketTick> history = ReplayFeed::loadRecent(cfg.warmup_file, cfg.warmup_ticks);
+            if (bar_aggregator)
+            {
+                // Warm on bars built the same way as live ones; the partial last bar is dropped
+                BarAggregator warmup_bars(bar_aggregator->spec());
+                std::vector<MarketTick> bar_ticks;
+                Bar bar;
+                for (const auto &tick : history)
+                {
+                    if (warmup_bars.onTick(tick, bar))
+                        bar_ticks.push_back(barToTick(bar));
+                }
+                history.swap(bar_ticks);
+            }
+            if (group)
+                group->warmUp(history);
+            else if (engine)
+                engine->warmUp(history);
+            else if (static_pipeline.active())
+            {
+                IStrategy &pipeline_strategy = *static_pipeline.strategy();
+                IStrategy::OrderMute mute(pipeline_strategy);
+                for (const auto &tick : history)
+                    pipeline_strategy.onMarketTick(tick);
+            }
+            else
+                strategy_slot.warmUp(history);
+            std::cout << "Warmed strategies with " << history.size() << " recorded ticks from " << cfg.warmup_file << std::endl;
+        }
+
         std::cout << "Starting latency simulator..." << std::endl;
         latency_simulator.start();
+        if (snapshot_writer)
+            snapshot_writer->start();
+        if (group)
+        {
+            std::cout << "Starting strategy group of " << group->size() << "..." << std::endl;
+            group->start();
+        }
+        if (engine)
+        {
+            std::cout << "Starting " << cfg.shards << " engine shards..." << std::endl;
+            engine->start();
+        }
         for (const auto &kv : cfg.modelled_latency_ms)
         {
             latency_simulator.setVenueLatency(kv.first, kv.second);
@@ -242,38 +729,56 @@ int main(int argc, char **argv)
         if (cfg.source == SourceType::SYNTHETIC)
         {
             source_ptr = &synth_feed;
-            synth_feed.start([&](const MarketTick &tick)
-                             { strategy->onMarketTick(tick); });
+            synth_feed.start(on_tick);
         }
         else if (cfg.source == SourceType::LIVE)
         {
-            dynamic_source = std::make_unique<LiveFeedCoinbase>(cfg.symbol);
+            dynamic_source = make_live();
             source_ptr = dynamic_source.get();
-            dynamic_source->start([&](const MarketTick &tick)
-                                  { strategy->onMarketTick(tick); });
+            dynamic_source->start(on_tick);
         }
         else if (cfg.source == SourceType::REPLAY)
         {
-            dynamic_source = std::make_unique<ReplayFeed>(cfg.replay_file, cfg.replay_speed);
+            dynamic_source = make_replay();
+            source_ptr = dynamic_source.get();
+            dynamic_source->start(on_tick);
+        }
+        else if (cfg.source == SourceType::LOAD)
+        {
+            std::cout << "Generating " << cfg.load_symbols << " symbols x " << cfg.load_venues << " venues at "
+                      << cfg.load_rate << " ticks/s (" << cfg.load_model << ", seed " << cfg.load_seed << ")" << std::endl;
+            dynamic_source = std::make_unique<LoadGenerator>(load_cfg);
             source_ptr = dynamic_source.get();
-            dynamic_source->start([&](const MarketTick &tick)
-                                  { strategy->onMarketTick(tick); });
+            dynamic_source->start(on_tick);
         }
 
         std::cout << "TradePulse is running! Connect to ws://localhost:8080 to see live data." << std::endl;
         std::cout << "Press Ctrl+C to stop." << std::endl;
 
-        // Main loop
+        // Main loop; each 100ms pass also publishes mark-to-market PnL (10 Hz)
+        double last_realized = 0.0;
+        double last_unrealized = 0.0;
         while (!g_shutdown)
         {
             std::this_thread::sleep_for(std::chrono::milliseconds(100));
 
+            double realized = group ? group->getRealizedPnL() : engine ? engine->getRealizedPnL() : order_book.getTotalPnL();
+            double unrealized = group ? group->getUnrealizedPnL() : engine ? engine->getUnrealizedPnL() : order_book.getUnrealizedPnL();
+            if (realized != last_realized || unrealized != last_unrealized)
+            {
+                auto now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+                websocket_server.broadcastPnl(realized, unrealized, now_ms);
+                last_realized = realized;
+                last_unrealized = unrealized;
+            }
+
             // Print periodic stats
             static int stats_counter = 0;
             if (++stats_counter % 100 == 0)
             { // Every 10 seconds
                 std::cout << "Stats - Connected clients: " << websocket_server.getConnectedClients()
-                          << ", Total PnL: $" << order_book.getTotalPnL() << std::endl;
+                          << ", Total PnL: $" << realized
+                          << ", Unrealized PnL: $" << unrealized << std::endl;
             }
         }
 
@@ -287,17 +792,39 @@ int main(int argc, char **argv)
         {
             dynamic_source->stop();
         }
+        if (group)
+            group->stop();
+        if (engine)
+            engine->stop();
         latency_simulator.stop();
+        if (snapshot_writer)
+            snapshot_writer->stop();
+        if (journal)
+        {
+            journal->stop();
+            if (journal->failed())
+                std::cerr << "Journal " << cfg.journal_file << " stopped on a write error; " << journal->getRecordsLost()
+                          << " records not journaled" << std::endl;
+        }
+        if (recorder)
+        {
+            recorder->stop();
+            std::cout << "Recorded " << recorder->getRecorded() << " ticks in " << recorder->getFilesOpened() << " file(s), "
+                      << recorder->getDropped() << " dropped" << std::endl;
+        }
+        logger.stop();
         websocket_server.stop();
 
         std::cout << "Final Stats:" << std::endl;
         std::cout << "Total PnL: $" << order_book.getTotalPnL() << std::endl;
+        std::cout << "Unrealized PnL: $" << order_book.getUnrealizedPnL() << std::endl;
+        std::cout << "Log lines: " << logger.getRecordsWritten() << " written, " << logger.getDropped() << " dropped" << std::endl;
 
         auto recent_trades = order_book.getRecentTrades(5);
         std::cout << "Recent trades:" << std::endl;
         for (const auto &trade : recent_trades)
         {
-            std::cout << "  " << trade.id << " - " << trade.venue
+            std::cout << "  T" << trade.id << " - " << trade.venue
                       << " " << ((trade.side == OrderSide::BUY) ? "BUY" : "SELL")
                       << " @ $" << trade.price << " (PnL: $" << trade.pnl << ")" << std::endl;
         }
@@ -1,4 +1,5 @@
 #include "market_feed.h"
+#include "trace.h"
 #include <iostream>
 #include <thread>
 #include <chrono>
@@ -55,6 +56,7 @@ std::vector<std::string> MarketFeed::getVenues() const
 
 void MarketFeed::generateTicks()
 {
+    setTraceThreadName("feed");
     while (running_)
     {
         // Generate price movement using random walk
@@ -69,6 +71,7 @@ void MarketFeed::generateTicks()
         tick.exchange_recv_ts_ms = -1;
         auto now = std::chrono::time_point_cast<std::chrono::milliseconds>(std::chrono::system_clock::now());
         tick.ingest_ts_ms = now.time_since_epoch().count();
+        tick.ingest_ns = steadyNowNs();
 
         if (on_tick_)
         {
@@ -0,0 +1,52 @@
+#include "metrics.h"
+
+void LabeledCounter::add(const MetricLabel &label, uint64_t n)
+{
+    for (auto &slot : slots_)
+    {
+        int state = slot.state.load(std::memory_order_acquire);
+        if (state == 0)
+        {
+            if (slot.state.compare_exchange_strong(state, 1, std::memory_order_acquire))
+            {
+                slot.label = label;
+                slot.state.store(2, std::memory_order_release);
+                slot.count.add(n);
+                return;
+            }
+        }
+        // Another thread is claiming this slot; wait for its label before comparing
+        while (state == 1)
+            state = slot.state.load(std::memory_order_acquire);
+        if (slot.label == label)
+        {
+            slot.count.add(n);
+            return;
+        }
+    }
+    other_.add(n);
+}
+
+void LabeledCounter::appendTo(std::ostringstream &oss, const char *name, const char *key) const
+{
+    for (const auto &slot : slots_)
+    {
+        if (slot.state.load(std::memory_order_acquire) != 2)
+            continue;
+        oss << name << "{" << key << "=\"" << slot.label << "\"} " << slot.count.get() << "\n";
+    }
+    if (other_.get() > 0)
+        oss << name << "{" << key << "=\"other\"} " << other_.get() << "\n";
+}
+
+void appendMetricHeader(std::ostringstream &oss, const char *name, const char *type, const char *help)
+{
+    oss << "# HELP " << name << " " << help << "\n";
+    oss << "# TYPE " << name << " " << type << "\n";
+}
+
+void appendMetric(std::ostringstream &oss, const char *name, const char *type, const char *help, uint64_t value)
+{
+    appendMetricHeader(oss, name, type, help);
+    oss << name << " " << value << "\n";
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "fixed_string.h"
+#include <atomic>
+#include <cstdint>
+#include <sstream>
+#include <string>
+
+// Counter on its own cache line, so counters bumped by different threads never share one
+struct alignas(64) PaddedCounter
+{
+    std::atomic<uint64_t> value{0};
+
+    void add(uint64_t n = 1) { value.fetch_add(n, std::memory_order_relaxed); }
+    uint64_t get() const { return value.load(std::memory_order_relaxed); }
+};
+
+using MetricLabel = FixedString<24>;
+
+// Counters keyed by one label value (source, strategy). Slots are claimed lock-free on first
+// use; labels past MAX_LABELS are folded into "other".
+class LabeledCounter
+{
+public:
+    void add(const MetricLabel &label, uint64_t n = 1);
+    // One sample line per label: name{key="label"} value
+    void appendTo(std::ostringstream &oss, const char *name, const char *key) const;
+
+private:
+    static constexpr int MAX_LABELS = 16;
+
+    struct Slot
+    {
+        std::atomic<int> state{0}; // 0 free, 1 being claimed, 2 ready
+        MetricLabel label;
+        PaddedCounter count;
+    };
+
+    Slot slots_[MAX_LABELS];
+    PaddedCounter other_;
+};
+
+// Prometheus text exposition helpers: HELP/TYPE header, then samples
+void appendMetricHeader(std::ostringstream &oss, const char *name, const char *type, const char *help);
+void appendMetric(std::ostringstream &oss, const char *name, const char *type, const char *help, uint64_t value);
@@ -1,9 +1,13 @@
 #include "order_book.h"
+#include "trace.h"
 #include <iostream>
-#include <sstream>
 #include <algorithm>
+#include <cstdlib>
+#include <cstring>
 
-OrderBook::OrderBook() : total_pnl_(0.0), trade_counter_(0)
+OrderBook::OrderBook()
+    : trades_(MAX_RECENT_TRADES), trades_head_(0), trades_size_(0), total_pnl_(0.0), trade_counter_(0),
+      total_unrealized_pnl_(0.0)
 {
 }
 
@@ -16,34 +20,309 @@ void OrderBook::submitOrder(const Order &order)
     processOrder(order);
 }
 
+void OrderBook::submitOrders(const Order *orders, size_t count)
+{
+    TraceScope trace("submitOrders");
+    Trade fills[MAX_BATCH_ORDERS];
+    while (count > 0)
+    {
+        size_t n = std::min(count, MAX_BATCH_ORDERS);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (size_t i = 0; i < n; ++i)
+                fills[i] = applyOrder(orders[i]);
+        }
+        if (trade_batch_callback_)
+            trade_batch_callback_(fills, n);
+        else if (trade_callback_)
+        {
+            for (size_t i = 0; i < n; ++i)
+                trade_callback_(fills[i]);
+        }
+        orders += n;
+        count -= n;
+    }
+}
+
 void OrderBook::setTradeCallback(std::function<void(const Trade &)> callback)
 {
     trade_callback_ = callback;
 }
 
+void OrderBook::setTradeBatchCallback(std::function<void(const Trade *, size_t)> callback)
+{
+    trade_batch_callback_ = callback;
+}
+
+void OrderBook::markToMarket(const MarketTick &tick)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Only instruments we have traded carry a mark; never insert on the tick path
+    auto it = last_prices_.find(InstrumentId(tick.venue, tick.symbol));
+    if (it == last_prices_.end() || it->second == tick.price)
+        return;
+    it->second = tick.price;
+    revalue(it->first);
+}
+
 double OrderBook::getTotalPnL() const
 {
+    std::lock_guard<std::mutex> lock(mutex_);
     return total_pnl_;
 }
 
+double OrderBook::getUnrealizedPnL() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return total_unrealized_pnl_;
+}
+
 std::vector<Trade> OrderBook::getRecentTrades(int count) const
 {
+    std::lock_guard<std::mutex> lock(mutex_);
     std::vector<Trade> recent_trades;
-    int start_idx = std::max(0, static_cast<int>(trades_.size()) - count);
+    size_t n = std::min(trades_size_, static_cast<size_t>(std::max(0, count)));
 
-    for (int i = start_idx; i < static_cast<int>(trades_.size()); ++i)
+    for (size_t i = trades_size_ - n; i < trades_size_; ++i)
     {
-        recent_trades.push_back(trades_[i]);
+        recent_trades.push_back(trades_[(trades_head_ + i) % trades_.size()]);
     }
 
     return recent_trades;
 }
 
+int OrderBook::getTradeCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return trade_counter_;
+}
+
+std::map<InstrumentId, int> OrderBook::getPositions() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return positions_;
+}
+
+static constexpr char SNAPSHOT_MAGIC[4] = {'T', 'P', 'S', 'N'};
+// Version 2: integer trade ids (version 1 stored "T<n>" strings and is still readable)
+// Version 3: journal epoch after the trade counter
+// Version 4: positions keyed by venue and symbol (older ones by venue only)
+static constexpr uint32_t SNAPSHOT_VERSION = 4;
+
+template <typename T>
+static void put(std::string &out, T value)
+{
+    out.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+static void putString(std::string &out, const std::string &value)
+{
+    put<uint32_t>(out, static_cast<uint32_t>(value.size()));
+    out.append(value);
+}
+
+struct SnapshotReader
+{
+    const std::string &data;
+    size_t pos{0};
+    bool ok{true};
+
+    template <typename T>
+    T get()
+    {
+        T value{};
+        if (pos + sizeof(T) > data.size())
+        {
+            ok = false;
+            return value;
+        }
+        std::memcpy(&value, data.data() + pos, sizeof(T));
+        pos += sizeof(T);
+        return value;
+    }
+
+    std::string getString()
+    {
+        uint32_t len = get<uint32_t>();
+        if (!ok || pos + len > data.size())
+        {
+            ok = false;
+            return {};
+        }
+        std::string value = data.substr(pos, len);
+        pos += len;
+        return value;
+    }
+};
+
+std::string OrderBook::serializeSnapshot(uint64_t epoch) const
+{
+    std::string out;
+    std::lock_guard<std::mutex> lock(mutex_);
+    out.reserve(64 + positions_.size() * 48 + trades_size_ * 160);
+    out.append(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    put<uint32_t>(out, SNAPSHOT_VERSION);
+    put<double>(out, total_pnl_);
+    put<int32_t>(out, trade_counter_);
+    put<uint64_t>(out, epoch);
+
+    put<uint32_t>(out, static_cast<uint32_t>(positions_.size()));
+    for (const auto &kv : positions_)
+    {
+        auto avg = avg_prices_.find(kv.first);
+        auto last = last_prices_.find(kv.first);
+        putString(out, kv.first.venue.str());
+        putString(out, kv.first.symbol.str());
+        put<int32_t>(out, kv.second);
+        put<double>(out, avg != avg_prices_.end() ? avg->second : 0.0);
+        put<double>(out, last != last_prices_.end() ? last->second : 0.0);
+    }
+
+    put<uint32_t>(out, static_cast<uint32_t>(trades_size_));
+    for (size_t i = 0; i < trades_size_; ++i)
+    {
+        const Trade &t = trades_[(trades_head_ + i) % trades_.size()];
+        put<uint64_t>(out, t.id);
+        putString(out, t.venue.str());
+        putString(out, t.symbol.str());
+        put<uint8_t>(out, t.side == OrderSide::BUY ? 0 : 1);
+        put<double>(out, t.price);
+        put<int32_t>(out, t.quantity);
+        put<int64_t>(out, std::chrono::duration_cast<std::chrono::milliseconds>(t.timestamp.time_since_epoch()).count());
+        put<double>(out, t.pnl);
+        put<double>(out, t.size);
+        put<int64_t>(out, t.order_created_ts_ms);
+        put<int64_t>(out, t.order_executed_ts_ms);
+        put<int64_t>(out, t.server_broadcast_ts_ms);
+        put<int64_t>(out, t.exchange_recv_ts_ms);
+        put<int64_t>(out, t.ingest_ts_ms);
+        put<double>(out, t.modelled_latency_ms);
+    }
+    return out;
+}
+
+bool OrderBook::restoreSnapshot(const std::string &data, uint64_t *epoch)
+{
+    if (data.size() < sizeof(SNAPSHOT_MAGIC) || std::memcmp(data.data(), SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0)
+        return false;
+    SnapshotReader in{data, sizeof(SNAPSHOT_MAGIC)};
+    uint32_t version = in.get<uint32_t>();
+    if (version < 1 || version > SNAPSHOT_VERSION)
+        return false;
+
+    double total_pnl = in.get<double>();
+    int trade_counter = in.get<int32_t>();
+    uint64_t snapshot_epoch = version >= 3 ? in.get<uint64_t>() : 0;
+
+    std::map<InstrumentId, int> positions;
+    std::map<InstrumentId, double> avg_prices;
+    std::map<InstrumentId, double> last_prices;
+    uint32_t instruments = in.get<uint32_t>();
+    for (uint32_t i = 0; i < instruments && in.ok; ++i)
+    {
+        InstrumentId instrument;
+        instrument.venue = in.getString();
+        if (version >= 4)
+            instrument.symbol = in.getString();
+        positions[instrument] = in.get<int32_t>();
+        avg_prices[instrument] = in.get<double>();
+        last_prices[instrument] = in.get<double>();
+    }
+
+    std::vector<Trade> trades;
+    uint32_t count = in.get<uint32_t>();
+    for (uint32_t i = 0; i < count && in.ok; ++i)
+    {
+        Trade t;
+        if (version == 1)
+            t.id = std::strtoull(in.getString().c_str() + 1, nullptr, 10);
+        else
+            t.id = in.get<uint64_t>();
+        t.venue = in.getString();
+        t.symbol = in.getString();
+        t.side = in.get<uint8_t>() == 0 ? OrderSide::BUY : OrderSide::SELL;
+        t.price = in.get<double>();
+        t.quantity = in.get<int32_t>();
+        t.timestamp = std::chrono::system_clock::time_point(std::chrono::milliseconds(in.get<int64_t>()));
+        t.pnl = in.get<double>();
+        t.size = in.get<double>();
+        t.order_created_ts_ms = in.get<int64_t>();
+        t.order_executed_ts_ms = in.get<int64_t>();
+        t.server_broadcast_ts_ms = in.get<int64_t>();
+        t.exchange_recv_ts_ms = in.get<int64_t>();
+        t.ingest_ts_ms = in.get<int64_t>();
+        t.modelled_latency_ms = in.get<double>();
+        trades.push_back(t);
+    }
+    if (!in.ok)
+        return false;
+
+    if (version < 4)
+    {
+        // Older snapshots kept one position per venue; file it under the symbol last traded there
+        std::map<InstrumentId, int> keyed_positions;
+        std::map<InstrumentId, double> keyed_avg_prices;
+        std::map<InstrumentId, double> keyed_last_prices;
+        for (const auto &kv : positions)
+        {
+            InstrumentId instrument = kv.first;
+            for (auto t = trades.rbegin(); t != trades.rend(); ++t)
+            {
+                if (t->venue == instrument.venue)
+                {
+                    instrument.symbol = t->symbol;
+                    break;
+                }
+            }
+            keyed_positions[instrument] = kv.second;
+            keyed_avg_prices[instrument] = avg_prices[kv.first];
+            keyed_last_prices[instrument] = last_prices[kv.first];
+        }
+        positions.swap(keyed_positions);
+        avg_prices.swap(keyed_avg_prices);
+        last_prices.swap(keyed_last_prices);
+    }
+
+    if (epoch)
+        *epoch = snapshot_epoch;
+    std::lock_guard<std::mutex> lock(mutex_);
+    total_pnl_ = total_pnl;
+    trade_counter_ = trade_counter;
+    positions_.swap(positions);
+    avg_prices_.swap(avg_prices);
+    last_prices_.swap(last_prices);
+    trades_head_ = 0;
+    trades_size_ = 0;
+    for (const auto &t : trades)
+        pushTrade(t);
+    unrealized_pnl_.clear();
+    total_unrealized_pnl_ = 0.0;
+    for (const auto &kv : positions_)
+        revalue(kv.first);
+    publishTotals();
+    return true;
+}
+
 void OrderBook::processOrder(const Order &order)
+{
+    TraceScope trace("processOrder");
+    std::unique_lock<std::mutex> lock(mutex_);
+    Trade trade = applyOrder(order);
+    lock.unlock();
+
+    // Call the callback if set
+    if (trade_callback_)
+    {
+        trade_callback_(trade);
+    }
+}
+
+Trade OrderBook::applyOrder(const Order &order)
 {
     // Simple market order execution at current price
     Trade trade;
-    trade.id = generateTradeId();
+    trade.id = static_cast<uint64_t>(++trade_counter_);
+    trade.book = book_id_;
     trade.venue = order.venue;
     trade.side = order.side;
     trade.price = order.price;
@@ -57,11 +336,16 @@ void OrderBook::processOrder(const Order &order)
     trade.exchange_recv_ts_ms = order.exchange_recv_ts_ms;
     trade.ingest_ts_ms = order.ingest_ts_ms;
     trade.modelled_latency_ms = 0.0;
+    trade.ingest_ns = order.ingest_ns;
+    trade.created_ns = order.created_ns;
+    trade.accepted_ns = order.accepted_ns;
+    trade.executed_ns = steadyNowNs();
 
     // Calculate PnL based on position changes
     double pnl = 0.0;
-    int &position = positions_[order.venue];
-    double &avg_price = avg_prices_[order.venue];
+    InstrumentId instrument(order.venue, order.symbol);
+    int &position = positions_[instrument];
+    double &avg_price = avg_prices_[instrument];
 
     if (order.side == OrderSide::BUY)
     {
@@ -100,7 +384,7 @@ void OrderBook::processOrder(const Order &order)
             int open_qty = order.quantity - close_qty;
             if (open_qty > 0)
             {
-                avg_price = (avg_price * position + order.price * open_qty) / (position - open_qty);
+                avg_price = (avg_price * (-position) + order.price * open_qty) / (-position + open_qty);
                 position -= open_qty;
             }
         }
@@ -115,19 +399,36 @@ void OrderBook::processOrder(const Order &order)
     trade.pnl = pnl;
     total_pnl_ += pnl;
 
-    trades_.push_back(trade);
-    last_prices_[order.venue] = order.price;
+    pushTrade(trade);
+    last_prices_[instrument] = order.price;
+    revalue(instrument);
+    return trade;
+}
 
-    // Call the callback if set
-    if (trade_callback_)
+void OrderBook::pushTrade(const Trade &trade)
+{
+    if (trades_size_ < trades_.size())
     {
-        trade_callback_(trade);
+        trades_[(trades_head_ + trades_size_) % trades_.size()] = trade;
+        ++trades_size_;
+        return;
     }
+    trades_[trades_head_] = trade;
+    trades_head_ = (trades_head_ + 1) % trades_.size();
 }
 
-std::string OrderBook::generateTradeId()
+void OrderBook::revalue(const InstrumentId &instrument)
 {
-    std::ostringstream oss;
-    oss << "T" << (++trade_counter_);
-    return oss.str();
-}
\ No newline at end of file
+    double &upnl = unrealized_pnl_[instrument];
+    double next = positions_[instrument] * (last_prices_[instrument] - avg_prices_[instrument]);
+    total_unrealized_pnl_ += next - upnl;
+    upnl = next;
+    // Every fill and mark ends here, after any realized PnL change
+    publishTotals();
+}
+
+void OrderBook::publishTotals()
+{
+    published_pnl_.store(total_pnl_, std::memory_order_relaxed);
+    published_unrealized_pnl_.store(total_unrealized_pnl_, std::memory_order_relaxed);
+}
@@ -6,6 +6,11 @@
 #include <chrono>
 #include <functional>
 #include <vector>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+#include "data_source.h"
+#include "fixed_string.h"
 
 enum class OrderSide
 {
@@ -13,36 +18,48 @@ enum class OrderSide
     SELL
 };
 
+// Orders and trades are trivially copyable: integer ids and inline instrument ids, so building,
+// queueing and executing one never allocates
 struct Order
 {
-    std::string id;
-    std::string venue;
-    std::string symbol;
+    uint64_t id;
+    VenueId venue;
+    SymbolId symbol;
     OrderSide side;
     double price;
     int quantity;
     std::chrono::system_clock::time_point timestamp;
     int64_t exchange_recv_ts_ms{-1};
     int64_t ingest_ts_ms{-1};
+    // Stage stamps (steadyNowNs); -1 when unknown
+    int64_t ingest_ns{-1};
+    int64_t created_ns{-1};
+    int64_t accepted_ns{-1}; // passed risk, handed to execution
 };
 
 struct Trade
 {
-    std::string id;
-    std::string venue;
+    uint64_t id;
+    VenueId venue;
     OrderSide side;
     double price;
     int quantity;
     std::chrono::system_clock::time_point timestamp;
     double pnl;
     double size;
-    std::string symbol;
+    SymbolId symbol;
     int64_t order_created_ts_ms;
     int64_t order_executed_ts_ms;
     int64_t server_broadcast_ts_ms;
     int64_t exchange_recv_ts_ms;
     int64_t ingest_ts_ms;
     double modelled_latency_ms;
+    uint32_t book{0}; // bookId() of the book that filled it
+    // Stage stamps carried over from the order, plus the book apply (steadyNowNs); -1 when unknown
+    int64_t ingest_ns{-1};
+    int64_t created_ns{-1};
+    int64_t accepted_ns{-1};
+    int64_t executed_ns{-1};
 };
 
 class OrderBook
@@ -52,23 +69,69 @@ public:
     ~OrderBook();
 
     void submitOrder(const Order &order);
+    // Applies the orders under one lock, so no reader or other submitter sees a partial batch, then
+    // reports the fills in one batch callback. Batches over MAX_BATCH_ORDERS apply in chunks.
+    void submitOrders(const Order *orders, size_t count);
     void setTradeCallback(std::function<void(const Trade &)> callback);
+    // Used for submitOrders() fills when set; otherwise each fill goes to the trade callback
+    void setTradeBatchCallback(std::function<void(const Trade *, size_t)> callback);
+    // Tags this book's trades (and its journal records): 0 is the main book, shard lanes and group
+    // members number theirs from 1
+    void setBookId(uint32_t book_id) { book_id_ = book_id; }
+    uint32_t bookId() const { return book_id_; }
+
+    // Revalue the open position in the tick's instrument at the new mark; O(1) in the number of
+    // instruments held
+    void markToMarket(const MarketTick &tick);
 
     double getTotalPnL() const;
+    double getUnrealizedPnL() const;
+    // Lock-free reads of the totals as of the last fill, mark or restore, for reporters that poll
+    // many books from another thread
+    double getPublishedPnL() const { return published_pnl_.load(std::memory_order_relaxed); }
+    double getPublishedUnrealizedPnL() const { return published_unrealized_pnl_.load(std::memory_order_relaxed); }
     std::vector<Trade> getRecentTrades(int count = 10) const;
+    int getTradeCount() const;
+    std::map<InstrumentId, int> getPositions() const;
+
+    // Compact binary image of positions, PnL, trade counter and the recent trades ring, tagged with
+    // the journal epoch of the run that took it (0 for snapshots older than version 3)
+    std::string serializeSnapshot(uint64_t epoch = 0) const;
+    bool restoreSnapshot(const std::string &data, uint64_t *epoch = nullptr);
+
+    static constexpr int MAX_RECENT_TRADES = 1000;
+    static constexpr size_t MAX_BATCH_ORDERS = 16;
 
 private:
     void processOrder(const Order &order);
-    std::string generateTradeId();
+    // Caller holds mutex_
+    Trade applyOrder(const Order &order);
+    void revalue(const InstrumentId &instrument);
+    void pushTrade(const Trade &trade);
+    // Caller holds mutex_
+    void publishTotals();
 
-    std::map<std::string, double> last_prices_;
+    std::map<InstrumentId, double> last_prices_;
+    // Fixed ring of the last MAX_RECENT_TRADES fills; trades_head_ is the oldest
     std::vector<Trade> trades_;
+    size_t trades_head_;
+    size_t trades_size_;
     std::function<void(const Trade &)> trade_callback_;
+    std::function<void(const Trade *, size_t)> trade_batch_callback_;
 
     double total_pnl_;
     int trade_counter_;
+    uint32_t book_id_{0};
 
     // Simple position tracking
-    std::map<std::string, int> positions_;
-    std::map<std::string, double> avg_prices_;
+    std::map<InstrumentId, int> positions_;
+    std::map<InstrumentId, double> avg_prices_;
+
+    // Mark-to-market state, updated incrementally per instrument
+    std::map<InstrumentId, double> unrealized_pnl_;
+    double total_unrealized_pnl_;
+    std::atomic<double> published_pnl_{0.0};
+    std::atomic<double> published_unrealized_pnl_{0.0};
+
+    mutable std::mutex mutex_;
 };
\ No newline at end of file
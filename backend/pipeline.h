@@ -0,0 +1,177 @@
+#pragma once
+
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include "bars.h"
+#include "data_source.h"
+#include "order_book.h"
+#include "risk.h"
+#include "trace.h"
+#include "strategies/strategy_momentum.h"
+#include "strategies/strategy_mean_reversion.h"
+#include "strategies/strategy_breakout.h"
+#include "strategies/strategy_vwap_reversion.h"
+#include "strategies/strategy_macd.h"
+#include "strategies/strategy_rsi.h"
+#include "strategies/strategy_bollinger.h"
+
+// Feed -> strategy -> risk -> execute chain composed at compile time. The strategy type and the
+// execute callable are template parameters, so there is no virtual call per tick and no
+// std::function per order; the strategy's process() is instantiated with a sink that runs the
+// risk check and hands the order straight to Execute. Execute is called as execute(book, order);
+// if it is also callable as execute(book, orders, count), risk-accepted batches go through that.
+template <typename Strategy, typename Execute>
+class StaticPipeline
+{
+public:
+    StaticPipeline(OrderBook &order_book, RiskGate &risk_gate, Execute execute)
+        : order_book_(order_book), risk_gate_(risk_gate), execute_(std::move(execute)), strategy_(order_book)
+    {
+    }
+
+    void onTick(const MarketTick &tick)
+    {
+        order_book_.markToMarket(tick);
+        risk_gate_.onMarketTick(tick);
+        TraceScope trace("onMarketTick");
+        Sink sink{*this};
+        strategy_.process(tick, sink);
+    }
+
+    // Bar mode: the caller still marks and risk-ticks on every raw tick; only the strategy
+    // runs per closed bar
+    void onBar(const Bar &bar)
+    {
+        TraceScope trace("onBar");
+        Sink sink{*this};
+        strategy_.process(barToTick(bar), sink);
+    }
+
+    Strategy &strategy() { return strategy_; }
+
+private:
+    struct Sink
+    {
+        StaticPipeline &pipeline;
+        void operator()(const Order &order) const
+        {
+            if (pipeline.risk_gate_.check(order) != RiskReject::NONE)
+                return;
+            pipeline.execute_(pipeline.order_book_, order);
+        }
+        void operator()(const Order *orders, size_t count) const
+        {
+            if constexpr (std::is_invocable_v<Execute &, OrderBook &, const Order *, size_t>)
+            {
+                Order accepted[OrderBook::MAX_BATCH_ORDERS];
+                size_t n = 0;
+                for (size_t i = 0; i < count; ++i)
+                {
+                    if (pipeline.risk_gate_.check(orders[i]) == RiskReject::NONE)
+                        accepted[n++] = orders[i];
+                    if (n == OrderBook::MAX_BATCH_ORDERS || (i + 1 == count && n > 0))
+                    {
+                        pipeline.execute_(pipeline.order_book_, static_cast<const Order *>(accepted), n);
+                        n = 0;
+                    }
+                }
+            }
+            else
+            {
+                for (size_t i = 0; i < count; ++i)
+                    (*this)(orders[i]);
+            }
+        }
+    };
+
+    OrderBook &order_book_;
+    RiskGate &risk_gate_;
+    Execute execute_;
+    Strategy strategy_;
+};
+
+// Combines lambdas into one overloaded callable, e.g. single-order and batch execute
+template <typename... Fs>
+struct Overloaded : Fs...
+{
+    using Fs::operator()...;
+};
+template <typename... Fs>
+Overloaded(Fs...) -> Overloaded<Fs...>;
+
+// Picks one StaticPipeline by strategy name at startup. The per-tick cost is a single variant
+// dispatch at the top; everything below it is resolved statically.
+template <typename Execute>
+class AnyStaticPipeline
+{
+public:
+    // Returns false for unknown strategy names
+    bool emplace(const std::string &name, OrderBook &order_book, RiskGate &risk_gate, Execute execute)
+    {
+        if (name == "momentum")
+            pipeline_.template emplace<StaticPipeline<MomentumStrategy, Execute>>(order_book, risk_gate, std::move(execute));
+        else if (name == "mean_reversion")
+            pipeline_.template emplace<StaticPipeline<MeanReversionStrategy, Execute>>(order_book, risk_gate, std::move(execute));
+        else if (name == "breakout")
+            pipeline_.template emplace<StaticPipeline<BreakoutStrategy, Execute>>(order_book, risk_gate, std::move(execute));
+        else if (name == "vwap_reversion")
+            pipeline_.template emplace<StaticPipeline<VwapReversionStrategy, Execute>>(order_book, risk_gate, std::move(execute));
+        else if (name == "macd")
+            pipeline_.template emplace<StaticPipeline<MacdStrategy, Execute>>(order_book, risk_gate, std::move(execute));
+        else if (name == "rsi")
+            pipeline_.template emplace<StaticPipeline<RsiStrategy, Execute>>(order_book, risk_gate, std::move(execute));
+        else if (name == "bollinger")
+            pipeline_.template emplace<StaticPipeline<BollingerStrategy, Execute>>(order_book, risk_gate, std::move(execute));
+        else
+            return false;
+        return true;
+    }
+
+    bool active() const { return pipeline_.index() != 0; }
+
+    void onTick(const MarketTick &tick)
+    {
+        std::visit([&](auto &p)
+                   {
+                       if constexpr (!std::is_same_v<std::decay_t<decltype(p)>, std::monostate>)
+                           p.onTick(tick);
+                   },
+                   pipeline_);
+    }
+
+    void onBar(const Bar &bar)
+    {
+        std::visit([&](auto &p)
+                   {
+                       if constexpr (!std::is_same_v<std::decay_t<decltype(p)>, std::monostate>)
+                           p.onBar(bar);
+                   },
+                   pipeline_);
+    }
+
+    // The embedded strategy, for name/lookback/quantity control; nullptr when empty
+    IStrategy *strategy()
+    {
+        return std::visit([](auto &p) -> IStrategy *
+                          {
+                              if constexpr (std::is_same_v<std::decay_t<decltype(p)>, std::monostate>)
+                                  return nullptr;
+                              else
+                                  return &p.strategy();
+                          },
+                          pipeline_);
+    }
+
+private:
+    std::variant<std::monostate,
+                 StaticPipeline<MomentumStrategy, Execute>,
+                 StaticPipeline<MeanReversionStrategy, Execute>,
+                 StaticPipeline<BreakoutStrategy, Execute>,
+                 StaticPipeline<VwapReversionStrategy, Execute>,
+                 StaticPipeline<MacdStrategy, Execute>,
+                 StaticPipeline<RsiStrategy, Execute>,
+                 StaticPipeline<BollingerStrategy, Execute>>
+        pipeline_;
+};
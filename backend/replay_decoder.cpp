@@ -0,0 +1,177 @@
+#include "replay_decoder.h"
+#include "replay_feed.h"
+#include "trace.h"
+#include <algorithm>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <unordered_map>
+
+void ReplayBatch::clear()
+{
+    instrument.clear();
+    price.clear();
+    size.clear();
+    exchange_recv_ts_ms.clear();
+    ingest_ts_ms.clear();
+    instruments.clear();
+}
+
+void ReplayBatch::toTick(size_t i, MarketTick &tick) const
+{
+    const auto &names = instruments[instrument[i]];
+    tick.venue = names.first;
+    tick.symbol = names.second;
+    tick.price = price[i];
+    tick.size = size[i];
+    tick.exchange_recv_ts_ms = exchange_recv_ts_ms[i];
+    tick.ingest_ts_ms = ingest_ts_ms[i];
+    tick.ingest_ns = -1;
+}
+
+ParallelReplayDecoder::ParallelReplayDecoder(const std::string &path, int threads, size_t chunk_bytes, uint64_t start_offset)
+    : path_(path), threads_(std::max(1, threads)), chunk_bytes_(std::max<size_t>(chunk_bytes, 4096)),
+      start_offset_(static_cast<size_t>(start_offset)), fd_(-1), file_size_(0),
+      chunks_(0), window_(0), next_claim_(0), next_out_(0), stopping_(false)
+{
+}
+
+ParallelReplayDecoder::~ParallelReplayDecoder()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    space_cv_.notify_all();
+    for (auto &t : workers_)
+    {
+        if (t.joinable())
+            t.join();
+    }
+    if (fd_ >= 0)
+        ::close(fd_);
+}
+
+bool ParallelReplayDecoder::start()
+{
+    fd_ = ::open(path_.c_str(), O_RDONLY);
+    if (fd_ < 0)
+        return false;
+    struct stat st;
+    if (::fstat(fd_, &st) != 0)
+        return false;
+    file_size_ = static_cast<size_t>(st.st_size);
+    size_t span = file_size_ > start_offset_ ? file_size_ - start_offset_ : 0;
+    chunks_ = (span + chunk_bytes_ - 1) / chunk_bytes_;
+    window_ = static_cast<size_t>(threads_) * 2;
+    for (int i = 0; i < threads_; ++i)
+        workers_.emplace_back(&ParallelReplayDecoder::worker, this);
+    return true;
+}
+
+void ParallelReplayDecoder::worker()
+{
+    setTraceThreadName("replay decode");
+    for (;;)
+    {
+        size_t index;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            space_cv_.wait(lock, [&]
+                           { return stopping_ || next_claim_ >= chunks_ || next_claim_ < next_out_ + window_; });
+            if (stopping_ || next_claim_ >= chunks_)
+                return;
+            index = next_claim_++;
+        }
+        ReplayBatch batch;
+        {
+            TraceScope trace("decodeChunk");
+            decodeChunk(index, batch);
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            done_.emplace(index, std::move(batch));
+        }
+        ready_cv_.notify_all();
+    }
+}
+
+bool ParallelReplayDecoder::next(ReplayBatch &batch)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (next_out_ >= chunks_)
+        return false;
+    ready_cv_.wait(lock, [&]
+                   { return done_.count(next_out_) > 0; });
+    auto it = done_.find(next_out_);
+    batch = std::move(it->second);
+    done_.erase(it);
+    ++next_out_;
+    lock.unlock();
+    space_cv_.notify_all();
+    return true;
+}
+
+void ParallelReplayDecoder::decodeChunk(size_t index, ReplayBatch &out) const
+{
+    size_t begin = start_offset_ + index * chunk_bytes_;
+    size_t end = std::min(file_size_, begin + chunk_bytes_);
+
+    // Read from one byte before the chunk (to see whether it starts a line) through the end of
+    // the line that straddles its end; the first chunk starts on a line
+    size_t read_from = index > 0 ? begin - 1 : begin;
+    std::string buf;
+    size_t want = end - read_from;
+    for (;;)
+    {
+        size_t have = buf.size();
+        size_t avail = file_size_ - (read_from + have);
+        size_t n = std::min(want - std::min(want, have) + 65536, avail);
+        buf.resize(have + n);
+        ssize_t got = n > 0 ? ::pread(fd_, &buf[have], n, static_cast<off_t>(read_from + have)) : 0;
+        buf.resize(have + static_cast<size_t>(std::max<ssize_t>(got, 0)));
+        if (got <= 0 || buf.find('\n', end - read_from) != std::string::npos)
+            break;
+    }
+
+    size_t pos = 0;
+    if (index > 0)
+    {
+        // A line that started in the previous chunk is that chunk's
+        if (buf[0] != '\n')
+        {
+            size_t nl = buf.find('\n');
+            if (nl == std::string::npos)
+                return;
+            pos = nl;
+        }
+        ++pos;
+    }
+
+    std::unordered_map<std::string, uint32_t> interned;
+    std::string line;
+    MarketTick tick;
+    while (pos < buf.size() && read_from + pos < end)
+    {
+        size_t nl = buf.find('\n', pos);
+        size_t line_end = nl == std::string::npos ? buf.size() : nl;
+        line.assign(buf, pos, line_end - pos);
+        pos = line_end + 1;
+        if (!ReplayFeed::parseLine(line, tick))
+            continue;
+        std::string key = tick.venue;
+        key += '\0';
+        key += tick.symbol;
+        auto it = interned.find(key);
+        if (it == interned.end())
+        {
+            it = interned.emplace(std::move(key), static_cast<uint32_t>(out.instruments.size())).first;
+            out.instruments.emplace_back(tick.venue, tick.symbol);
+        }
+        out.instrument.push_back(it->second);
+        out.price.push_back(tick.price);
+        out.size.push_back(tick.size);
+        out.exchange_recv_ts_ms.push_back(tick.exchange_recv_ts_ms);
+        out.ingest_ts_ms.push_back(tick.ingest_ts_ms);
+    }
+}
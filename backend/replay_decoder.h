@@ -0,0 +1,70 @@
+#pragma once
+
+#include "data_source.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// One decoded chunk of a recording, column per field. Venue/symbol pairs are interned per batch;
+// `instrument` indexes `instruments`.
+struct ReplayBatch
+{
+    std::vector<uint32_t> instrument;
+    std::vector<double> price;
+    std::vector<double> size;
+    std::vector<int64_t> exchange_recv_ts_ms;
+    std::vector<int64_t> ingest_ts_ms;
+    std::vector<std::pair<std::string, std::string>> instruments;
+
+    size_t rows() const { return price.size(); }
+    void clear();
+    // Row i as a tick (ingest_ns left unset)
+    void toTick(size_t i, MarketTick &tick) const;
+};
+
+// Decodes an NDJSON recording on a pool of workers. The file is cut into chunk_bytes pieces; a
+// line belongs to the chunk its first byte falls in, so chunks need no coordination to agree
+// on boundaries. Workers claim chunks in order, parse them with ReplayFeed::parseLine into
+// ReplayBatches, and next() hands the batches back strictly in file order, so the consumer sees
+// exactly the sequence a single-threaded read would produce. At most `window` chunks are
+// decoded ahead of the consumer, which bounds memory on arbitrarily large files. Decoding can
+// start at any line boundary (start_offset), e.g. one found in a TickStore index.
+class ParallelReplayDecoder
+{
+public:
+    ParallelReplayDecoder(const std::string &path, int threads, size_t chunk_bytes = 4 << 20, uint64_t start_offset = 0);
+    ~ParallelReplayDecoder();
+
+    // False if the file cannot be opened
+    bool start();
+    // Next batch in file order; false once the file is exhausted
+    bool next(ReplayBatch &batch);
+
+private:
+    void worker();
+    void decodeChunk(size_t index, ReplayBatch &out) const;
+
+    std::string path_;
+    int threads_;
+    size_t chunk_bytes_;
+    size_t start_offset_;
+    int fd_;
+    size_t file_size_;
+    size_t chunks_;
+    size_t window_;
+
+    std::mutex mutex_;
+    std::condition_variable ready_cv_;
+    std::condition_variable space_cv_;
+    std::map<size_t, ReplayBatch> done_;
+    size_t next_claim_;
+    size_t next_out_;
+    bool stopping_;
+    std::vector<std::thread> workers_;
+};
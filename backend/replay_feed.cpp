@@ -1,10 +1,23 @@
 #include "replay_feed.h"
+#include "replay_decoder.h"
+#include "tick_archive.h"
+#include "tick_recorder.h"
+#include "tick_store.h"
+#include "trace.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
 #include <fstream>
 #include <sstream>
 #include <chrono>
+#include <deque>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <utility>
 
-ReplayFeed::ReplayFeed(const std::string &file_path, double speed)
-    : file_path_(file_path), speed_(speed)
+ReplayFeed::ReplayFeed(const std::string &file_path, double speed, int decode_threads)
+    : file_path_(file_path), speed_(speed > 0.0 ? speed : 1.0), decode_threads_(decode_threads)
 {
 }
 
@@ -27,73 +40,286 @@ void ReplayFeed::stop()
     if (!running_)
         return;
     running_ = false;
+    notifyControl();
     if (thread_.joinable())
         thread_.join();
 }
 
-void ReplayFeed::run()
+void ReplayFeed::notifyControl()
+{
+    // Taking the lock orders the flag change before a waiter's predicate check
+    {
+        std::lock_guard<std::mutex> lock(control_mutex_);
+    }
+    control_cv_.notify_all();
+}
+
+bool ReplayFeed::seek(const std::string &when)
 {
-    std::ifstream in(file_path_);
+    int64_t ts;
+    if (!TickStore::parseTime(when, 0, ts))
+        return false;
+    {
+        std::lock_guard<std::mutex> lock(control_mutex_);
+        seek_to_ = when;
+        seek_pending_ = true;
+    }
+    control_cv_.notify_all();
+    return true;
+}
+
+void ReplayFeed::pause()
+{
+    paused_ = true;
+    ++control_gen_;
+    notifyControl();
+}
+
+void ReplayFeed::resume()
+{
+    paused_ = false;
+    ++control_gen_;
+    notifyControl();
+}
+
+bool ReplayFeed::setSpeed(double speed)
+{
+    if (!(speed > 0.0))
+        return false;
+    speed_ = speed;
+    ++control_gen_;
+    notifyControl();
+    return true;
+}
+
+bool ReplayFeed::parseLine(const std::string &line, MarketTick &tick)
+{
+    // expected NDJSON matching broadcast trade payload fields used to reconstruct MarketTick
+    if (line.empty())
+        return false;
+    // very small ad-hoc parser: look for keys we need
+    tick = MarketTick{};
+    tick.size = 0;
+    auto getNum = [&](const std::string &k, double missing = 0.0) -> double
+    {
+        auto pos = line.find("\"" + k + "\"");
+        if (pos == std::string::npos)
+            return missing;
+        pos = line.find(':', pos);
+        if (pos == std::string::npos)
+            return missing;
+        size_t end = line.find_first_of(",}\n", pos + 1);
+        return std::atof(line.substr(pos + 1, end - pos - 1).c_str());
+    };
+    auto getStr = [&](const std::string &k) -> std::string
+    {
+        auto pos = line.find("\"" + k + "\"");
+        if (pos == std::string::npos)
+            return {};
+        pos = line.find(':', pos);
+        pos = line.find('"', pos);
+        size_t end = line.find('"', pos + 1);
+        if (pos == std::string::npos || end == std::string::npos)
+            return {};
+        return line.substr(pos + 1, end - pos - 1);
+    };
+    tick.venue = getStr("venue");
+    tick.symbol = getStr("symbol");
+    tick.price = getNum("price");
+    tick.size = getNum("size");
+    // Written by the recorder and the broadcast payload; -1 (unknown) in files without it
+    tick.exchange_recv_ts_ms = static_cast<int64_t>(getNum("exchange_recv_ts_ms", -1.0));
+    int64_t ingest_ms = static_cast<int64_t>(getNum("ingest_ts_ms"));
+    if (ingest_ms <= 0)
+        ingest_ms = static_cast<int64_t>(getNum("server_broadcast_ts_ms"));
+    if (ingest_ms <= 0)
+    {
+        ingest_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                        std::chrono::system_clock::now().time_since_epoch())
+                        .count();
+    }
+    tick.ingest_ts_ms = ingest_ms;
+    return tick.price > 0.0;
+}
+
+// Shortest %g text that reads back as exactly `v`
+static void format_exact(char *out, size_t len, double v)
+{
+    std::snprintf(out, len, "%.15g", v);
+    if (std::strtod(out, nullptr) != v)
+        std::snprintf(out, len, "%.17g", v);
+}
+
+std::string ReplayFeed::toLine(const MarketTick &tick)
+{
+    char price[32], size[32], buf[256];
+    format_exact(price, sizeof(price), tick.price);
+    format_exact(size, sizeof(size), tick.size);
+    int n = std::snprintf(buf, sizeof(buf),
+                          "{\"venue\":\"%.64s\",\"symbol\":\"%.64s\",\"price\":%s,\"size\":%s,\"exchange_recv_ts_ms\":%lld,"
+                          "\"ingest_ts_ms\":%lld}\n",
+                          tick.venue.c_str(), tick.symbol.c_str(), price, size,
+                          static_cast<long long>(tick.exchange_recv_ts_ms), static_cast<long long>(tick.ingest_ts_ms));
+    return std::string(buf, n > 0 ? std::min<size_t>(static_cast<size_t>(n), sizeof(buf) - 1) : 0);
+}
+
+bool ReplayFeed::forEachTick(const std::string &file_path, const std::function<bool(MarketTick &)> &on_tick, int decode_threads)
+{
+    if (TickRecorder::isBinaryFile(file_path))
+    {
+        return TickRecorder::read(file_path, [&](const TickRecord &rec)
+                                  {
+            MarketTick tick = TickRecorder::toTick(rec);
+            return on_tick(tick); });
+    }
+    if (TickArchive::isArchiveFile(file_path))
+    {
+        MarketTick tick;
+        return TickArchive::read(file_path, [&](const ReplayBatch &batch)
+                                 {
+            for (size_t i = 0; i < batch.rows(); ++i)
+            {
+                batch.toTick(i, tick);
+                if (!on_tick(tick))
+                    return false;
+            }
+            return true; });
+    }
+    if (decode_threads > 1)
+    {
+        ParallelReplayDecoder decoder(file_path, decode_threads);
+        if (!decoder.start())
+            return false;
+        ReplayBatch batch;
+        MarketTick tick;
+        while (decoder.next(batch))
+        {
+            for (size_t i = 0; i < batch.rows(); ++i)
+            {
+                batch.toTick(i, tick);
+                if (!on_tick(tick))
+                    return true;
+            }
+        }
+        return true;
+    }
+    std::ifstream in(file_path);
     if (!in.is_open())
-        return;
+        return false;
     std::string line;
-    int64_t prev_ts = -1;
-    while (running_ && std::getline(in, line))
+    MarketTick tick;
+    while (std::getline(in, line))
     {
-        // expected NDJSON matching broadcast trade payload fields used to reconstruct MarketTick
-        if (line.empty())
-            continue;
-        // very small ad-hoc parser: look for keys we need
-        MarketTick tick{};
-        tick.exchange_recv_ts_ms = -1;
-        tick.size = 0;
-        auto getNum = [&](const std::string &k) -> double
-        {
-            auto pos = line.find("\"" + k + "\"");
-            if (pos == std::string::npos)
-                return 0.0;
-            pos = line.find(':', pos);
-            if (pos == std::string::npos)
-                return 0.0;
-            size_t end = line.find_first_of(",}\n", pos + 1);
-            return std::atof(line.substr(pos + 1, end - pos - 1).c_str());
-        };
-        auto getStr = [&](const std::string &k) -> std::string
-        {
-            auto pos = line.find("\"" + k + "\"");
-            if (pos == std::string::npos)
-                return {};
-            pos = line.find(':', pos);
-            pos = line.find('"', pos);
-            size_t end = line.find('"', pos + 1);
-            if (pos == std::string::npos || end == std::string::npos)
-                return {};
-            return line.substr(pos + 1, end - pos - 1);
-        };
-        tick.venue = getStr("venue");
-        tick.symbol = getStr("symbol");
-        tick.price = getNum("price");
-        tick.size = getNum("size");
-        int64_t ingest_ms = static_cast<int64_t>(getNum("ingest_ts_ms"));
-        if (ingest_ms <= 0)
-            ingest_ms = static_cast<int64_t>(getNum("server_broadcast_ts_ms"));
-        if (ingest_ms <= 0)
+        if (parseLine(line, tick) && !on_tick(tick))
+            break;
+    }
+    return true;
+}
+
+std::vector<MarketTick> ReplayFeed::loadRecent(const std::string &file_path, int per_instrument)
+{
+    std::vector<MarketTick> out;
+    if (per_instrument <= 0)
+        return out;
+
+    // Keep a bounded window per instrument, tagged with file position for the merge back
+    std::map<std::pair<std::string, std::string>, std::deque<std::pair<size_t, MarketTick>>> windows;
+    size_t index = 0;
+    forEachTick(file_path, [&](MarketTick &tick)
+                {
+        auto &window = windows[{tick.venue, tick.symbol}];
+        window.emplace_back(index++, tick);
+        if (window.size() > static_cast<size_t>(per_instrument))
+            window.pop_front();
+        return true; });
+
+    std::vector<std::pair<size_t, MarketTick>> merged;
+    for (auto &kv : windows)
+        merged.insert(merged.end(), kv.second.begin(), kv.second.end());
+    std::sort(merged.begin(), merged.end(), [](const auto &a, const auto &b)
+              { return a.first < b.first; });
+    out.reserve(merged.size());
+    for (auto &entry : merged)
+        out.push_back(std::move(entry.second));
+    return out;
+}
+
+bool ReplayFeed::pace(int64_t ts_ms, int64_t prev_ts_ms, Schedule &schedule)
+{
+    auto due = [&]
+    {
+        return schedule.wall + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                   std::chrono::duration<double, std::milli>((ts_ms - schedule.ts_ms) / speed_));
+    };
+    if (schedule.gen == control_gen_ && !paused_ && !seek_pending_ && std::chrono::steady_clock::now() >= due())
+        return running_;
+
+    std::unique_lock<std::mutex> lock(control_mutex_);
+    for (;;)
+    {
+        if (!running_ || seek_pending_)
+            return false;
+        if (paused_)
         {
-            ingest_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-                            std::chrono::system_clock::now().time_since_epoch())
-                            .count();
+            control_cv_.wait(lock);
+            continue;
         }
-        tick.ingest_ts_ms = ingest_ms;
-        if (prev_ts > 0)
+        // Start of a scan, or resumed / re-timed: the last tick emitted happened now
+        if (schedule.gen != control_gen_)
+            schedule = Schedule{std::chrono::steady_clock::now(), prev_ts_ms >= 0 ? prev_ts_ms : ts_ms, control_gen_};
+        auto at = due();
+        if (std::chrono::steady_clock::now() >= at)
+            return true;
+        control_cv_.wait_until(lock, at);
+    }
+}
+
+void ReplayFeed::run()
+{
+    setTraceThreadName("feed");
+    auto index_start = std::chrono::steady_clock::now();
+    TickStore store(file_path_);
+    if (!store.open())
+    {
+        std::cerr << "Failed to open replay file " << file_path_ << std::endl;
+        return;
+    }
+    std::cout << "Indexed " << store.ticks() << " replay ticks (" << store.indexEntries() << " index entries) in "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - index_start).count()
+              << " ms" << std::endl;
+
+    TickIndexEntry from = store.begin();
+    int64_t from_ts = std::numeric_limits<int64_t>::min();
+    while (running_)
+    {
+        if (seek_pending_)
         {
-            int64_t delta = static_cast<int64_t>((ingest_ms - prev_ts) / speed_);
-            if (delta > 0)
-            {
-                std::this_thread::sleep_for(std::chrono::milliseconds(delta));
-            }
+            std::lock_guard<std::mutex> lock(control_mutex_);
+            if (TickStore::parseTime(seek_to_, store.firstTs(), from_ts))
+                from = store.seek(from_ts);
+            seek_pending_ = false;
         }
-        prev_ts = ingest_ms;
-        if (on_tick_)
-            on_tick_(tick);
+        int64_t prev_ts = -1;
+        Schedule schedule;
+        store.scan(from, [&](MarketTick &tick)
+                   {
+            int64_t ingest_ms = tick.ingest_ts_ms;
+            // Resume points are up to one index interval early
+            if (ingest_ms < from_ts)
+                return running_ && !seek_pending_;
+            if (!pace(ingest_ms, prev_ts, schedule))
+                return false;
+            prev_ts = ingest_ms;
+            position_ms_.store(ingest_ms, std::memory_order_relaxed);
+            // Recorded wall-clock stamps are kept; stage latencies start from the replayed emit
+            tick.ingest_ns = steadyNowNs();
+            if (on_tick_)
+                on_tick_(tick);
+            return true; }, decode_threads_);
+        // The scan ends at the end of the file, on stop, or to restart at a seek target. At the
+        // end, hold for a seek back into the recording.
+        std::unique_lock<std::mutex> lock(control_mutex_);
+        control_cv_.wait(lock, [&]
+                         { return !running_ || seek_pending_; });
     }
 }
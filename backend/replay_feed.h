@@ -3,21 +3,74 @@
 #include "data_source.h"
 #include <string>
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
 #include <thread>
+#include <vector>
 
+// Plays a recording back at `speed` times its recorded pace. The feed thread indexes the file
+// (TickStore) before the first tick, so it can be paused, resumed, re-timed and seeked while
+// it plays.
 class ReplayFeed : public IDataSource
 {
 public:
-    explicit ReplayFeed(const std::string &file_path, double speed = 1.0);
+    // decode_threads > 1 decodes NDJSON recordings in parallel chunks (ParallelReplayDecoder)
+    explicit ReplayFeed(const std::string &file_path, double speed = 1.0, int decode_threads = 1);
     ~ReplayFeed();
     void start(std::function<void(const MarketTick &)> on_tick) override;
     void stop() override;
 
+    // Runtime control, from any thread. seek() takes anything TickStore::parseTime accepts
+    // (time of day relative to the recording's first day) and plays on from the first tick at
+    // or after it; false if `when` is not a time.
+    bool seek(const std::string &when);
+    void pause();
+    void resume();
+    // False unless speed > 0
+    bool setSpeed(double speed);
+    bool paused() const { return paused_; }
+    double speed() const { return speed_; }
+    // Ingest stamp of the last tick emitted (0 before the first)
+    int64_t position() const { return position_ms_.load(std::memory_order_relaxed); }
+
+    // Parses one NDJSON recording line; false if it carries no price
+    static bool parseLine(const std::string &line, MarketTick &tick);
+    // One NDJSON recording line for a tick, newline included; parseLine reads it back
+    static std::string toLine(const MarketTick &tick);
+    // Every tick of a recording in file order until on_tick returns false: NDJSON, a binary
+    // TickRecorder file or a TickArchive (both detected by their magic). NDJSON is decoded on decode_threads workers
+    // when above 1; the order is the same either way. False if the file cannot be opened.
+    static bool forEachTick(const std::string &file_path, const std::function<bool(MarketTick &)> &on_tick,
+                            int decode_threads = 1);
+    // The last `per_instrument` ticks of each venue/symbol in a recording, in file order
+    static std::vector<MarketTick> loadRecent(const std::string &file_path, int per_instrument);
+
 private:
     void run();
+    // Replay time ts_ms maps to wall time `wall`; re-anchored whenever control_gen_ moves
+    struct Schedule
+    {
+        std::chrono::steady_clock::time_point wall;
+        int64_t ts_ms{0};
+        uint64_t gen{~0ull};
+    };
+    // Waits until the tick stamped ts_ms is due at the current speed, holding while paused;
+    // false if a seek or stop cut it short. prev_ts_ms is the last tick emitted (-1 if none).
+    bool pace(int64_t ts_ms, int64_t prev_ts_ms, Schedule &schedule);
+    void notifyControl();
+
     std::string file_path_;
-    double speed_;
+    std::atomic<double> speed_;
+    int decode_threads_;
     std::atomic<bool> running_{false};
+    std::atomic<bool> paused_{false};
+    std::atomic<bool> seek_pending_{false};
+    std::atomic<uint64_t> control_gen_{0}; // bumped by pause, resume and speed changes
+    std::atomic<int64_t> position_ms_{0};
+    std::string seek_to_; // guarded by control_mutex_
+    std::mutex control_mutex_;
+    std::condition_variable control_cv_;
     std::thread thread_;
     std::function<void(const MarketTick &)> on_tick_;
 };
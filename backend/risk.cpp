@@ -0,0 +1,138 @@
+#include "risk.h"
+#include <cstdlib>
+#include <sstream>
+
+const char *riskRejectName(RiskReject reason)
+{
+    switch (reason)
+    {
+    case RiskReject::NONE:
+        return "none";
+    case RiskReject::MAX_POSITION:
+        return "max_position";
+    case RiskReject::MAX_NOTIONAL:
+        return "max_notional";
+    case RiskReject::RATE_LIMIT:
+        return "rate_limit";
+    case RiskReject::PRICE_BAND:
+        return "price_band";
+    default:
+        return "unknown";
+    }
+}
+
+RiskGate::RiskGate() : accepted_(0)
+{
+    for (auto &counter : rejected_)
+        counter = 0;
+}
+
+void RiskGate::setDefaultLimits(const RiskLimits &limits)
+{
+    default_limits_ = limits;
+}
+
+void RiskGate::setLimits(const InstrumentId &id, const RiskLimits &limits)
+{
+    applyLimits(instrument(id), limits);
+}
+
+void RiskGate::setPosition(const InstrumentId &id, int position)
+{
+    instrument(id).position = position;
+}
+
+void RiskGate::applyLimits(InstrumentState &state, const RiskLimits &limits)
+{
+    state.limits = limits;
+    state.bucket_capacity = limits.max_orders_per_sec >= 1.0 ? limits.max_orders_per_sec : 1.0;
+    state.tokens = state.bucket_capacity;
+    state.last_refill_ns = steadyNowNs();
+}
+
+RiskGate::InstrumentState &RiskGate::instrument(const InstrumentId &id)
+{
+    auto it = instruments_.find(id);
+    if (it != instruments_.end())
+        return it->second;
+    InstrumentState &state = instruments_[id];
+    applyLimits(state, default_limits_);
+    return state;
+}
+
+void RiskGate::onMarketTick(const MarketTick &tick)
+{
+    InstrumentState &state = instrument(InstrumentId(tick.venue, tick.symbol));
+    double band = state.limits.price_band_pct / 100.0;
+    state.band_low = tick.price * (1.0 - band);
+    state.band_high = tick.price * (1.0 + band);
+}
+
+RiskReject RiskGate::reject(RiskReject reason)
+{
+    rejected_[static_cast<int>(reason)].fetch_add(1, std::memory_order_relaxed);
+    return reason;
+}
+
+RiskReject RiskGate::check(const Order &order)
+{
+    InstrumentState &state = instrument(InstrumentId(order.venue, order.symbol));
+    const RiskLimits &limits = state.limits;
+
+    if (limits.price_band_pct > 0.0 && state.band_high > 0.0 &&
+        (order.price < state.band_low || order.price > state.band_high))
+        return reject(RiskReject::PRICE_BAND);
+
+    int next_position = state.position + (order.side == OrderSide::BUY ? order.quantity : -order.quantity);
+    if (limits.max_position > 0 && std::abs(next_position) > limits.max_position)
+        return reject(RiskReject::MAX_POSITION);
+    if (limits.max_notional > 0.0 && std::abs(next_position) * order.price > limits.max_notional)
+        return reject(RiskReject::MAX_NOTIONAL);
+
+    if (limits.max_orders_per_sec > 0.0)
+    {
+        int64_t now_ns = steadyNowNs();
+        state.tokens += (now_ns - state.last_refill_ns) * 1e-9 * limits.max_orders_per_sec;
+        if (state.tokens > state.bucket_capacity)
+            state.tokens = state.bucket_capacity;
+        state.last_refill_ns = now_ns;
+        if (state.tokens < 1.0)
+            return reject(RiskReject::RATE_LIMIT);
+        state.tokens -= 1.0;
+    }
+
+    // Orders fill in full at their own price, so the accepted position is the book's position
+    state.position = next_position;
+    accepted_.fetch_add(1, std::memory_order_relaxed);
+    return RiskReject::NONE;
+}
+
+uint64_t RiskGate::getAccepted() const
+{
+    return accepted_.load(std::memory_order_relaxed);
+}
+
+uint64_t RiskGate::getRejected(RiskReject reason) const
+{
+    return rejected_[static_cast<int>(reason)].load(std::memory_order_relaxed);
+}
+
+uint64_t RiskGate::getRejectedTotal() const
+{
+    uint64_t total = 0;
+    for (const auto &counter : rejected_)
+        total += counter.load(std::memory_order_relaxed);
+    return total;
+}
+
+std::string RiskGate::statsToText() const
+{
+    std::ostringstream oss;
+    oss << "accepted=" << getAccepted() << "\n";
+    for (int i = static_cast<int>(RiskReject::MAX_POSITION); i < static_cast<int>(RiskReject::COUNT); ++i)
+    {
+        auto reason = static_cast<RiskReject>(i);
+        oss << "rejected_" << riskRejectName(reason) << "=" << getRejected(reason) << "\n";
+    }
+    return oss.str();
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <atomic>
+#include <cstdint>
+#include "data_source.h"
+#include "order_book.h"
+
+// A limit of zero disables that check
+struct RiskLimits
+{
+    int max_position{10000};        // absolute net quantity per instrument
+    double max_notional{0.0};       // absolute net notional per instrument
+    double max_orders_per_sec{50.0}; // token bucket refill rate (burst = one second's worth)
+    double price_band_pct{5.0};     // max distance of order price from the last tick, in percent
+};
+
+enum class RiskReject
+{
+    NONE,
+    MAX_POSITION,
+    MAX_NOTIONAL,
+    RATE_LIMIT,
+    PRICE_BAND,
+    COUNT
+};
+
+const char *riskRejectName(RiskReject reason);
+
+// Pre-trade checks in front of the order path. check() and onMarketTick() run on the
+// feed thread; counters may be read from any thread.
+class RiskGate
+{
+public:
+    RiskGate();
+
+    void setDefaultLimits(const RiskLimits &limits);
+    void setLimits(const InstrumentId &instrument, const RiskLimits &limits);
+    // Seeds the tracked position, e.g. after restoring book state
+    void setPosition(const InstrumentId &instrument, int position);
+
+    // Moves the reference price used by the fat-finger band
+    void onMarketTick(const MarketTick &tick);
+    RiskReject check(const Order &order);
+
+    uint64_t getAccepted() const;
+    uint64_t getRejected(RiskReject reason) const;
+    uint64_t getRejectedTotal() const;
+    std::string statsToText() const;
+
+private:
+    struct InstrumentState
+    {
+        RiskLimits limits;
+        // Precomputed from limits and the last tick so check() is a handful of compares
+        double band_low{0.0};
+        double band_high{0.0};
+        double bucket_capacity{0.0};
+        double tokens{0.0};
+        int64_t last_refill_ns{0};
+        int position{0};
+    };
+
+    InstrumentState &instrument(const InstrumentId &id);
+    void applyLimits(InstrumentState &state, const RiskLimits &limits);
+    RiskReject reject(RiskReject reason);
+
+    RiskLimits default_limits_;
+    std::unordered_map<InstrumentId, InstrumentState> instruments_;
+
+    std::atomic<uint64_t> accepted_;
+    std::atomic<uint64_t> rejected_[static_cast<int>(RiskReject::COUNT)];
+};
@@ -0,0 +1,227 @@
+#include "sharded_engine.h"
+#include "strategies/strategy_factory.h"
+#include "trace.h"
+#include <chrono>
+#include <iostream>
+#include <pthread.h>
+#include <sched.h>
+#include <sstream>
+
+uint32_t SymbolTable::intern(const std::string &symbol)
+{
+    auto it = ids_.find(symbol);
+    if (it != ids_.end())
+        return it->second;
+    uint32_t id = static_cast<uint32_t>(names_.size());
+    names_.push_back(symbol);
+    ids_.emplace(symbol, id);
+    return id;
+}
+
+EngineShard::EngineShard(int index, int core, const ShardedEngineConfig &cfg, const ShardExecuteFn &execute,
+                         const std::function<void(const Trade &)> &on_trade)
+    : index_(index), core_(core), cfg_(cfg), execute_(execute), on_trade_(on_trade), queue_(16384)
+{
+}
+
+EngineShard::~EngineShard()
+{
+    stop();
+}
+
+void EngineShard::start()
+{
+    if (running_)
+        return;
+    running_ = true;
+    thread_ = std::thread(&EngineShard::run, this);
+}
+
+void EngineShard::stop()
+{
+    if (!running_)
+        return;
+    running_ = false;
+    if (thread_.joinable())
+        thread_.join();
+}
+
+bool EngineShard::enqueue(uint32_t symbol_id, const MarketTick &tick)
+{
+    if (queue_.tryPush(QueuedTick{symbol_id, tick}))
+        return true;
+    stats_.dropped.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+void EngineShard::warmUp(uint32_t symbol_id, const MarketTick &tick)
+{
+    IStrategy &strategy = *lane(symbol_id).strategy;
+    IStrategy::OrderMute mute(strategy);
+    strategy.onMarketTick(tick);
+}
+
+EngineShard::Lane &EngineShard::lane(uint32_t symbol_id)
+{
+    auto it = lanes_.find(symbol_id);
+    if (it != lanes_.end())
+        return *it->second;
+
+    auto lane = std::make_unique<Lane>();
+    lane->risk_gate.setDefaultLimits(cfg_.risk_limits);
+    lane->strategy = makeStrategy(cfg_.strategy, lane->order_book);
+    if (!lane->strategy)
+        lane->strategy = makeStrategy("momentum", lane->order_book);
+    lane->strategy->setLookback(cfg_.strategy_lookback);
+    lane->strategy->setOrderQuantity(cfg_.strategy_order_qty);
+    lane->order_book.setBookId(symbol_id + 1);
+    Lane *raw = lane.get();
+    lane->strategy->on_order = [this, raw](const Order &order)
+    {
+        if (raw->risk_gate.check(order) != RiskReject::NONE)
+            return;
+        execute_(raw->order_book, order);
+    };
+    if (on_trade_)
+        lane->order_book.setTradeCallback(on_trade_);
+    lanes_.emplace(symbol_id, std::move(lane));
+    lane_count_.store(lanes_.size(), std::memory_order_relaxed);
+    return *raw;
+}
+
+void EngineShard::publishStats()
+{
+    double realized = 0.0;
+    double unrealized = 0.0;
+    // Relaxed loads of each lane book's published totals: no lane lock on the shard thread
+    for (const auto &kv : lanes_)
+    {
+        realized += kv.second->order_book.getPublishedPnL();
+        unrealized += kv.second->order_book.getPublishedUnrealizedPnL();
+    }
+    stats_.realized_pnl.store(realized, std::memory_order_relaxed);
+    stats_.unrealized_pnl.store(unrealized, std::memory_order_relaxed);
+}
+
+void EngineShard::run()
+{
+    setTraceThreadName(("shard " + std::to_string(index_)).c_str());
+    if (core_ >= 0)
+    {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(core_, &set);
+        if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0)
+            std::cerr << "Shard " << index_ << ": failed to pin to core " << core_ << std::endl;
+    }
+
+    QueuedTick item;
+    int idle_spins = 0;
+    while (running_)
+    {
+        uint64_t processed = 0;
+        while (queue_.tryPop(item))
+        {
+            Lane &l = lane(item.symbol_id);
+            l.order_book.markToMarket(item.tick);
+            l.risk_gate.onMarketTick(item.tick);
+            {
+                TraceScope trace("onMarketTick");
+                l.strategy->onMarketTick(item.tick);
+            }
+            ++processed;
+        }
+        if (processed > 0)
+        {
+            stats_.ticks.fetch_add(processed, std::memory_order_relaxed);
+            publishStats();
+            idle_spins = 0;
+        }
+        else if (++idle_spins > 1000)
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+}
+
+ShardedEngine::ShardedEngine(const ShardedEngineConfig &cfg, ShardExecuteFn execute, std::function<void(const Trade &)> on_trade)
+{
+    int cores = static_cast<int>(std::thread::hardware_concurrency());
+    int count = cfg.shards > 0 ? cfg.shards : 1;
+    for (int i = 0; i < count; ++i)
+    {
+        int core = cores > 0 ? (cfg.first_core + i) % cores : -1;
+        shards_.push_back(std::make_unique<EngineShard>(i, core, cfg, execute, on_trade));
+    }
+}
+
+ShardedEngine::~ShardedEngine()
+{
+    stop();
+}
+
+void ShardedEngine::start()
+{
+    for (auto &shard : shards_)
+        shard->start();
+}
+
+void ShardedEngine::stop()
+{
+    for (auto &shard : shards_)
+        shard->stop();
+}
+
+void ShardedEngine::warmUp(const std::vector<MarketTick> &ticks)
+{
+    for (const auto &tick : ticks)
+    {
+        uint32_t id = symbols_.intern(tick.symbol);
+        shards_[id % shards_.size()]->warmUp(id, tick);
+    }
+}
+
+void ShardedEngine::onTick(const MarketTick &tick)
+{
+    uint32_t id = symbols_.intern(tick.symbol);
+    shards_[id % shards_.size()]->enqueue(id, tick);
+}
+
+double ShardedEngine::getRealizedPnL() const
+{
+    double total = 0.0;
+    for (const auto &shard : shards_)
+        total += shard->getRealizedPnL();
+    return total;
+}
+
+double ShardedEngine::getUnrealizedPnL() const
+{
+    double total = 0.0;
+    for (const auto &shard : shards_)
+        total += shard->getUnrealizedPnL();
+    return total;
+}
+
+uint64_t ShardedEngine::getDropped() const
+{
+    uint64_t total = 0;
+    for (const auto &shard : shards_)
+        total += shard->getDropped();
+    return total;
+}
+
+std::string ShardedEngine::statsToText() const
+{
+    std::ostringstream oss;
+    for (size_t i = 0; i < shards_.size(); ++i)
+    {
+        const auto &shard = *shards_[i];
+        oss << "shard" << i << "_symbols=" << shard.getLanes() << "\n";
+        oss << "shard" << i << "_ticks=" << shard.getTicks() << "\n";
+        oss << "shard" << i << "_dropped=" << shard.getDropped() << "\n";
+        oss << "shard" << i << "_realized_pnl=" << shard.getRealizedPnL() << "\n";
+        oss << "shard" << i << "_unrealized_pnl=" << shard.getUnrealizedPnL() << "\n";
+    }
+    return oss.str();
+}
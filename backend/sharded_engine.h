@@ -0,0 +1,130 @@
+#pragma once
+
+#include "data_source.h"
+#include "order_book.h"
+#include "risk.h"
+#include "lockfree_queue.h"
+#include "strategies/strategy_base.h"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Dense ids for symbols; interning happens on the router thread only
+class SymbolTable
+{
+public:
+    uint32_t intern(const std::string &symbol);
+    size_t size() const { return names_.size(); }
+
+private:
+    std::unordered_map<std::string, uint32_t> ids_;
+    std::vector<std::string> names_;
+};
+
+struct ShardedEngineConfig
+{
+    int shards{1};
+    int first_core{0};
+    std::string strategy{"momentum"};
+    int strategy_lookback{3};
+    int strategy_order_qty{100};
+    RiskLimits risk_limits;
+};
+
+// Hands an accepted order to the execution path for the book it belongs to
+using ShardExecuteFn = std::function<void(OrderBook &, const Order &)>;
+
+// One core's worth of work: a strategy instance, order book and risk gate per symbol routed
+// to it. Only the shard thread touches lanes; PnL is published via atomics.
+class EngineShard
+{
+public:
+    EngineShard(int index, int core, const ShardedEngineConfig &cfg, const ShardExecuteFn &execute,
+                const std::function<void(const Trade &)> &on_trade);
+    ~EngineShard();
+
+    void start();
+    void stop();
+    bool enqueue(uint32_t symbol_id, const MarketTick &tick);
+    // Feeds a recorded tick to the symbol's strategy with orders muted; call before start()
+    void warmUp(uint32_t symbol_id, const MarketTick &tick);
+
+    double getRealizedPnL() const { return stats_.realized_pnl.load(std::memory_order_relaxed); }
+    double getUnrealizedPnL() const { return stats_.unrealized_pnl.load(std::memory_order_relaxed); }
+    uint64_t getTicks() const { return stats_.ticks.load(std::memory_order_relaxed); }
+    uint64_t getDropped() const { return stats_.dropped.load(std::memory_order_relaxed); }
+    size_t getLanes() const { return lane_count_.load(std::memory_order_relaxed); }
+
+private:
+    struct QueuedTick
+    {
+        uint32_t symbol_id;
+        MarketTick tick;
+    };
+
+    struct Lane
+    {
+        OrderBook order_book;
+        RiskGate risk_gate;
+        std::unique_ptr<IStrategy> strategy;
+    };
+
+    // Written by the shard thread, read lock-free by reporters
+    struct alignas(64) Stats
+    {
+        std::atomic<double> realized_pnl{0.0};
+        std::atomic<double> unrealized_pnl{0.0};
+        std::atomic<uint64_t> ticks{0};
+        std::atomic<uint64_t> dropped{0};
+    };
+
+    void run();
+    Lane &lane(uint32_t symbol_id);
+    void publishStats();
+
+    int index_;
+    int core_;
+    ShardedEngineConfig cfg_;
+    ShardExecuteFn execute_;
+    std::function<void(const Trade &)> on_trade_;
+
+    BoundedQueue<QueuedTick> queue_;
+    std::unordered_map<uint32_t, std::unique_ptr<Lane>> lanes_;
+    std::atomic<size_t> lane_count_{0};
+    Stats stats_;
+
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+};
+
+// Routes ticks to shards by interned symbol id and aggregates portfolio PnL across them
+class ShardedEngine
+{
+public:
+    ShardedEngine(const ShardedEngineConfig &cfg, ShardExecuteFn execute, std::function<void(const Trade &)> on_trade);
+    ~ShardedEngine();
+
+    void start();
+    void stop();
+
+    // Routes recorded ticks to their shards' strategies with orders muted; call before start()
+    void warmUp(const std::vector<MarketTick> &ticks);
+
+    // Call from a single feed thread
+    void onTick(const MarketTick &tick);
+
+    double getRealizedPnL() const;
+    double getUnrealizedPnL() const;
+    // Ticks dropped because a shard queue was full, summed over shards
+    uint64_t getDropped() const;
+    std::string statsToText() const;
+
+private:
+    SymbolTable symbols_;
+    std::vector<std::unique_ptr<EngineShard>> shards_;
+};
@@ -0,0 +1,109 @@
+#include "snapshot.h"
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <unistd.h>
+
+SnapshotWriter::SnapshotWriter(OrderBook &order_book, const std::string &path, int interval_ms, uint64_t epoch)
+    : order_book_(order_book), path_(path), interval_ms_(interval_ms), epoch_(epoch), last_trade_count_(-1), running_(false)
+{
+}
+
+SnapshotWriter::~SnapshotWriter()
+{
+    stop();
+}
+
+void SnapshotWriter::start()
+{
+    if (running_)
+        return;
+    running_ = true;
+    thread_ = std::thread(&SnapshotWriter::run, this);
+}
+
+void SnapshotWriter::stop()
+{
+    if (!running_)
+        return;
+    running_ = false;
+    if (thread_.joinable())
+        thread_.join();
+    // Final snapshot so a clean shutdown always restores to the latest state
+    writeNow();
+}
+
+bool SnapshotWriter::writeNow()
+{
+    std::string data = order_book_.serializeSnapshot(epoch_);
+    std::string tmp_path = path_ + ".tmp";
+    int fd = ::open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+        return false;
+    size_t off = 0;
+    while (off < data.size())
+    {
+        ssize_t n = ::write(fd, data.data() + off, data.size() - off);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+        {
+            ::close(fd);
+            return false;
+        }
+        off += static_cast<size_t>(n);
+    }
+    // The data must be on disk before the rename makes it the snapshot, or a crash can leave an
+    // empty or short file under the real name
+    if (::fsync(fd) != 0)
+    {
+        ::close(fd);
+        return false;
+    }
+    if (::close(fd) != 0)
+        return false;
+    if (std::rename(tmp_path.c_str(), path_.c_str()) != 0)
+        return false;
+    // Persist the rename itself
+    std::string dir = path_.find('/') == std::string::npos ? std::string(".") : path_.substr(0, path_.rfind('/'));
+    if (dir.empty())
+        dir = "/";
+    int dir_fd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY);
+    if (dir_fd < 0)
+        return false;
+    bool synced = ::fsync(dir_fd) == 0;
+    ::close(dir_fd);
+    return synced;
+}
+
+bool SnapshotWriter::restore(OrderBook &order_book, const std::string &path, uint64_t *epoch)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open())
+        return false;
+    std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    return order_book.restoreSnapshot(data, epoch);
+}
+
+void SnapshotWriter::run()
+{
+    while (running_)
+    {
+        // Only rewrite when fills have happened since the last snapshot
+        int trade_count = order_book_.getTradeCount();
+        if (trade_count != last_trade_count_)
+        {
+            if (writeNow())
+                last_trade_count_ = trade_count;
+            else
+                std::cerr << "Failed to write snapshot " << path_ << std::endl;
+        }
+
+        for (int waited = 0; running_ && waited < interval_ms_; waited += 10)
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+}
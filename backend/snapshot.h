@@ -0,0 +1,36 @@
+#pragma once
+
+#include "order_book.h"
+#include <string>
+#include <atomic>
+#include <thread>
+
+// Periodically persists OrderBook state to disk from a background thread
+class SnapshotWriter
+{
+public:
+    // epoch: the running journal epoch, stored in each snapshot so a restore knows which
+    // journaled fills it already contains
+    SnapshotWriter(OrderBook &order_book, const std::string &path, int interval_ms = 1000, uint64_t epoch = 0);
+    ~SnapshotWriter();
+
+    void start();
+    void stop();
+
+    // Writes to a temp file, fsyncs it, renames it over the target and fsyncs the directory, so
+    // neither readers nor a crash ever leave a torn snapshot behind
+    bool writeNow();
+
+    static bool restore(OrderBook &order_book, const std::string &path, uint64_t *epoch = nullptr);
+
+private:
+    void run();
+
+    OrderBook &order_book_;
+    std::string path_;
+    int interval_ms_;
+    uint64_t epoch_;
+    int last_trade_count_;
+    std::atomic<bool> running_;
+    std::thread thread_;
+};
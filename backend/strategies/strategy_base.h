@@ -1,16 +1,109 @@
 #pragma once
 
+#include "bars.h"
 #include "data_source.h"
 #include "order_book.h"
+#include "indicators.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <utility>
 
 class IStrategy
 {
 public:
     virtual ~IStrategy() = default;
     std::function<void(const Order &)> on_order;
+    // Several orders decided on one tick (spread legs, hedges) handed over as one contiguous
+    // batch; when unset, batches fall back to one on_order call per order
+    std::function<void(const Order *, size_t)> on_order_batch;
     virtual void onMarketTick(const MarketTick &tick) = 0;
     virtual void setLookback(int lookback) = 0;
     virtual void setOrderQuantity(int quantity) = 0;
     virtual const char *name() const = 0;
+
+    // Shared-indicator mode: the runner owns the registry, updates it once per tick and calls
+    // onSharedTick with the resulting snapshot instead of onMarketTick
+    virtual void declareIndicators(IndicatorRegistry &) {}
+    virtual void onSharedTick(const MarketTick &tick, const IndicatorSnapshot &) { onMarketTick(tick); }
+
+    // Bar mode: called once per closed bar instead of per tick. By default the bar is seen as a
+    // tick at its close price carrying the bar's volume.
+    virtual void onBar(const Bar &bar) { onMarketTick(barToTick(bar)); }
+
+    // Backtest path: given one instrument's whole price and size columns, writes the signed quantity
+    // onMarketTick would order at each tick (+buy, -sell, 0 none) using the batch kernels in
+    // indicator_kernels.h. Reads the configured parameters but not the per-tick state.
+    // Returns false if the strategy has no batch form.
+    virtual bool precompute(const double *, const double *, size_t, int32_t *) const { return false; }
+
+    // Detaches the order callbacks while alive, so replaying recorded ticks into the strategy
+    // (warm-up) builds its state without emitting anything
+    class OrderMute
+    {
+    public:
+        explicit OrderMute(IStrategy &strategy)
+            : strategy_(strategy), on_order_(std::move(strategy.on_order)), on_order_batch_(std::move(strategy.on_order_batch))
+        {
+            strategy.on_order = nullptr;
+            strategy.on_order_batch = nullptr;
+        }
+        ~OrderMute()
+        {
+            strategy_.on_order = std::move(on_order_);
+            strategy_.on_order_batch = std::move(on_order_batch_);
+        }
+        OrderMute(const OrderMute &) = delete;
+        OrderMute &operator=(const OrderMute &) = delete;
+
+    private:
+        IStrategy &strategy_;
+        std::function<void(const Order &)> on_order_;
+        std::function<void(const Order *, size_t)> on_order_batch_;
+    };
+
+protected:
+    // Every strategy implements `template <typename Sink> void process(const MarketTick &, Sink &)`.
+    // The virtual path instantiates it with this sink; StaticPipeline instantiates it with its own
+    // so the whole tick->order chain can be inlined.
+    // Sinks take single orders and (const Order *, size_t) batches.
+    struct OrderCallbackSink
+    {
+        IStrategy &strategy;
+        void operator()(const Order &order) const
+        {
+            if (strategy.on_order)
+                strategy.on_order(order);
+        }
+        void operator()(const Order *orders, size_t count) const
+        {
+            if (strategy.on_order_batch)
+                strategy.on_order_batch(orders, count);
+            else if (strategy.on_order)
+            {
+                for (size_t i = 0; i < count; ++i)
+                    strategy.on_order(orders[i]);
+            }
+        }
+    };
+
+    Order makeOrder(const MarketTick &tick, OrderSide side, double price, int quantity)
+    {
+        Order o;
+        o.id = ++order_counter_;
+        o.venue = tick.venue;
+        o.symbol = tick.symbol;
+        o.side = side;
+        o.price = price;
+        o.quantity = quantity;
+        o.timestamp = std::chrono::system_clock::now();
+        o.exchange_recv_ts_ms = tick.exchange_recv_ts_ms;
+        o.ingest_ts_ms = tick.ingest_ts_ms;
+        o.ingest_ns = tick.ingest_ns;
+        o.created_ns = steadyNowNs();
+        return o;
+    }
+
+    uint64_t order_counter_{0};
 };
@@ -1,57 +1,45 @@
 #include "strategy_bollinger.h"
-#include <chrono>
-#include <cmath>
+#include "indicator_kernels.h"
+#include <vector>
 
 void BollingerStrategy::onMarketTick(const MarketTick &tick)
 {
-    auto &px = prices_[tick.venue];
-    px.push_back(tick.price);
-    if (px.size() > static_cast<size_t>(period_))
-        px.pop_front();
-    if (px.size() < static_cast<size_t>(period_))
-        return;
+    OrderCallbackSink sink{*this};
+    process(tick, sink);
+}
 
-    double sum = 0.0;
-    for (double p : px)
-        sum += p;
-    double mean = sum / px.size();
-    double var = 0.0;
-    for (double p : px)
-        var += (p - mean) * (p - mean);
-    var /= px.size();
-    double sd = std::sqrt(var);
-    double upper = mean + k_ * sd;
-    double lower = mean - k_ * sd;
-    double last = px.back();
+void BollingerStrategy::onSharedTick(const MarketTick &tick, const IndicatorSnapshot &indicators)
+{
+    OrderCallbackSink sink{*this};
+    decide(tick, indicators, sink);
+}
 
-    if (last < lower)
-    {
-        Order o;
-        o.id = "O" + std::to_string(++order_counter_);
-        o.venue = tick.venue;
-        o.symbol = tick.symbol;
-        o.side = OrderSide::BUY;
-        o.price = last;
-        o.quantity = order_qty_;
-        o.timestamp = std::chrono::system_clock::now();
-        o.exchange_recv_ts_ms = tick.exchange_recv_ts_ms;
-        o.ingest_ts_ms = tick.ingest_ts_ms;
-        if (on_order)
-            on_order(o);
-    }
-    else if (last > upper)
+void BollingerStrategy::declareIndicators(IndicatorRegistry &registry)
+{
+    indicators_ = &registry;
+    mean_ = registry.declare({IndicatorType::SMA, period_});
+    stddev_ = registry.declare({IndicatorType::STDDEV, period_});
+}
+
+void BollingerStrategy::setLookback(int lookback)
+{
+    if (lookback <= 0)
+        return;
+    period_ = lookback;
+    if (indicators_ == &own_indicators_)
+        own_indicators_.clear();
+    declareIndicators(*indicators_);
+}
+
+bool BollingerStrategy::precompute(const double *price, const double *, size_t n, int32_t *orders) const
+{
+    std::vector<double> mean(n), sd(n);
+    rollingMeanStd(price, n, period_, mean.data(), sd.data());
+    for (size_t i = 0; i < n; ++i)
     {
-        Order o;
-        o.id = "O" + std::to_string(++order_counter_);
-        o.venue = tick.venue;
-        o.symbol = tick.symbol;
-        o.side = OrderSide::SELL;
-        o.price = last;
-        o.quantity = order_qty_;
-        o.timestamp = std::chrono::system_clock::now();
-        o.exchange_recv_ts_ms = tick.exchange_recv_ts_ms;
-        o.ingest_ts_ms = tick.ingest_ts_ms;
-        if (on_order)
-            on_order(o);
+        double upper = mean[i] + k_ * sd[i];
+        double lower = mean[i] - k_ * sd[i];
+        orders[i] = price[i] < lower ? order_qty_ : price[i] > upper ? -order_qty_ : 0;
     }
+    return true;
 }
@@ -1,23 +1,50 @@
 #pragma once
 
 #include "strategy_base.h"
-#include <deque>
-#include <map>
 
-class BollingerStrategy : public IStrategy
+class BollingerStrategy final : public IStrategy
 {
 public:
-    explicit BollingerStrategy(OrderBook &order_book) : order_book_(order_book) {}
+    explicit BollingerStrategy(OrderBook &order_book) : order_book_(order_book) { declareIndicators(own_indicators_); }
     void onMarketTick(const MarketTick &tick) override;
-    void setLookback(int lookback) override { period_ = lookback > 0 ? lookback : period_; }
+    void onSharedTick(const MarketTick &tick, const IndicatorSnapshot &indicators) override;
+    void declareIndicators(IndicatorRegistry &registry) override;
+    void setLookback(int lookback) override;
     void setOrderQuantity(int quantity) override { order_qty_ = quantity; }
     const char *name() const override { return "bollinger"; }
+    bool precompute(const double *price, const double *size, size_t n, int32_t *orders) const override;
+
+    // Standalone path: advances the strategy's own indicators
+    template <typename Sink>
+    void process(const MarketTick &tick, Sink &sink) { decide(tick, own_indicators_.update(tick), sink); }
 
 private:
+    template <typename Sink>
+    void decide(const MarketTick &tick, const IndicatorSnapshot &indicators, Sink &sink);
+
     OrderBook &order_book_;
-    std::map<std::string, std::deque<double>> prices_;
+    IndicatorRegistry own_indicators_;
+    IndicatorRegistry *indicators_{nullptr};
+    int mean_{-1};
+    int stddev_{-1};
     int period_{20};
     double k_{2.0};
     int order_qty_{100};
-    int order_counter_{0};
 };
+
+template <typename Sink>
+void BollingerStrategy::decide(const MarketTick &tick, const IndicatorSnapshot &indicators, Sink &sink)
+{
+    if (!indicators.ready(mean_) || !indicators.ready(stddev_))
+        return;
+    double mean = indicators.value(mean_);
+    double sd = indicators.value(stddev_);
+    double upper = mean + k_ * sd;
+    double lower = mean - k_ * sd;
+    double last = tick.price;
+
+    if (last < lower)
+        sink(makeOrder(tick, OrderSide::BUY, last, order_qty_));
+    else if (last > upper)
+        sink(makeOrder(tick, OrderSide::SELL, last, order_qty_));
+}
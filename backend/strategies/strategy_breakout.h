@@ -4,7 +4,7 @@
 #include <deque>
 #include <map>
 
-class BreakoutStrategy : public IStrategy
+class BreakoutStrategy final : public IStrategy
 {
 public:
     explicit BreakoutStrategy(OrderBook &order_book) : order_book_(order_book) {}
@@ -12,11 +12,41 @@ public:
     void setLookback(int lookback) override { lookback_ = lookback; }
     void setOrderQuantity(int quantity) override { order_qty_ = quantity; }
     const char *name() const override { return "breakout"; }
+    bool precompute(const double *price, const double *size, size_t n, int32_t *orders) const override;
+
+    template <typename Sink>
+    void process(const MarketTick &tick, Sink &sink);
 
 private:
     OrderBook &order_book_;
-    std::map<std::string, std::deque<double>> window_;
+    std::map<InstrumentId, std::deque<double>> window_;
     int lookback_{20};
     int order_qty_{100};
-    int order_counter_{0};
 };
+
+template <typename Sink>
+void BreakoutStrategy::process(const MarketTick &tick, Sink &sink)
+{
+    auto &dq = window_[InstrumentId(tick.venue, tick.symbol)];
+    dq.push_back(tick.price);
+    if (dq.size() > static_cast<size_t>(lookback_))
+        dq.pop_front();
+    if (dq.size() < static_cast<size_t>(lookback_))
+        return;
+
+    double highest = dq.front();
+    double lowest = dq.front();
+    for (double p : dq)
+    {
+        if (p > highest)
+            highest = p;
+        if (p < lowest)
+            lowest = p;
+    }
+    double last = dq.back();
+
+    if (last > highest)
+        sink(makeOrder(tick, OrderSide::BUY, last, order_qty_));
+    else if (last < lowest)
+        sink(makeOrder(tick, OrderSide::SELL, last, order_qty_));
+}
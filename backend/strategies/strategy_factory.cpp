@@ -0,0 +1,32 @@
+#include "strategies/strategy_factory.h"
+#include "strategies/strategy_momentum.h"
+#include "strategies/strategy_mean_reversion.h"
+#include "strategies/strategy_breakout.h"
+#include "strategies/strategy_vwap_reversion.h"
+#include "strategies/strategy_macd.h"
+#include "strategies/strategy_rsi.h"
+#include "strategies/strategy_bollinger.h"
+
+std::unique_ptr<IStrategy> makeStrategy(const std::string &name, OrderBook &order_book)
+{
+    if (name == "momentum")
+        return std::make_unique<MomentumStrategy>(order_book);
+    if (name == "mean_reversion")
+        return std::make_unique<MeanReversionStrategy>(order_book);
+    if (name == "breakout")
+        return std::make_unique<BreakoutStrategy>(order_book);
+    if (name == "vwap_reversion")
+        return std::make_unique<VwapReversionStrategy>(order_book);
+    if (name == "macd")
+        return std::make_unique<MacdStrategy>(order_book);
+    if (name == "rsi")
+        return std::make_unique<RsiStrategy>(order_book);
+    if (name == "bollinger")
+        return std::make_unique<BollingerStrategy>(order_book);
+    return nullptr;
+}
+
+std::vector<std::string> strategyNames()
+{
+    return {"momentum", "mean_reversion", "breakout", "vwap_reversion", "macd", "rsi", "bollinger"};
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+#include "strategies/strategy_base.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+// Builds a strategy by its name(); returns nullptr for unknown names
+std::unique_ptr<IStrategy> makeStrategy(const std::string &name, OrderBook &order_book);
+std::vector<std::string> strategyNames();
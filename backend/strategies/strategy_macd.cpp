@@ -1,63 +1,58 @@
 #include "strategy_macd.h"
-#include <chrono>
+#include "indicator_kernels.h"
+#include <algorithm>
+#include <vector>
 
-static double ema(const std::deque<double> &x, int period)
+void MacdStrategy::onMarketTick(const MarketTick &tick)
 {
-    if (period <= 1 || x.empty())
-        return x.back();
-    double k = 2.0 / (period + 1);
-    double ema = x.front();
-    for (size_t i = 1; i < x.size(); ++i)
-        ema = x[i] * k + ema * (1 - k);
-    return ema;
+    OrderCallbackSink sink{*this};
+    process(tick, sink);
 }
 
-void MacdStrategy::onMarketTick(const MarketTick &tick)
+void MacdStrategy::onSharedTick(const MarketTick &tick, const IndicatorSnapshot &indicators)
 {
-    auto &px = prices_[tick.venue];
-    px.push_back(tick.price);
-    if (px.size() > static_cast<size_t>(std::max(long_window_, std::max(short_window_, signal_window_))))
-        px.pop_front();
-    if (px.size() < static_cast<size_t>(long_window_))
-        return;
+    OrderCallbackSink sink{*this};
+    decide(tick, indicators, sink);
+}
 
-    double ema_short = ema(px, short_window_);
-    double ema_long = ema(px, long_window_);
-    double macd = ema_short - ema_long;
-    // rough signal line from macd history; reuse px deque for brevity
-    std::deque<double> macd_series = px;
-    macd_series.back() = macd;
-    double signal = ema(macd_series, signal_window_);
-    double hist = macd - signal;
+void MacdStrategy::declareIndicators(IndicatorRegistry &registry)
+{
+    indicators_ = &registry;
+    ema_short_ = registry.declare({IndicatorType::EMA, short_window_});
+    ema_long_ = registry.declare({IndicatorType::EMA, long_window_});
+}
 
-    if (hist > 0)
-    {
-        Order o;
-        o.id = "O" + std::to_string(++order_counter_);
-        o.venue = tick.venue;
-        o.symbol = tick.symbol;
-        o.side = OrderSide::BUY;
-        o.price = tick.price;
-        o.quantity = order_qty_;
-        o.timestamp = std::chrono::system_clock::now();
-        o.exchange_recv_ts_ms = tick.exchange_recv_ts_ms;
-        o.ingest_ts_ms = tick.ingest_ts_ms;
-        if (on_order)
-            on_order(o);
-    }
-    else if (hist < 0)
+void MacdStrategy::setLookback(int lookback)
+{
+    if (lookback <= 0)
+        return;
+    long_window_ = lookback;
+    if (indicators_ == &own_indicators_)
+        own_indicators_.clear();
+    signal_.clear();
+    declareIndicators(*indicators_);
+}
+
+bool MacdStrategy::precompute(const double *price, const double *, size_t n, int32_t *orders) const
+{
+    std::fill(orders, orders + n, 0);
+    std::vector<double> fast(n), slow(n);
+    emaSeries(price, n, short_window_, fast.data());
+    emaSeries(price, n, long_window_, slow.data());
+    // The signal line starts on the first tick with both EMAs ready and trades once it has
+    // absorbed signal_window_ earlier values
+    size_t first = static_cast<size_t>(std::max({short_window_, long_window_, 1})) - 1;
+    if (n <= first)
+        return true;
+    size_t m = n - first;
+    std::vector<double> macd(m), signal(m);
+    for (size_t j = 0; j < m; ++j)
+        macd[j] = fast[first + j] - slow[first + j];
+    emaSeries(macd.data(), m, signal_window_, signal.data());
+    for (size_t j = static_cast<size_t>(signal_window_); j < m; ++j)
     {
-        Order o;
-        o.id = "O" + std::to_string(++order_counter_);
-        o.venue = tick.venue;
-        o.symbol = tick.symbol;
-        o.side = OrderSide::SELL;
-        o.price = tick.price;
-        o.quantity = order_qty_;
-        o.timestamp = std::chrono::system_clock::now();
-        o.exchange_recv_ts_ms = tick.exchange_recv_ts_ms;
-        o.ingest_ts_ms = tick.ingest_ts_ms;
-        if (on_order)
-            on_order(o);
+        double hist = macd[j] - signal[j];
+        orders[first + j] = hist > 0 ? order_qty_ : hist < 0 ? -order_qty_ : 0;
     }
+    return true;
 }
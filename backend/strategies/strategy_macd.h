@@ -1,24 +1,66 @@
 #pragma once
 
 #include "strategy_base.h"
-#include <deque>
 #include <map>
 
-class MacdStrategy : public IStrategy
+class MacdStrategy final : public IStrategy
 {
 public:
-    explicit MacdStrategy(OrderBook &order_book) : order_book_(order_book) {}
+    explicit MacdStrategy(OrderBook &order_book) : order_book_(order_book) { declareIndicators(own_indicators_); }
     void onMarketTick(const MarketTick &tick) override;
-    void setLookback(int lookback) override { long_window_ = lookback > 0 ? lookback : long_window_; }
+    void onSharedTick(const MarketTick &tick, const IndicatorSnapshot &indicators) override;
+    void declareIndicators(IndicatorRegistry &registry) override;
+    void setLookback(int lookback) override;
     void setOrderQuantity(int quantity) override { order_qty_ = quantity; }
     const char *name() const override { return "macd"; }
+    bool precompute(const double *price, const double *size, size_t n, int32_t *orders) const override;
+
+    // Standalone path: advances the strategy's own indicators
+    template <typename Sink>
+    void process(const MarketTick &tick, Sink &sink) { decide(tick, own_indicators_.update(tick), sink); }
 
 private:
+    // EMA of the MACD line; specific to this strategy so it is kept here, not in the registry
+    struct SignalLine
+    {
+        double value{0.0};
+        int count{0};
+    };
+
+    template <typename Sink>
+    void decide(const MarketTick &tick, const IndicatorSnapshot &indicators, Sink &sink);
+
     OrderBook &order_book_;
-    std::map<std::string, std::deque<double>> prices_;
+    IndicatorRegistry own_indicators_;
+    IndicatorRegistry *indicators_{nullptr};
+    std::map<InstrumentId, SignalLine> signal_;
+    int ema_short_{-1};
+    int ema_long_{-1};
     int short_window_{12};
     int long_window_{26};
     int signal_window_{9};
     int order_qty_{100};
-    int order_counter_{0};
 };
+
+template <typename Sink>
+void MacdStrategy::decide(const MarketTick &tick, const IndicatorSnapshot &indicators, Sink &sink)
+{
+    if (!indicators.ready(ema_short_) || !indicators.ready(ema_long_))
+        return;
+    double macd = indicators.value(ema_short_) - indicators.value(ema_long_);
+
+    SignalLine &line = signal_[InstrumentId(tick.venue, tick.symbol)];
+    double k = 2.0 / (signal_window_ + 1);
+    line.value = line.count == 0 ? macd : macd * k + line.value * (1.0 - k);
+    if (line.count < signal_window_)
+    {
+        ++line.count;
+        return;
+    }
+    double hist = macd - line.value;
+
+    if (hist > 0)
+        sink(makeOrder(tick, OrderSide::BUY, tick.price, order_qty_));
+    else if (hist < 0)
+        sink(makeOrder(tick, OrderSide::SELL, tick.price, order_qty_));
+}
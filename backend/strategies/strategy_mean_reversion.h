@@ -1,22 +1,44 @@
 #pragma once
 
 #include "strategies/strategy_base.h"
-#include <deque>
-#include <map>
 
-class MeanReversionStrategy : public IStrategy
+class MeanReversionStrategy final : public IStrategy
 {
 public:
-    explicit MeanReversionStrategy(OrderBook &order_book) : order_book_(order_book) {}
+    explicit MeanReversionStrategy(OrderBook &order_book) : order_book_(order_book) { declareIndicators(own_indicators_); }
     void onMarketTick(const MarketTick &tick) override;
-    void setLookback(int lookback) override { lookback_ = lookback; }
+    void onSharedTick(const MarketTick &tick, const IndicatorSnapshot &indicators) override;
+    void declareIndicators(IndicatorRegistry &registry) override;
+    void setLookback(int lookback) override;
     void setOrderQuantity(int quantity) override { order_quantity_ = quantity; }
     const char *name() const override { return "mean_reversion"; }
+    bool precompute(const double *price, const double *size, size_t n, int32_t *orders) const override;
+
+    // Standalone path: advances the strategy's own indicators
+    template <typename Sink>
+    void process(const MarketTick &tick, Sink &sink) { decide(tick, own_indicators_.update(tick), sink); }
 
 private:
+    template <typename Sink>
+    void decide(const MarketTick &tick, const IndicatorSnapshot &indicators, Sink &sink);
+
     OrderBook &order_book_;
-    std::map<std::string, std::deque<double>> price_history_;
+    IndicatorRegistry own_indicators_;
+    IndicatorRegistry *indicators_{nullptr};
+    int sma_{-1};
     int lookback_{10};
     int order_quantity_{100};
-    int order_counter_{0};
 };
+
+template <typename Sink>
+void MeanReversionStrategy::decide(const MarketTick &tick, const IndicatorSnapshot &indicators, Sink &sink)
+{
+    if (!indicators.ready(sma_))
+        return;
+    double avg = indicators.value(sma_);
+    double last = tick.price;
+    if (last < avg)
+        sink(makeOrder(tick, OrderSide::BUY, last, order_quantity_));
+    else if (last > avg)
+        sink(makeOrder(tick, OrderSide::SELL, last, order_quantity_));
+}
@@ -1,56 +1,13 @@
 #include "strategies/strategy_momentum.h"
-#include <chrono>
-#include <iostream>
 
 void MomentumStrategy::onMarketTick(const MarketTick &tick)
 {
-    auto &history = price_history_[tick.venue];
-    history.push_back(tick.price);
-    if (history.size() > MAX_PRICE_HISTORY)
-        history.pop_front();
-    if (history.size() >= static_cast<size_t>(tick_threshold_))
-    {
-        checkMomentum(tick.venue, tick);
-    }
+    OrderCallbackSink sink{*this};
+    process(tick, sink);
 }
 
-void MomentumStrategy::checkMomentum(const std::string &venue, const MarketTick &tick)
+bool MomentumStrategy::isUpwardMomentum(const std::deque<double> &h) const
 {
-    if (isUpwardMomentum(venue))
-    {
-        Order order;
-        order.id = "O" + std::to_string(++order_counter_);
-        order.venue = venue;
-        order.symbol = tick.symbol;
-        order.side = OrderSide::BUY;
-        order.price = tick.price;
-        order.quantity = order_quantity_;
-        order.timestamp = std::chrono::system_clock::now();
-        order.exchange_recv_ts_ms = tick.exchange_recv_ts_ms;
-        order.ingest_ts_ms = tick.ingest_ts_ms;
-        if (on_order)
-            on_order(order);
-    }
-    else if (isDownwardMomentum(venue))
-    {
-        Order order;
-        order.id = "O" + std::to_string(++order_counter_);
-        order.venue = venue;
-        order.symbol = tick.symbol;
-        order.side = OrderSide::SELL;
-        order.price = tick.price;
-        order.quantity = order_quantity_;
-        order.timestamp = std::chrono::system_clock::now();
-        order.exchange_recv_ts_ms = tick.exchange_recv_ts_ms;
-        order.ingest_ts_ms = tick.ingest_ts_ms;
-        if (on_order)
-            on_order(order);
-    }
-}
-
-bool MomentumStrategy::isUpwardMomentum(const std::string &venue) const
-{
-    const auto &h = price_history_.at(venue);
     if (h.size() < static_cast<size_t>(tick_threshold_))
         return false;
     for (size_t i = h.size() - tick_threshold_; i < h.size() - 1; ++i)
@@ -59,9 +16,8 @@ bool MomentumStrategy::isUpwardMomentum(const std::string &venue) const
     return true;
 }
 
-bool MomentumStrategy::isDownwardMomentum(const std::string &venue) const
+bool MomentumStrategy::isDownwardMomentum(const std::deque<double> &h) const
 {
-    const auto &h = price_history_.at(venue);
     if (h.size() < static_cast<size_t>(tick_threshold_))
         return false;
     for (size_t i = h.size() - tick_threshold_; i < h.size() - 1; ++i)
@@ -69,3 +25,28 @@ bool MomentumStrategy::isDownwardMomentum(const std::string &venue) const
             return false;
     return true;
 }
+
+bool MomentumStrategy::precompute(const double *price, const double *, size_t n, int32_t *orders) const
+{
+    // Streak lengths replace the history scan: the last `threshold` prices rise strictly when the
+    // run of rising steps ending at i covers threshold - 1 steps
+    int threshold = tick_threshold_;
+    int up = 0;
+    int down = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        orders[i] = 0;
+        if (i > 0)
+        {
+            up = price[i] > price[i - 1] ? up + 1 : 0;
+            down = price[i] < price[i - 1] ? down + 1 : 0;
+        }
+        if (threshold > MAX_PRICE_HISTORY || static_cast<long>(i) + 1 < threshold)
+            continue;
+        if (up >= threshold - 1)
+            orders[i] = order_quantity_;
+        else if (down >= threshold - 1)
+            orders[i] = -order_quantity_;
+    }
+    return true;
+}
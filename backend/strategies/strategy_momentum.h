@@ -5,7 +5,7 @@
 #include <deque>
 #include <map>
 
-class MomentumStrategy : public IStrategy
+class MomentumStrategy final : public IStrategy
 {
 public:
     explicit MomentumStrategy(OrderBook &order_book) : order_book_(order_book) {}
@@ -15,16 +15,34 @@ public:
     void setLookback(int threshold) override { tick_threshold_ = threshold; }
     void setOrderQuantity(int quantity) override { order_quantity_ = quantity; }
     const char *name() const override { return "momentum"; }
+    bool precompute(const double *price, const double *size, size_t n, int32_t *orders) const override;
+
+    template <typename Sink>
+    void process(const MarketTick &tick, Sink &sink);
 
 private:
-    void checkMomentum(const std::string &venue, const MarketTick &tick);
-    bool isUpwardMomentum(const std::string &venue) const;
-    bool isDownwardMomentum(const std::string &venue) const;
+    bool isUpwardMomentum(const std::deque<double> &h) const;
+    bool isDownwardMomentum(const std::deque<double> &h) const;
 
     OrderBook &order_book_;
-    std::map<std::string, std::deque<double>> price_history_;
+    std::map<InstrumentId, std::deque<double>> price_history_;
     int tick_threshold_{3};
     int order_quantity_{100};
-    int order_counter_{0};
     static constexpr int MAX_PRICE_HISTORY = 10;
 };
+
+template <typename Sink>
+void MomentumStrategy::process(const MarketTick &tick, Sink &sink)
+{
+    auto &history = price_history_[InstrumentId(tick.venue, tick.symbol)];
+    history.push_back(tick.price);
+    if (history.size() > MAX_PRICE_HISTORY)
+        history.pop_front();
+    if (history.size() < static_cast<size_t>(tick_threshold_))
+        return;
+
+    if (isUpwardMomentum(history))
+        sink(makeOrder(tick, OrderSide::BUY, tick.price, order_quantity_));
+    else if (isDownwardMomentum(history))
+        sink(makeOrder(tick, OrderSide::SELL, tick.price, order_quantity_));
+}
@@ -1,7 +1,8 @@
 #include "strategy_rsi.h"
-#include <chrono>
+#include "indicator_kernels.h"
+#include <vector>
 
-static double compute_rsi(const std::deque<double> &p, int period)
+double RsiStrategy::computeRsi(const std::deque<double> &p, int period)
 {
     if (p.size() < static_cast<size_t>(period + 1))
         return 50.0;
@@ -21,42 +22,15 @@ static double compute_rsi(const std::deque<double> &p, int period)
 
 void RsiStrategy::onMarketTick(const MarketTick &tick)
 {
-    auto &px = prices_[tick.venue];
-    px.push_back(tick.price);
-    if (px.size() > static_cast<size_t>(period_ + 1))
-        px.pop_front();
-    if (px.size() < static_cast<size_t>(period_ + 1))
-        return;
+    OrderCallbackSink sink{*this};
+    process(tick, sink);
+}
 
-    double rsi = compute_rsi(px, period_);
-    if (rsi < 30.0)
-    {
-        Order o;
-        o.id = "O" + std::to_string(++order_counter_);
-        o.venue = tick.venue;
-        o.symbol = tick.symbol;
-        o.side = OrderSide::BUY;
-        o.price = tick.price;
-        o.quantity = order_qty_;
-        o.timestamp = std::chrono::system_clock::now();
-        o.exchange_recv_ts_ms = tick.exchange_recv_ts_ms;
-        o.ingest_ts_ms = tick.ingest_ts_ms;
-        if (on_order)
-            on_order(o);
-    }
-    else if (rsi > 70.0)
-    {
-        Order o;
-        o.id = "O" + std::to_string(++order_counter_);
-        o.venue = tick.venue;
-        o.symbol = tick.symbol;
-        o.side = OrderSide::SELL;
-        o.price = tick.price;
-        o.quantity = order_qty_;
-        o.timestamp = std::chrono::system_clock::now();
-        o.exchange_recv_ts_ms = tick.exchange_recv_ts_ms;
-        o.ingest_ts_ms = tick.ingest_ts_ms;
-        if (on_order)
-            on_order(o);
-    }
+bool RsiStrategy::precompute(const double *price, const double *, size_t n, int32_t *orders) const
+{
+    std::vector<double> rsi(n);
+    rsiSeries(price, n, period_, rsi.data());
+    for (size_t i = 0; i < n; ++i)
+        orders[i] = rsi[i] < 30.0 ? order_qty_ : rsi[i] > 70.0 ? -order_qty_ : 0;
+    return true;
 }
@@ -4,7 +4,7 @@
 #include <deque>
 #include <map>
 
-class RsiStrategy : public IStrategy
+class RsiStrategy final : public IStrategy
 {
 public:
     explicit RsiStrategy(OrderBook &order_book) : order_book_(order_book) {}
@@ -12,11 +12,33 @@ public:
     void setLookback(int lookback) override { period_ = lookback > 0 ? lookback : period_; }
     void setOrderQuantity(int quantity) override { order_qty_ = quantity; }
     const char *name() const override { return "rsi"; }
+    bool precompute(const double *price, const double *size, size_t n, int32_t *orders) const override;
+
+    template <typename Sink>
+    void process(const MarketTick &tick, Sink &sink);
 
 private:
+    static double computeRsi(const std::deque<double> &p, int period);
+
     OrderBook &order_book_;
-    std::map<std::string, std::deque<double>> prices_;
+    std::map<InstrumentId, std::deque<double>> prices_;
     int period_{14};
     int order_qty_{100};
-    int order_counter_{0};
 };
+
+template <typename Sink>
+void RsiStrategy::process(const MarketTick &tick, Sink &sink)
+{
+    auto &px = prices_[InstrumentId(tick.venue, tick.symbol)];
+    px.push_back(tick.price);
+    if (px.size() > static_cast<size_t>(period_ + 1))
+        px.pop_front();
+    if (px.size() < static_cast<size_t>(period_ + 1))
+        return;
+
+    double rsi = computeRsi(px, period_);
+    if (rsi < 30.0)
+        sink(makeOrder(tick, OrderSide::BUY, tick.price, order_qty_));
+    else if (rsi > 70.0)
+        sink(makeOrder(tick, OrderSide::SELL, tick.price, order_qty_));
+}
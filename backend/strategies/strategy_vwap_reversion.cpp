@@ -1,52 +1,47 @@
 #include "strategy_vwap_reversion.h"
-#include <chrono>
+#include "indicator_kernels.h"
+#include <vector>
 
 void VwapReversionStrategy::onMarketTick(const MarketTick &tick)
 {
-    auto &dq = window_[tick.venue];
-    dq.emplace_back(tick.price, tick.size > 0 ? tick.size : 1.0);
-    if (dq.size() > static_cast<size_t>(lookback_))
-        dq.pop_front();
-    if (dq.size() < 2)
-        return;
+    OrderCallbackSink sink{*this};
+    process(tick, sink);
+}
 
-    double sum_pv = 0.0, sum_v = 0.0;
-    for (auto &ps : dq)
-    {
-        sum_pv += ps.first * ps.second;
-        sum_v += ps.second;
-    }
-    double vwap = sum_pv / (sum_v > 0 ? sum_v : 1.0);
-    double last = dq.back().first;
+void VwapReversionStrategy::onSharedTick(const MarketTick &tick, const IndicatorSnapshot &indicators)
+{
+    OrderCallbackSink sink{*this};
+    decide(tick, indicators, sink);
+}
+
+void VwapReversionStrategy::declareIndicators(IndicatorRegistry &registry)
+{
+    indicators_ = &registry;
+    vwap_ = registry.declare({IndicatorType::VWAP, lookback_});
+}
+
+void VwapReversionStrategy::setLookback(int lookback)
+{
+    lookback_ = lookback;
+    if (indicators_ == &own_indicators_)
+        own_indicators_.clear();
+    declareIndicators(*indicators_);
+}
 
-    if (last < vwap)
+bool VwapReversionStrategy::precompute(const double *price, const double *size, size_t n, int32_t *orders) const
+{
+    std::vector<double> notional(n), volume(n), notional_sum(n), volume_sum(n);
+    for (size_t i = 0; i < n; ++i)
     {
-        Order o;
-        o.id = "O" + std::to_string(++order_counter_);
-        o.venue = tick.venue;
-        o.symbol = tick.symbol;
-        o.side = OrderSide::BUY;
-        o.price = last;
-        o.quantity = order_qty_;
-        o.timestamp = std::chrono::system_clock::now();
-        o.exchange_recv_ts_ms = tick.exchange_recv_ts_ms;
-        o.ingest_ts_ms = tick.ingest_ts_ms;
-        if (on_order)
-            on_order(o);
+        volume[i] = size[i] > 0 ? size[i] : 1.0;
+        notional[i] = price[i] * volume[i];
     }
-    else if (last > vwap)
+    rollingSum(notional.data(), n, lookback_, notional_sum.data());
+    rollingSum(volume.data(), n, lookback_, volume_sum.data());
+    for (size_t i = 0; i < n; ++i)
     {
-        Order o;
-        o.id = "O" + std::to_string(++order_counter_);
-        o.venue = tick.venue;
-        o.symbol = tick.symbol;
-        o.side = OrderSide::SELL;
-        o.price = last;
-        o.quantity = order_qty_;
-        o.timestamp = std::chrono::system_clock::now();
-        o.exchange_recv_ts_ms = tick.exchange_recv_ts_ms;
-        o.ingest_ts_ms = tick.ingest_ts_ms;
-        if (on_order)
-            on_order(o);
+        double vwap = notional_sum[i] / (volume_sum[i] > 0 ? volume_sum[i] : 1.0);
+        orders[i] = price[i] < vwap ? order_qty_ : price[i] > vwap ? -order_qty_ : 0;
     }
+    return true;
 }
@@ -1,27 +1,45 @@
 #pragma once
 
 #include "strategy_base.h"
-#include <deque>
-#include <map>
 
-class VwapReversionStrategy : public IStrategy
+class VwapReversionStrategy final : public IStrategy
 {
 public:
-    explicit VwapReversionStrategy(OrderBook &order_book) : order_book_(order_book) {}
+    explicit VwapReversionStrategy(OrderBook &order_book) : order_book_(order_book) { declareIndicators(own_indicators_); }
     void onMarketTick(const MarketTick &tick) override;
-    void setLookback(int lookback) override { lookback_ = lookback; }
+    void onSharedTick(const MarketTick &tick, const IndicatorSnapshot &indicators) override;
+    void declareIndicators(IndicatorRegistry &registry) override;
+    void setLookback(int lookback) override;
     void setOrderQuantity(int quantity) override { order_qty_ = quantity; }
     const char *name() const override { return "vwap_reversion"; }
+    bool precompute(const double *price, const double *size, size_t n, int32_t *orders) const override;
+
+    // Standalone path: advances the strategy's own indicators
+    template <typename Sink>
+    void process(const MarketTick &tick, Sink &sink) { decide(tick, own_indicators_.update(tick), sink); }
 
 private:
-    struct Accum
-    {
-        double pv{0.0};
-        double v{0.0};
-    };
+    template <typename Sink>
+    void decide(const MarketTick &tick, const IndicatorSnapshot &indicators, Sink &sink);
+
     OrderBook &order_book_;
-    std::map<std::string, std::deque<std::pair<double, double>>> window_; // price, size
+    IndicatorRegistry own_indicators_;
+    IndicatorRegistry *indicators_{nullptr};
+    int vwap_{-1};
     int lookback_{50};
     int order_qty_{100};
-    int order_counter_{0};
 };
+
+template <typename Sink>
+void VwapReversionStrategy::decide(const MarketTick &tick, const IndicatorSnapshot &indicators, Sink &sink)
+{
+    if (!indicators.ready(vwap_))
+        return;
+    double vwap = indicators.value(vwap_);
+    double last = tick.price;
+
+    if (last < vwap)
+        sink(makeOrder(tick, OrderSide::BUY, last, order_qty_));
+    else if (last > vwap)
+        sink(makeOrder(tick, OrderSide::SELL, last, order_qty_));
+}
@@ -0,0 +1,163 @@
+#include "strategy_group.h"
+#include "strategies/strategy_factory.h"
+#include "trace.h"
+#include <chrono>
+#include <sstream>
+
+StrategyGroup::StrategyGroup(GroupExecuteFn execute, GroupTradeFn on_trade)
+    : execute_(std::move(execute)), on_trade_(std::move(on_trade))
+{
+}
+
+StrategyGroup::~StrategyGroup()
+{
+    stop();
+}
+
+bool StrategyGroup::addStrategy(const std::string &name, int lookback, int order_qty, const RiskLimits &limits)
+{
+    auto member = std::make_unique<Member>(8192);
+    member->strategy = makeStrategy(name, member->order_book);
+    if (!member->strategy)
+        return false;
+    member->name = name;
+    member->order_book.setBookId(static_cast<uint32_t>(members_.size() + 1));
+    member->strategy->setLookback(lookback);
+    member->strategy->setOrderQuantity(order_qty);
+    member->risk_gate.setDefaultLimits(limits);
+    member->strategy->declareIndicators(indicators_);
+
+    Member *m = member.get();
+    m->strategy->on_order = [this, m](const Order &order)
+    {
+        if (m->risk_gate.check(order) != RiskReject::NONE)
+            return;
+        execute_(m->order_book, order);
+    };
+    m->order_book.setTradeCallback([this, m](const Trade &trade)
+                                   {
+        if (on_trade_)
+            on_trade_(trade, m->name); });
+    members_.push_back(std::move(member));
+    return true;
+}
+
+void StrategyGroup::start()
+{
+    if (running_)
+        return;
+    running_ = true;
+    for (auto &member : members_)
+        member->worker = std::thread(&StrategyGroup::run, this, std::ref(*member));
+}
+
+void StrategyGroup::stop()
+{
+    if (!running_)
+        return;
+    running_ = false;
+    for (auto &member : members_)
+    {
+        if (member->worker.joinable())
+            member->worker.join();
+    }
+}
+
+void StrategyGroup::warmUp(const std::vector<MarketTick> &ticks)
+{
+    std::vector<std::unique_ptr<IStrategy::OrderMute>> mutes;
+    for (auto &member : members_)
+        mutes.push_back(std::make_unique<IStrategy::OrderMute>(*member->strategy));
+    for (const auto &tick : ticks)
+    {
+        const IndicatorSnapshot &indicators = indicators_.update(tick);
+        for (auto &member : members_)
+            member->strategy->onSharedTick(tick, indicators);
+    }
+}
+
+void StrategyGroup::onTick(const MarketTick &tick)
+{
+    GroupTick item{tick, indicators_.update(tick)};
+    for (auto &member : members_)
+    {
+        if (!member->queue.tryPush(item))
+            member->dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void StrategyGroup::run(Member &member)
+{
+    setTraceThreadName(member.strategy->name());
+    GroupTick item;
+    int idle_spins = 0;
+    while (running_)
+    {
+        if (member.queue.tryPop(item))
+        {
+            member.order_book.markToMarket(item.tick);
+            member.risk_gate.onMarketTick(item.tick);
+            {
+                TraceScope trace("onMarketTick");
+                member.strategy->onSharedTick(item.tick, item.indicators);
+            }
+            member.ticks.fetch_add(1, std::memory_order_relaxed);
+            idle_spins = 0;
+        }
+        else if (++idle_spins > 1000)
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+}
+
+double StrategyGroup::getRealizedPnL() const
+{
+    double total = 0.0;
+    for (const auto &member : members_)
+        total += member->order_book.getTotalPnL();
+    return total;
+}
+
+double StrategyGroup::getUnrealizedPnL() const
+{
+    double total = 0.0;
+    for (const auto &member : members_)
+        total += member->order_book.getUnrealizedPnL();
+    return total;
+}
+
+uint64_t StrategyGroup::getDropped() const
+{
+    uint64_t total = 0;
+    for (const auto &member : members_)
+        total += member->dropped.load(std::memory_order_relaxed);
+    return total;
+}
+
+const char *StrategyGroup::strategyName(const OrderBook &book) const
+{
+    for (const auto &member : members_)
+    {
+        if (&member->order_book == &book)
+            return member->strategy->name();
+    }
+    return "unknown";
+}
+
+std::string StrategyGroup::statsToText() const
+{
+    std::ostringstream oss;
+    oss << "shared_indicators=" << indicators_.size() << "\n";
+    for (const auto &member : members_)
+    {
+        const std::string &n = member->name;
+        oss << n << "_ticks=" << member->ticks.load(std::memory_order_relaxed) << "\n";
+        oss << n << "_dropped=" << member->dropped.load(std::memory_order_relaxed) << "\n";
+        oss << n << "_trades=" << member->order_book.getTradeCount() << "\n";
+        oss << n << "_realized_pnl=" << member->order_book.getTotalPnL() << "\n";
+        oss << n << "_unrealized_pnl=" << member->order_book.getUnrealizedPnL() << "\n";
+        oss << n << "_rejected_orders=" << member->risk_gate.getRejectedTotal() << "\n";
+    }
+    return oss.str();
+}
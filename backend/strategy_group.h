@@ -0,0 +1,79 @@
+#pragma once
+
+#include "data_source.h"
+#include "order_book.h"
+#include "risk.h"
+#include "lockfree_queue.h"
+#include "indicators.h"
+#include "strategies/strategy_base.h"
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using GroupExecuteFn = std::function<void(OrderBook &, const Order &)>;
+using GroupTradeFn = std::function<void(const Trade &, const std::string &strategy)>;
+
+// Fans one tick stream out to N strategies. Each member runs on its own worker thread
+// with a private virtual book and risk gate, so PnL is attributed per strategy.
+// Indicators the members declare are computed once per tick on the feed thread and
+// shipped to every worker as a snapshot alongside the tick.
+class StrategyGroup
+{
+public:
+    StrategyGroup(GroupExecuteFn execute, GroupTradeFn on_trade);
+    ~StrategyGroup();
+
+    // Returns false for an unknown strategy name; call before start()
+    bool addStrategy(const std::string &name, int lookback, int order_qty, const RiskLimits &limits);
+
+    void start();
+    void stop();
+
+    // Runs recorded ticks through the shared indicators and every member with orders muted;
+    // call before start()
+    void warmUp(const std::vector<MarketTick> &ticks);
+
+    // Call from a single feed thread
+    void onTick(const MarketTick &tick);
+
+    size_t size() const { return members_.size(); }
+    double getRealizedPnL() const;
+    double getUnrealizedPnL() const;
+    // Ticks dropped because a member queue was full, summed over members
+    uint64_t getDropped() const;
+    // Strategy of the member that owns this book
+    const char *strategyName(const OrderBook &book) const;
+    std::string statsToText() const;
+
+private:
+    struct GroupTick
+    {
+        MarketTick tick;
+        IndicatorSnapshot indicators;
+    };
+
+    struct Member
+    {
+        explicit Member(size_t queue_capacity) : queue(queue_capacity) {}
+
+        std::string name;
+        OrderBook order_book;
+        RiskGate risk_gate;
+        std::unique_ptr<IStrategy> strategy;
+        BoundedQueue<GroupTick> queue;
+        std::thread worker;
+        std::atomic<uint64_t> ticks{0};
+        std::atomic<uint64_t> dropped{0};
+    };
+
+    void run(Member &member);
+
+    GroupExecuteFn execute_;
+    GroupTradeFn on_trade_;
+    IndicatorRegistry indicators_;
+    std::vector<std::unique_ptr<Member>> members_;
+    std::atomic<bool> running_{false};
+};
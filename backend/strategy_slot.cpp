@@ -0,0 +1,222 @@
+#include "strategy_slot.h"
+#include "trace.h"
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+static uint64_t packParams(const StrategyParams &params)
+{
+    return (static_cast<uint64_t>(static_cast<uint32_t>(params.lookback)) << 32) |
+           static_cast<uint32_t>(params.order_qty);
+}
+
+static StrategyParams unpackParams(uint64_t word)
+{
+    StrategyParams params;
+    params.lookback = static_cast<int>(word >> 32);
+    params.order_qty = static_cast<int>(word & 0xffffffffu);
+    return params;
+}
+
+void StrategyParamsMailbox::post(const StrategyParams &params)
+{
+    // Merge with an update the feed thread has not taken yet
+    uint64_t expected = word_.load(std::memory_order_relaxed);
+    while (true)
+    {
+        StrategyParams merged = unpackParams(expected);
+        if (params.lookback > 0)
+            merged.lookback = params.lookback;
+        if (params.order_qty > 0)
+            merged.order_qty = params.order_qty;
+        if (word_.compare_exchange_weak(expected, packParams(merged), std::memory_order_release, std::memory_order_relaxed))
+            return;
+    }
+}
+
+bool StrategyParamsMailbox::take(StrategyParams &params)
+{
+    // Plain load first so the common no-update tick does no read-modify-write
+    if (word_.load(std::memory_order_relaxed) == 0)
+        return false;
+    uint64_t word = word_.exchange(0, std::memory_order_acquire);
+    if (word == 0)
+        return false;
+    params = unpackParams(word);
+    return true;
+}
+
+void StrategyParamsMailbox::apply(IStrategy &strategy, const StrategyParams &params)
+{
+    if (params.lookback > 0)
+        strategy.setLookback(params.lookback);
+    if (params.order_qty > 0)
+        strategy.setOrderQuantity(params.order_qty);
+}
+
+static size_t roundUpPow2(size_t n)
+{
+    size_t p = 1;
+    while (p < n)
+        p <<= 1;
+    return p;
+}
+
+StrategySlot::StrategySlot(size_t history)
+    : ring_(roundUpPow2(std::max<size_t>(history, 1))), copy_(ring_.size())
+{
+}
+
+StrategySlot::~StrategySlot()
+{
+    delete current_;
+    delete pending_.load(std::memory_order_acquire);
+    delete retired_.load(std::memory_order_acquire);
+}
+
+void StrategySlot::setOrderCallbacks(std::function<void(const Order &)> on_order,
+                                     std::function<void(const Order *, size_t)> on_order_batch)
+{
+    on_order_ = std::move(on_order);
+    on_order_batch_ = std::move(on_order_batch);
+}
+
+void StrategySlot::init(std::unique_ptr<IStrategy> strategy)
+{
+    strategy->on_order = on_order_;
+    strategy->on_order_batch = on_order_batch_;
+    delete current_;
+    current_ = strategy.release();
+    name_.store(current_->name(), std::memory_order_release);
+}
+
+void StrategySlot::beginTick()
+{
+    if (pending_.load(std::memory_order_relaxed))
+    {
+        Pending *pending = pending_.exchange(nullptr, std::memory_order_acq_rel);
+        if (pending)
+            install(pending);
+    }
+    StrategyParams params;
+    if (current_ && params_.take(params))
+        StrategyParamsMailbox::apply(*current_, params);
+
+    uint64_t request = copy_request_.load(std::memory_order_acquire);
+    if (request != copy_served_.load(std::memory_order_relaxed))
+    {
+        std::copy(ring_.begin(), ring_.end(), copy_.begin());
+        copy_written_ = written_;
+        copy_served_.store(request, std::memory_order_release);
+    }
+}
+
+void StrategySlot::onTick(const MarketTick &tick)
+{
+    TraceScope trace("onMarketTick");
+    beginTick();
+    record(tick);
+    if (current_)
+        current_->onMarketTick(tick);
+}
+
+void StrategySlot::onBar(const Bar &bar)
+{
+    TraceScope trace("onBar");
+    beginTick();
+    // The ring holds what the strategy consumed, so a swapped-in instance warms on bars too
+    record(barToTick(bar));
+    if (current_)
+        current_->onBar(bar);
+}
+
+void StrategySlot::warmUp(const std::vector<MarketTick> &ticks)
+{
+    if (!current_)
+        return;
+    IStrategy::OrderMute mute(*current_);
+    for (const auto &tick : ticks)
+    {
+        record(tick);
+        current_->onMarketTick(tick);
+    }
+}
+
+void StrategySlot::record(const MarketTick &tick)
+{
+    RecentTick &slot = ring_[written_ & (ring_.size() - 1)];
+    slot.venue = tick.venue;
+    slot.symbol = tick.symbol;
+    slot.price = tick.price;
+    slot.size = tick.size;
+    slot.exchange_recv_ts_ms = tick.exchange_recv_ts_ms;
+    slot.ingest_ts_ms = tick.ingest_ts_ms;
+    ++written_;
+}
+
+void StrategySlot::swap(std::unique_ptr<IStrategy> next)
+{
+    // The feed thread has moved past the previous swap's old instance by now
+    delete retired_.exchange(nullptr, std::memory_order_acq_rel);
+
+    next->on_order = nullptr;
+    next->on_order_batch = nullptr;
+
+    // Warm off the tick path from a copy of the ring; if the feed is idle the copy never
+    // arrives and the feed thread warms from its own ring on install instead
+    uint64_t warmed_through = 0;
+    uint64_t request = copy_request_.fetch_add(1, std::memory_order_acq_rel) + 1;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(COPY_WAIT_MS);
+    while (copy_served_.load(std::memory_order_acquire) != request && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    if (copy_served_.load(std::memory_order_acquire) == request)
+    {
+        uint64_t from = copy_written_ > copy_.size() ? copy_written_ - copy_.size() : 0;
+        replay(*next, copy_, from, copy_written_);
+        warmed_through = copy_written_;
+    }
+
+    Pending *stale = pending_.exchange(new Pending{std::move(next), warmed_through}, std::memory_order_acq_rel);
+    // Published but never installed; the feed thread has not seen it
+    delete stale;
+}
+
+MarketTick StrategySlot::toTick(const RecentTick &recent)
+{
+    MarketTick tick;
+    tick.venue = recent.venue.str();
+    tick.symbol = recent.symbol.str();
+    tick.price = recent.price;
+    tick.size = recent.size;
+    tick.exchange_recv_ts_ms = recent.exchange_recv_ts_ms;
+    tick.ingest_ts_ms = recent.ingest_ts_ms;
+    return tick;
+}
+
+void StrategySlot::replay(IStrategy &strategy, const std::vector<RecentTick> &ring, uint64_t from, uint64_t to)
+{
+    for (uint64_t seq = from; seq < to; ++seq)
+        strategy.onMarketTick(toTick(ring[seq & (ring.size() - 1)]));
+}
+
+void StrategySlot::install(Pending *pending)
+{
+    // Catch up on ticks that arrived while the control thread was warming
+    uint64_t oldest = written_ > ring_.size() ? written_ - ring_.size() : 0;
+    replay(*pending->strategy, ring_, std::max(pending->warmed_through, oldest), written_);
+
+    IStrategy *next = pending->strategy.release();
+    delete pending;
+    next->on_order = on_order_;
+    next->on_order_batch = on_order_batch_;
+
+    IStrategy *old = current_;
+    current_ = next;
+    name_.store(current_->name(), std::memory_order_release);
+    swaps_.fetch_add(1, std::memory_order_relaxed);
+
+    // Normally the control thread frees it on the next swap; if it has not collected the
+    // previous one yet, that one is long out of use and can go now
+    if (old)
+        delete retired_.exchange(old, std::memory_order_acq_rel);
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "strategies/strategy_base.h"
+#include "fixed_string.h"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+// Lookback / order quantity update; zero leaves a field unchanged
+struct StrategyParams
+{
+    int lookback{0};
+    int order_qty{0};
+};
+
+// One-word mailbox for parameter blocks: any thread posts, the feed thread takes the merged
+// update at a tick boundary and applies it on its own thread
+class StrategyParamsMailbox
+{
+public:
+    void post(const StrategyParams &params);
+    bool take(StrategyParams &params);
+    static void apply(IStrategy &strategy, const StrategyParams &params);
+
+private:
+    std::atomic<uint64_t> word_{0};
+};
+
+// Owns the active strategy on the single-book path and lets the control thread replace it or
+// retune it while the feed runs, without locks on the tick path.
+//
+// Swaps are RCU-style with the feed thread as the only reader: the control thread builds and
+// warms the new instance, then publishes it through an atomic pointer. The feed thread installs
+// it at the start of its next tick and hands the old instance back through another atomic
+// pointer; a tick boundary is the grace period, so the control thread frees it on the next
+// swap (or the slot frees it on destruction).
+//
+// Warming replays the recent-tick ring into the new instance with its order callbacks unset, so
+// nothing is emitted. The control thread asks the feed thread for a copy of the ring, warms off
+// the tick path, and the feed thread replays only the ticks that arrived in between on install.
+class StrategySlot
+{
+public:
+    explicit StrategySlot(size_t history = 1024);
+    ~StrategySlot();
+
+    // Wired into every instance when it becomes active
+    void setOrderCallbacks(std::function<void(const Order &)> on_order,
+                           std::function<void(const Order *, size_t)> on_order_batch);
+    // Installs the first instance directly; call before the feed starts
+    void init(std::unique_ptr<IStrategy> strategy);
+
+    // Replays recorded ticks into the active instance and the recent-tick ring with orders
+    // muted; call before the feed starts
+    void warmUp(const std::vector<MarketTick> &ticks);
+
+    // Feed thread; onBar replaces onTick in bar mode
+    void onTick(const MarketTick &tick);
+    void onBar(const Bar &bar);
+
+    // Control side; callers must not overlap (main serializes /control requests with a mutex).
+    // Both take effect on the next tick.
+    void swap(std::unique_ptr<IStrategy> next);
+    void updateParams(const StrategyParams &params) { params_.post(params); }
+
+    // Safe from any thread: names are string literals
+    const char *name() const { return name_.load(std::memory_order_acquire); }
+    uint64_t getSwaps() const { return swaps_.load(std::memory_order_relaxed); }
+
+private:
+    struct RecentTick
+    {
+        VenueId venue;
+        SymbolId symbol;
+        double price;
+        double size;
+        int64_t exchange_recv_ts_ms;
+        int64_t ingest_ts_ms;
+    };
+
+    struct Pending
+    {
+        std::unique_ptr<IStrategy> strategy;
+        uint64_t warmed_through; // ticks [0, warmed_through) already replayed
+    };
+
+    static MarketTick toTick(const RecentTick &recent);
+    // Installs a pending swap, applies parameter updates and serves ring copies
+    void beginTick();
+    void install(Pending *pending);
+    void replay(IStrategy &strategy, const std::vector<RecentTick> &ring, uint64_t from, uint64_t to);
+    void record(const MarketTick &tick);
+
+    std::vector<RecentTick> ring_;
+    uint64_t written_{0};
+
+    // Ring copy handshake: the control thread bumps copy_request_, the feed thread copies the
+    // ring into copy_ at its next tick and publishes the request number in copy_served_
+    std::atomic<uint64_t> copy_request_{0};
+    std::atomic<uint64_t> copy_served_{0};
+    std::vector<RecentTick> copy_;
+    uint64_t copy_written_{0};
+
+    std::function<void(const Order &)> on_order_;
+    std::function<void(const Order *, size_t)> on_order_batch_;
+
+    IStrategy *current_{nullptr};
+    std::atomic<Pending *> pending_{nullptr};
+    std::atomic<IStrategy *> retired_{nullptr};
+    std::atomic<const char *> name_{""};
+    std::atomic<uint64_t> swaps_{0};
+    StrategyParamsMailbox params_;
+
+    static constexpr int COPY_WAIT_MS = 50;
+};
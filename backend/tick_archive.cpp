@@ -0,0 +1,380 @@
+#include "tick_archive.h"
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <unistd.h>
+
+static constexpr char BLOCK_MAGIC[4] = {'T', 'P', 'B', 'K'};
+static constexpr int MAX_DECIMALS = 9;
+static constexpr double POW10[MAX_DECIMALS + 1] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9};
+
+static uint64_t zigzag(int64_t v) { return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63); }
+static int64_t unzigzag(uint64_t v) { return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1); }
+
+static void put_varint(std::string &out, uint64_t v)
+{
+    while (v >= 0x80)
+    {
+        out.push_back(static_cast<char>(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<char>(v));
+}
+
+static bool get_varint(const char *&p, const char *end, uint64_t &v)
+{
+    uint64_t result = 0;
+    for (int shift = 0; shift < 64 && p < end; shift += 7)
+    {
+        uint8_t byte = static_cast<uint8_t>(*p++);
+        result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if (byte < 0x80)
+        {
+            v = result;
+            return true;
+        }
+    }
+    return false;
+}
+
+static void put_raw(std::string &out, const std::vector<double> &col)
+{
+    out.append(reinterpret_cast<const char *>(col.data()), col.size() * sizeof(double));
+}
+
+// Integers q with q / 10^decimals == col[i] exactly, for the fewest decimals that work; false if
+// no decimals up to MAX_DECIMALS reproduce every value
+static bool quantize(const std::vector<double> &col, std::vector<int64_t> &q, int &decimals)
+{
+    decimals = 0;
+    q.resize(col.size());
+    for (size_t i = 0; i < col.size(); ++i)
+    {
+        for (;;)
+        {
+            double scaled = col[i] * POW10[decimals];
+            if (std::fabs(scaled) < 9007199254740992.0)
+            {
+                q[i] = std::llround(scaled);
+                if (static_cast<double>(q[i]) / POW10[decimals] == col[i])
+                    break;
+            }
+            if (++decimals > MAX_DECIMALS)
+                return false;
+            // Earlier values were exact at fewer decimals; rescale them, staying exact as doubles
+            for (size_t j = 0; j < i; ++j)
+            {
+                if (std::llabs(q[j]) >= 900719925474099ll)
+                    return false;
+                q[j] *= 10;
+            }
+        }
+    }
+    return true;
+}
+
+void TickArchiveEncoder::add(const MarketTick &tick)
+{
+    key_.assign(tick.venue);
+    key_ += '\0';
+    key_ += tick.symbol;
+    auto it = interned_.find(key_);
+    if (it == interned_.end())
+    {
+        it = interned_.emplace(key_, static_cast<uint32_t>(instruments_.size())).first;
+        instruments_.emplace_back(tick.venue, tick.symbol);
+    }
+    instrument_.push_back(it->second);
+    price_.push_back(tick.price);
+    size_.push_back(tick.size);
+    exchange_recv_ts_ms_.push_back(tick.exchange_recv_ts_ms);
+    ingest_ts_ms_.push_back(tick.ingest_ts_ms);
+}
+
+void TickArchiveEncoder::finish(std::string &out)
+{
+    size_t rows = price_.size();
+    if (rows == 0)
+        return;
+
+    TickArchiveBlockHeader header{};
+    std::memcpy(header.magic, BLOCK_MAGIC, sizeof(BLOCK_MAGIC));
+    header.rows = static_cast<uint32_t>(rows);
+    header.first_exchange_recv_ts_ms = exchange_recv_ts_ms_[0];
+    header.first_ingest_ts_ms = ingest_ts_ms_[0];
+
+    size_t header_at = out.size();
+    out.append(sizeof(header), '\0');
+    size_t payload_at = out.size();
+
+    put_varint(out, instruments_.size());
+    for (const auto &names : instruments_)
+    {
+        put_varint(out, names.first.size());
+        out += names.first;
+        put_varint(out, names.second.size());
+        out += names.second;
+    }
+    for (uint32_t idx : instrument_)
+        put_varint(out, idx);
+
+    int64_t prev = header.first_exchange_recv_ts_ms;
+    for (int64_t ts : exchange_recv_ts_ms_)
+    {
+        put_varint(out, zigzag(ts - prev));
+        prev = ts;
+    }
+    prev = header.first_ingest_ts_ms;
+    for (int64_t ts : ingest_ts_ms_)
+    {
+        put_varint(out, zigzag(ts - prev));
+        prev = ts;
+    }
+
+    std::vector<int64_t> q;
+    int decimals = 0;
+    if (quantize(price_, q, decimals))
+    {
+        header.price_decimals = static_cast<uint8_t>(decimals);
+        std::vector<int64_t> last(instruments_.size(), 0);
+        for (size_t i = 0; i < rows; ++i)
+        {
+            int64_t &ref = last[instrument_[i]];
+            put_varint(out, zigzag(q[i] - ref));
+            ref = q[i];
+        }
+    }
+    else
+    {
+        header.flags |= ARCHIVE_RAW_PRICES;
+        put_raw(out, price_);
+    }
+    if (quantize(size_, q, decimals))
+    {
+        header.size_decimals = static_cast<uint8_t>(decimals);
+        for (int64_t v : q)
+            put_varint(out, zigzag(v));
+    }
+    else
+    {
+        header.flags |= ARCHIVE_RAW_SIZES;
+        put_raw(out, size_);
+    }
+
+    header.payload_bytes = static_cast<uint32_t>(out.size() - payload_at);
+    if (checksum_)
+    {
+        header.flags |= ARCHIVE_CHECKSUM;
+        header.checksum = TickArchive::checksum(out.data() + payload_at, header.payload_bytes);
+    }
+    std::memcpy(&out[header_at], &header, sizeof(header));
+
+    interned_.clear();
+    instruments_.clear();
+    instrument_.clear();
+    price_.clear();
+    size_.clear();
+    exchange_recv_ts_ms_.clear();
+    ingest_ts_ms_.clear();
+}
+
+uint64_t TickArchive::checksum(const char *data, size_t len)
+{
+    // Word-at-a-time multiplicative hash: cheap next to decoding, catches torn or flipped bytes
+    uint64_t h = 0xcbf29ce484222325ull ^ len;
+    size_t i = 0;
+    for (; i + 8 <= len; i += 8)
+    {
+        uint64_t w;
+        std::memcpy(&w, data + i, 8);
+        h = (h ^ w) * 0x9e3779b97f4a7c15ull;
+        h ^= h >> 32;
+    }
+    for (; i < len; ++i)
+        h = (h ^ static_cast<uint8_t>(data[i])) * 0x100000001b3ull;
+    return h;
+}
+
+static bool get_varint_column(const char *&p, const char *end, int64_t *out, size_t rows, int64_t first)
+{
+    int64_t prev = first;
+    for (size_t i = 0; i < rows; ++i)
+    {
+        uint64_t v;
+        if (!get_varint(p, end, v))
+            return false;
+        prev += unzigzag(v);
+        out[i] = prev;
+    }
+    return true;
+}
+
+static bool get_raw_column(const char *&p, const char *end, std::vector<double> &out, size_t rows)
+{
+    size_t bytes = rows * sizeof(double);
+    if (static_cast<size_t>(end - p) < bytes)
+        return false;
+    std::memcpy(out.data(), p, bytes);
+    p += bytes;
+    return true;
+}
+
+bool TickArchive::decodeBlock(const TickArchiveBlockHeader &header, const char *payload, ReplayBatch &out)
+{
+    const char *p = payload;
+    const char *end = payload + header.payload_bytes;
+    size_t rows = header.rows;
+    if (header.price_decimals > MAX_DECIMALS || header.size_decimals > MAX_DECIMALS)
+        return false;
+
+    out.clear();
+    uint64_t count;
+    if (!get_varint(p, end, count) || count > rows)
+        return false;
+    out.instruments.resize(count);
+    for (auto &names : out.instruments)
+    {
+        for (std::string *field : {&names.first, &names.second})
+        {
+            uint64_t len;
+            if (!get_varint(p, end, len) || static_cast<uint64_t>(end - p) < len)
+                return false;
+            field->assign(p, len);
+            p += len;
+        }
+    }
+
+    out.instrument.resize(rows);
+    for (size_t i = 0; i < rows; ++i)
+    {
+        uint64_t idx;
+        if (!get_varint(p, end, idx) || idx >= count)
+            return false;
+        out.instrument[i] = static_cast<uint32_t>(idx);
+    }
+
+    out.exchange_recv_ts_ms.resize(rows);
+    out.ingest_ts_ms.resize(rows);
+    if (!get_varint_column(p, end, out.exchange_recv_ts_ms.data(), rows, header.first_exchange_recv_ts_ms) ||
+        !get_varint_column(p, end, out.ingest_ts_ms.data(), rows, header.first_ingest_ts_ms))
+        return false;
+
+    out.price.resize(rows);
+    if (header.flags & ARCHIVE_RAW_PRICES)
+    {
+        if (!get_raw_column(p, end, out.price, rows))
+            return false;
+    }
+    else
+    {
+        double scale = POW10[header.price_decimals];
+        std::vector<int64_t> last(count, 0);
+        for (size_t i = 0; i < rows; ++i)
+        {
+            uint64_t v;
+            if (!get_varint(p, end, v))
+                return false;
+            int64_t &ref = last[out.instrument[i]];
+            ref += unzigzag(v);
+            out.price[i] = static_cast<double>(ref) / scale;
+        }
+    }
+
+    out.size.resize(rows);
+    if (header.flags & ARCHIVE_RAW_SIZES)
+        return get_raw_column(p, end, out.size, rows);
+    double scale = POW10[header.size_decimals];
+    for (size_t i = 0; i < rows; ++i)
+    {
+        uint64_t v;
+        if (!get_varint(p, end, v))
+            return false;
+        out.size[i] = static_cast<double>(unzigzag(v)) / scale;
+    }
+    return true;
+}
+
+// Bytes read; short only at end of file
+static size_t read_full(int fd, char *buf, size_t len)
+{
+    size_t got = 0;
+    while (got < len)
+    {
+        ssize_t n = ::read(fd, buf + got, len - got);
+        if (n <= 0)
+            break;
+        got += static_cast<size_t>(n);
+    }
+    return got;
+}
+
+bool TickArchive::isArchiveFile(const std::string &path)
+{
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+    char magic[sizeof(TICK_ARCHIVE_MAGIC)];
+    bool archive = read_full(fd, magic, sizeof(magic)) == sizeof(magic) &&
+                   std::memcmp(magic, TICK_ARCHIVE_MAGIC, sizeof(magic)) == 0;
+    ::close(fd);
+    return archive;
+}
+
+bool TickArchive::read(const std::string &path, const std::function<bool(const ReplayBatch &)> &on_batch, bool verify)
+{
+    return readFrom(path, DATA_OFFSET, [&](const ReplayBatch &batch, uint64_t)
+                    { return on_batch(batch); }, verify);
+}
+
+bool TickArchive::readFrom(const std::string &path, uint64_t offset,
+                           const std::function<bool(const ReplayBatch &, uint64_t)> &on_batch, bool verify)
+{
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+    char magic[sizeof(TICK_ARCHIVE_MAGIC)];
+    if (read_full(fd, magic, sizeof(magic)) != sizeof(magic) || std::memcmp(magic, TICK_ARCHIVE_MAGIC, sizeof(magic)) != 0 ||
+        ::lseek(fd, static_cast<off_t>(offset), SEEK_SET) < 0)
+    {
+        ::close(fd);
+        return false;
+    }
+
+    std::vector<char> payload;
+    ReplayBatch batch;
+    bool ok = true;
+    for (;;)
+    {
+        TickArchiveBlockHeader header;
+        if (read_full(fd, reinterpret_cast<char *>(&header), sizeof(header)) != sizeof(header))
+            break;
+        if (std::memcmp(header.magic, BLOCK_MAGIC, sizeof(BLOCK_MAGIC)) != 0)
+        {
+            std::cerr << "Tick archive " << path << ": bad block header at offset " << offset << std::endl;
+            ok = false;
+            break;
+        }
+        payload.resize(header.payload_bytes);
+        if (read_full(fd, payload.data(), payload.size()) != payload.size())
+            break;
+        if (verify && (header.flags & ARCHIVE_CHECKSUM) && checksum(payload.data(), payload.size()) != header.checksum)
+        {
+            std::cerr << "Tick archive " << path << ": checksum mismatch in block at offset " << offset << std::endl;
+            ok = false;
+            break;
+        }
+        if (!decodeBlock(header, payload.data(), batch))
+        {
+            std::cerr << "Tick archive " << path << ": malformed block at offset " << offset << std::endl;
+            ok = false;
+            break;
+        }
+        if (!on_batch(batch, offset))
+            break;
+        offset += sizeof(header) + header.payload_bytes;
+    }
+    ::close(fd);
+    return ok;
+}
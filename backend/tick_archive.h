@@ -0,0 +1,86 @@
+#pragma once
+
+#include "replay_decoder.h"
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// First 8 bytes of every tick archive
+static constexpr char TICK_ARCHIVE_MAGIC[8] = {'T', 'P', 'A', 'R', 'C', '1', '\0', '\0'};
+
+// Block flags
+static constexpr uint8_t ARCHIVE_CHECKSUM = 1;   // header carries a checksum of the payload
+static constexpr uint8_t ARCHIVE_RAW_PRICES = 2; // prices stored as 8-byte doubles
+static constexpr uint8_t ARCHIVE_RAW_SIZES = 4;  // sizes stored as 8-byte doubles
+
+// Precedes every block's payload
+struct TickArchiveBlockHeader
+{
+    char magic[4]; // "TPBK"
+    uint32_t rows;
+    uint32_t payload_bytes;
+    uint8_t flags;
+    uint8_t price_decimals;
+    uint8_t size_decimals;
+    uint8_t reserved;
+    uint64_t checksum;
+    int64_t first_exchange_recv_ts_ms;
+    int64_t first_ingest_ts_ms;
+};
+
+static_assert(sizeof(TickArchiveBlockHeader) == 40, "archive block header layout changed");
+
+// Columnar block codec for tick archives. A file is TICK_ARCHIVE_MAGIC followed by independent
+// blocks, each a header plus a payload of:
+//   dictionary   varint count, then per entry varint length + venue, varint length + symbol
+//   instrument   varint dictionary index per row
+//   timestamps   exchange and ingest stamps, each as zig-zag varint deltas from the previous row
+//   prices       integers in units of 10^-price_decimals, zig-zag varint delta from the previous
+//                price of the same instrument in the block (first one absolute)
+//   sizes        varint integers in units of 10^-size_decimals
+// The encoder picks the fewest decimals (at most 9) that reproduce every value of the block
+// exactly, so a recording round-trips bit for bit. A column that needs more falls back to raw
+// doubles for that block. Blocks share no state, so a torn last block loses only itself.
+class TickArchiveEncoder
+{
+public:
+    explicit TickArchiveEncoder(bool checksum = true) : checksum_(checksum) {}
+
+    void add(const MarketTick &tick);
+    size_t rows() const { return price_.size(); }
+    // Appends the encoded block (header and payload) to out and starts a new block
+    void finish(std::string &out);
+
+private:
+    bool checksum_;
+    std::unordered_map<std::string, uint32_t> interned_;
+    std::vector<std::pair<std::string, std::string>> instruments_;
+    std::string key_; // reused venue\0symbol lookup key
+    std::vector<uint32_t> instrument_;
+    std::vector<double> price_;
+    std::vector<double> size_;
+    std::vector<int64_t> exchange_recv_ts_ms_;
+    std::vector<int64_t> ingest_ts_ms_;
+};
+
+class TickArchive
+{
+public:
+    static bool isArchiveFile(const std::string &path);
+    // Every block of an archive in order, decoded into batch columns, until on_batch returns
+    // false. Checksummed blocks are verified when `verify` is set. False if the file cannot be
+    // opened, is not an archive, or a block is corrupt; a truncated last block is ignored.
+    static bool read(const std::string &path, const std::function<bool(const ReplayBatch &)> &on_batch,
+                     bool verify = true);
+    // As read(), starting at the block at byte `offset` (DATA_OFFSET for the first) and passing
+    // each block's offset along with it
+    static bool readFrom(const std::string &path, uint64_t offset,
+                         const std::function<bool(const ReplayBatch &, uint64_t)> &on_batch, bool verify = true);
+    // Decodes one block payload; false if it is malformed
+    static bool decodeBlock(const TickArchiveBlockHeader &header, const char *payload, ReplayBatch &out);
+    static uint64_t checksum(const char *data, size_t len);
+
+    static constexpr uint64_t DATA_OFFSET = sizeof(TICK_ARCHIVE_MAGIC);
+};
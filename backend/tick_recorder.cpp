@@ -0,0 +1,316 @@
+#include "tick_recorder.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+static void copy_field(char *dst, size_t width, const std::string &src)
+{
+    size_t n = std::min(src.size(), width - 1);
+    std::memcpy(dst, src.data(), n);
+    std::memset(dst + n, 0, width - n);
+}
+
+TickRecorder::TickRecorder(const std::string &path, TickRecordFormat format, uint64_t rotate_bytes, size_t queue_capacity)
+    : format_(format), rotate_bytes_(rotate_bytes), fd_(-1), file_index_(0), file_bytes_(0), queue_(queue_capacity),
+      next_seq_(0), recorded_(0), dropped_(0), files_opened_(0), running_(false)
+{
+    // "ticks.ndjson" -> "ticks" + ".ndjson"; the index goes in between
+    size_t slash = path.find_last_of('/');
+    size_t dot = path.find_last_of('.');
+    if (dot != std::string::npos && (slash == std::string::npos || dot > slash))
+    {
+        stem_ = path.substr(0, dot);
+        ext_ = path.substr(dot);
+    }
+    else
+        stem_ = path;
+}
+
+TickRecorder::~TickRecorder()
+{
+    stop();
+}
+
+bool TickRecorder::parseFormat(const std::string &name, TickRecordFormat &format)
+{
+    if (name == "ndjson")
+        format = TickRecordFormat::NDJSON;
+    else if (name == "binary")
+        format = TickRecordFormat::BINARY;
+    else if (name == "archive")
+        format = TickRecordFormat::ARCHIVE;
+    else
+        return false;
+    return true;
+}
+
+bool TickRecorder::openNext()
+{
+    if (fd_ >= 0)
+        ::close(fd_);
+    char name[32];
+    std::string path;
+    struct stat st;
+    do
+    {
+        std::snprintf(name, sizeof(name), "-%06d", ++file_index_);
+        path = stem_ + name + ext_;
+    } while (::stat(path.c_str(), &st) == 0);
+
+    fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (fd_ < 0)
+    {
+        std::cerr << "Failed to open tick recording " << path << std::endl;
+        return false;
+    }
+    file_bytes_ = 0;
+    if (format_ == TickRecordFormat::BINARY)
+    {
+        if (::write(fd_, TICK_FILE_MAGIC, sizeof(TICK_FILE_MAGIC)) != static_cast<ssize_t>(sizeof(TICK_FILE_MAGIC)))
+            return false;
+        file_bytes_ = sizeof(TICK_FILE_MAGIC);
+    }
+    else if (format_ == TickRecordFormat::ARCHIVE)
+    {
+        if (::write(fd_, TICK_ARCHIVE_MAGIC, sizeof(TICK_ARCHIVE_MAGIC)) != static_cast<ssize_t>(sizeof(TICK_ARCHIVE_MAGIC)))
+            return false;
+        file_bytes_ = sizeof(TICK_ARCHIVE_MAGIC);
+    }
+    files_opened_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool TickRecorder::start()
+{
+    if (running_)
+        return true;
+    if (!openNext())
+        return false;
+    running_ = true;
+    writer_thread_ = std::thread(&TickRecorder::run, this);
+    return true;
+}
+
+void TickRecorder::stop()
+{
+    if (!running_)
+        return;
+    running_ = false;
+    if (writer_thread_.joinable())
+        writer_thread_.join();
+    ::close(fd_);
+    fd_ = -1;
+}
+
+void TickRecorder::record(const MarketTick &tick)
+{
+    TickRecord rec;
+    copy_field(rec.venue, sizeof(rec.venue), tick.venue);
+    copy_field(rec.symbol, sizeof(rec.symbol), tick.symbol);
+    rec.price = tick.price;
+    rec.size = tick.size;
+    rec.exchange_recv_ts_ms = tick.exchange_recv_ts_ms;
+    rec.ingest_ts_ms = tick.ingest_ts_ms;
+    rec.seq = next_seq_++;
+    if (!queue_.tryPush(rec))
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Bytes written to out (at most MAX_RECORD_BYTES)
+size_t TickRecorder::format(const TickRecord &rec, char *out) const
+{
+    if (format_ == TickRecordFormat::BINARY)
+    {
+        std::memcpy(out, &rec, sizeof(rec));
+        return sizeof(rec);
+    }
+    int n = std::snprintf(out, MAX_RECORD_BYTES,
+                          "{\"venue\":\"%.16s\",\"symbol\":\"%.24s\",\"price\":%.15g,\"size\":%.15g,\"exchange_recv_ts_ms\":%lld,"
+                          "\"ingest_ts_ms\":%lld}\n",
+                          rec.venue, rec.symbol, rec.price, rec.size, static_cast<long long>(rec.exchange_recv_ts_ms),
+                          static_cast<long long>(rec.ingest_ts_ms));
+    return n > 0 ? std::min<size_t>(static_cast<size_t>(n), MAX_RECORD_BYTES - 1) : 0;
+}
+
+size_t TickRecorder::writeAll(const char *data, size_t len)
+{
+    // Rotate between batches, so a file never ends mid-record
+    uint64_t header_bytes = format_ == TickRecordFormat::NDJSON ? 0 : sizeof(TICK_FILE_MAGIC);
+    if (rotate_bytes_ > 0 && file_bytes_ > header_bytes && file_bytes_ + len > rotate_bytes_ && !openNext())
+        return 0;
+    size_t off = 0;
+    while (off < len)
+    {
+        ssize_t n = ::write(fd_, data + off, len - off);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+        {
+            std::cerr << "Tick recording write failed: " << std::strerror(n < 0 ? errno : ENOSPC) << "; recording stopped"
+                      << std::endl;
+            break;
+        }
+        off += static_cast<size_t>(n);
+    }
+    file_bytes_ += off;
+    return off;
+}
+
+void TickRecorder::truncateTail(size_t bytes)
+{
+    if (bytes == 0)
+        return;
+    file_bytes_ -= bytes;
+    if (::ftruncate(fd_, static_cast<off_t>(file_bytes_)) != 0)
+        std::cerr << "Failed to truncate a torn record off the tick recording" << std::endl;
+}
+
+void TickRecorder::run()
+{
+    std::vector<char> batch(WRITE_BATCH_BYTES);
+    TickRecord rec;
+    TickArchiveEncoder encoder;
+    std::string block;
+    uint64_t block_count = 0;
+    auto block_started = std::chrono::steady_clock::now();
+
+    for (;;)
+    {
+        bool stopping = !running_;
+        size_t used = 0;
+        uint64_t count = 0;
+        if (format_ == TickRecordFormat::ARCHIVE)
+        {
+            while (encoder.rows() < ARCHIVE_BLOCK_ROWS && queue_.tryPop(rec))
+            {
+                if (encoder.rows() == 0)
+                    block_started = std::chrono::steady_clock::now();
+                encoder.add(toTick(rec));
+                ++block_count;
+            }
+            if (encoder.rows() > 0 &&
+                (encoder.rows() >= ARCHIVE_BLOCK_ROWS || stopping ||
+                 std::chrono::steady_clock::now() - block_started >= std::chrono::seconds(1)))
+            {
+                block.clear();
+                encoder.finish(block);
+                size_t written = writeAll(block.data(), block.size());
+                if (written < block.size())
+                {
+                    // A block only decodes whole
+                    truncateTail(written);
+                    dropped_.fetch_add(block_count, std::memory_order_relaxed);
+                    break;
+                }
+                recorded_.fetch_add(block_count, std::memory_order_relaxed);
+                block_count = 0;
+            }
+        }
+        else
+        {
+            while (used + MAX_RECORD_BYTES <= batch.size() && queue_.tryPop(rec))
+            {
+                used += format(rec, batch.data() + used);
+                ++count;
+            }
+            if (used > 0)
+            {
+                size_t written = writeAll(batch.data(), used);
+                if (written < used)
+                {
+                    // Count and keep only the records that reached the file whole
+                    size_t kept = 0;
+                    uint64_t whole = 0;
+                    if (format_ == TickRecordFormat::BINARY)
+                    {
+                        whole = written / sizeof(TickRecord);
+                        kept = static_cast<size_t>(whole) * sizeof(TickRecord);
+                    }
+                    else
+                    {
+                        whole = static_cast<uint64_t>(std::count(batch.data(), batch.data() + written, '\n'));
+                        const char *last = static_cast<const char *>(memrchr(batch.data(), '\n', written));
+                        kept = last ? static_cast<size_t>(last - batch.data()) + 1 : 0;
+                    }
+                    truncateTail(written - kept);
+                    recorded_.fetch_add(whole, std::memory_order_relaxed);
+                    dropped_.fetch_add(count - whole, std::memory_order_relaxed);
+                    break;
+                }
+                recorded_.fetch_add(count, std::memory_order_relaxed);
+            }
+        }
+
+        if (stopping && queue_.sizeApprox() == 0 && encoder.rows() == 0)
+            break;
+        if (queue_.sizeApprox() == 0)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+bool TickRecorder::isBinaryFile(const std::string &path)
+{
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+    char magic[sizeof(TICK_FILE_MAGIC)];
+    bool binary = ::read(fd, magic, sizeof(magic)) == static_cast<ssize_t>(sizeof(magic)) &&
+                  std::memcmp(magic, TICK_FILE_MAGIC, sizeof(magic)) == 0;
+    ::close(fd);
+    return binary;
+}
+
+bool TickRecorder::read(const std::string &path, const std::function<bool(const TickRecord &)> &on_record)
+{
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+    char magic[sizeof(TICK_FILE_MAGIC)];
+    if (::read(fd, magic, sizeof(magic)) != static_cast<ssize_t>(sizeof(magic)) ||
+        std::memcmp(magic, TICK_FILE_MAGIC, sizeof(magic)) != 0)
+    {
+        ::close(fd);
+        return false;
+    }
+    std::vector<char> buf(WRITE_BATCH_BYTES);
+    size_t filled = 0;
+    bool more = true;
+    while (more)
+    {
+        ssize_t n = ::read(fd, buf.data() + filled, buf.size() - filled);
+        if (n <= 0)
+            break;
+        filled += static_cast<size_t>(n);
+        size_t whole = filled - filled % sizeof(TickRecord);
+        for (size_t off = 0; off < whole && more; off += sizeof(TickRecord))
+        {
+            TickRecord rec;
+            std::memcpy(&rec, buf.data() + off, sizeof(rec));
+            more = on_record(rec);
+        }
+        // Keep a partial trailing record (torn write) for the next read
+        std::memmove(buf.data(), buf.data() + whole, filled - whole);
+        filled -= whole;
+    }
+    ::close(fd);
+    return true;
+}
+
+MarketTick TickRecorder::toTick(const TickRecord &rec)
+{
+    MarketTick tick;
+    tick.venue.assign(rec.venue, ::strnlen(rec.venue, sizeof(rec.venue)));
+    tick.symbol.assign(rec.symbol, ::strnlen(rec.symbol, sizeof(rec.symbol)));
+    tick.price = rec.price;
+    tick.size = rec.size;
+    tick.exchange_recv_ts_ms = rec.exchange_recv_ts_ms;
+    tick.ingest_ts_ms = rec.ingest_ts_ms;
+    return tick;
+}
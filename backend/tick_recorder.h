@@ -0,0 +1,95 @@
+#pragma once
+
+#include "data_source.h"
+#include "lockfree_queue.h"
+#include "tick_archive.h"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <thread>
+
+enum class TickRecordFormat
+{
+    NDJSON,  // one line per tick, the fields ReplayFeed::parseLine reads
+    BINARY,  // TICK_FILE_MAGIC, then fixed-size TickRecords
+    ARCHIVE, // TICK_ARCHIVE_MAGIC, then compressed TickArchiveEncoder blocks
+};
+
+// Fixed-size binary tick; venue and symbol are NUL-padded to their field width
+struct TickRecord
+{
+    char venue[16];
+    char symbol[24];
+    double price;
+    double size;
+    int64_t exchange_recv_ts_ms;
+    int64_t ingest_ts_ms;
+    uint64_t seq;
+};
+
+static_assert(sizeof(TickRecord) == 80, "tick record layout changed");
+
+// First 8 bytes of every binary tick file
+static constexpr char TICK_FILE_MAGIC[8] = {'T', 'P', 'T', 'I', 'C', 'K', '1', '\0'};
+
+// Records the live tick stream for later replay. The feed thread copies each tick into a
+// fixed-size record on a lock-free ring and returns; if the writer falls a full ring behind the
+// tick is dropped and counted rather than stalling the feed. A writer thread drains the ring in
+// batches of up to 1 MB per write() into append-only files that rotate once they reach
+// rotate_bytes: <stem>-000001<ext>, <stem>-000002<ext>, ... Numbering continues after the
+// highest file already present, so a restart never appends to or overwrites an old file.
+// ARCHIVE files are written a block at a time: ARCHIVE_BLOCK_ROWS ticks, or whatever arrived in
+// the last second when the feed is slower.
+class TickRecorder
+{
+public:
+    TickRecorder(const std::string &path, TickRecordFormat format, uint64_t rotate_bytes = 256ull << 20,
+                 size_t queue_capacity = 65536);
+    ~TickRecorder();
+
+    bool start();
+    void stop();
+
+    // Feed thread
+    void record(const MarketTick &tick);
+
+    uint64_t getRecorded() const { return recorded_.load(std::memory_order_relaxed); }
+    uint64_t getDropped() const { return dropped_.load(std::memory_order_relaxed); }
+    uint64_t getFilesOpened() const { return files_opened_.load(std::memory_order_relaxed); }
+
+    static bool parseFormat(const std::string &name, TickRecordFormat &format);
+    static bool isBinaryFile(const std::string &path);
+    // Every complete record of a binary tick file in order until on_record returns false; false
+    // if the file cannot be opened or is not a tick file
+    static bool read(const std::string &path, const std::function<bool(const TickRecord &)> &on_record);
+    static MarketTick toTick(const TickRecord &record);
+
+private:
+    void run();
+    bool openNext();
+    size_t format(const TickRecord &record, char *out) const;
+    // Bytes of data that reached the file: len, unless a write or the rotation before it failed
+    size_t writeAll(const char *data, size_t len);
+    // Removes the last `bytes` written (a torn record after a failed write)
+    void truncateTail(size_t bytes);
+
+    std::string stem_;
+    std::string ext_;
+    TickRecordFormat format_;
+    uint64_t rotate_bytes_;
+    int fd_;
+    int file_index_;
+    uint64_t file_bytes_;
+    BoundedQueue<TickRecord> queue_;
+    uint64_t next_seq_; // feed thread only
+    std::atomic<uint64_t> recorded_;
+    std::atomic<uint64_t> dropped_;
+    std::atomic<uint64_t> files_opened_;
+    std::atomic<bool> running_;
+    std::thread writer_thread_;
+
+    static constexpr size_t WRITE_BATCH_BYTES = 1 << 20;
+    static constexpr size_t MAX_RECORD_BYTES = 256; // longest NDJSON line
+    static constexpr size_t ARCHIVE_BLOCK_ROWS = 65536;
+};
@@ -0,0 +1,183 @@
+#include "tick_store.h"
+#include "replay_decoder.h"
+#include "replay_feed.h"
+#include "tick_archive.h"
+#include "tick_recorder.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <limits>
+#include <unistd.h>
+
+TickStore::TickStore(const std::string &path, int64_t index_interval_ms)
+    : path_(path), index_interval_ms_(std::max<int64_t>(1, index_interval_ms)), format_(TickFileFormat::NDJSON),
+      data_offset_(0), ticks_(0), first_ts_(0), last_ts_(0)
+{
+}
+
+bool TickStore::open()
+{
+    int fd = ::open(path_.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+    ::close(fd);
+
+    if (TickArchive::isArchiveFile(path_))
+    {
+        format_ = TickFileFormat::ARCHIVE;
+        data_offset_ = TickArchive::DATA_OFFSET;
+    }
+    else if (TickRecorder::isBinaryFile(path_))
+    {
+        format_ = TickFileFormat::BINARY;
+        data_offset_ = sizeof(TICK_FILE_MAGIC);
+    }
+
+    index_.clear();
+    ticks_ = 0;
+    last_ts_ = std::numeric_limits<int64_t>::min();
+    scanAt(begin(), [&](MarketTick &tick, uint64_t offset, uint32_t skip)
+           {
+        int64_t ts = tick.ingest_ts_ms;
+        if (ticks_ == 0)
+            first_ts_ = ts;
+        // Entries only move forward in time, so the index stays sorted even if stamps step back
+        if (index_.empty() || ts >= index_.back().ts_ms + index_interval_ms_)
+            index_.push_back(TickIndexEntry{ts, offset, skip, ticks_});
+        last_ts_ = std::max(last_ts_, ts);
+        ++ticks_;
+        return true; });
+    if (ticks_ == 0)
+        last_ts_ = 0;
+    return true;
+}
+
+TickIndexEntry TickStore::seek(int64_t ts_ms) const
+{
+    auto it = std::upper_bound(index_.begin(), index_.end(), ts_ms, [](int64_t ts, const TickIndexEntry &entry)
+                               { return ts < entry.ts_ms; });
+    if (it == index_.begin())
+        return begin();
+    return *(it - 1);
+}
+
+bool TickStore::scanAt(const TickIndexEntry &from, const std::function<bool(MarketTick &, uint64_t, uint32_t)> &on_tick) const
+{
+    MarketTick tick;
+    if (format_ == TickFileFormat::ARCHIVE)
+    {
+        return TickArchive::readFrom(path_, from.offset, [&](const ReplayBatch &batch, uint64_t block_offset)
+                                     {
+            size_t i = block_offset == from.offset ? from.skip : 0;
+            for (; i < batch.rows(); ++i)
+            {
+                batch.toTick(i, tick);
+                if (!on_tick(tick, block_offset, static_cast<uint32_t>(i)))
+                    return false;
+            }
+            return true; });
+    }
+
+    if (format_ == TickFileFormat::BINARY)
+    {
+        int fd = ::open(path_.c_str(), O_RDONLY);
+        if (fd < 0)
+            return false;
+        std::vector<char> buf(sizeof(TickRecord) * 8192);
+        uint64_t offset = from.offset;
+        bool more = true;
+        while (more)
+        {
+            ssize_t n = ::pread(fd, buf.data(), buf.size(), static_cast<off_t>(offset));
+            size_t whole = n > 0 ? static_cast<size_t>(n) - static_cast<size_t>(n) % sizeof(TickRecord) : 0;
+            if (whole == 0)
+                break;
+            for (size_t off = 0; off < whole && more; off += sizeof(TickRecord))
+            {
+                TickRecord rec;
+                std::memcpy(&rec, buf.data() + off, sizeof(rec));
+                tick = TickRecorder::toTick(rec);
+                more = on_tick(tick, offset + off, 0);
+            }
+            offset += whole;
+        }
+        ::close(fd);
+        return true;
+    }
+
+    std::ifstream in(path_, std::ios::binary);
+    if (!in.is_open())
+        return false;
+    in.seekg(static_cast<std::streamoff>(from.offset));
+    uint64_t offset = from.offset;
+    std::string line;
+    while (std::getline(in, line))
+    {
+        uint64_t line_offset = offset;
+        offset += line.size() + 1;
+        if (ReplayFeed::parseLine(line, tick) && !on_tick(tick, line_offset, 0))
+            break;
+    }
+    return true;
+}
+
+bool TickStore::scan(const TickIndexEntry &from, const std::function<bool(MarketTick &)> &on_tick, int decode_threads) const
+{
+    if (format_ == TickFileFormat::NDJSON && decode_threads > 1)
+    {
+        ParallelReplayDecoder decoder(path_, decode_threads, 4 << 20, from.offset);
+        if (!decoder.start())
+            return false;
+        ReplayBatch batch;
+        MarketTick tick;
+        while (decoder.next(batch))
+        {
+            for (size_t i = 0; i < batch.rows(); ++i)
+            {
+                batch.toTick(i, tick);
+                if (!on_tick(tick))
+                    return true;
+            }
+        }
+        return true;
+    }
+    return scanAt(from, [&](MarketTick &tick, uint64_t, uint32_t)
+                  { return on_tick(tick); });
+}
+
+bool TickStore::range(int64_t from_ms, int64_t to_ms, const std::string &symbol,
+                      const std::function<bool(const MarketTick &)> &on_tick) const
+{
+    return scan(seek(from_ms), [&](MarketTick &tick)
+                {
+        if (tick.ingest_ts_ms >= to_ms)
+            return false;
+        if (tick.ingest_ts_ms < from_ms || (!symbol.empty() && tick.symbol != symbol))
+            return true;
+        return on_tick(tick); });
+}
+
+bool TickStore::parseTime(const std::string &text, int64_t anchor_ms, int64_t &ts_ms)
+{
+    if (text.empty())
+        return false;
+    if (std::all_of(text.begin(), text.end(), [](char c)
+                    { return std::isdigit(static_cast<unsigned char>(c)) != 0; }))
+    {
+        ts_ms = std::atoll(text.c_str());
+        return true;
+    }
+    int h = 0, m = 0, s = 0;
+    char extra = 0;
+    int fields = std::sscanf(text.c_str(), "%d:%d:%d%c", &h, &m, &s, &extra);
+    if (fields < 2 || fields > 3 || h < 0 || h > 23 || m < 0 || m > 59 || s < 0 || s > 59)
+        return false;
+    const int64_t day_ms = 86400000;
+    int64_t day_start = anchor_ms - ((anchor_ms % day_ms) + day_ms) % day_ms;
+    ts_ms = day_start + ((h * 60 + m) * 60 + s) * 1000ll;
+    return true;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "data_source.h"
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+enum class TickFileFormat
+{
+    NDJSON,
+    BINARY,  // TickRecorder fixed records
+    ARCHIVE, // TickArchive blocks
+};
+
+// A resume point in a recording: the byte offset of a line, record or archive block, plus the
+// rows of that block to skip (archives only)
+struct TickIndexEntry
+{
+    int64_t ts_ms{0};
+    uint64_t offset{0};
+    uint32_t skip{0};
+    uint64_t tick{0}; // ticks before this point
+};
+
+// Read-only, time-indexed view of one recording in any of the three formats. open() scans the
+// file once and keeps a sparse index: a resume point every index_interval_ms of ingest time, so
+// seek() is a binary search and a read from any time decodes at most one interval of ticks it
+// does not need. After open() every method is const and safe to call from several threads.
+class TickStore
+{
+public:
+    explicit TickStore(const std::string &path, int64_t index_interval_ms = 1000);
+
+    // False if the file cannot be opened
+    bool open();
+
+    const std::string &path() const { return path_; }
+    TickFileFormat format() const { return format_; }
+    uint64_t ticks() const { return ticks_; }
+    int64_t firstTs() const { return first_ts_; }
+    int64_t lastTs() const { return last_ts_; }
+    size_t indexEntries() const { return index_.size(); }
+
+    // The latest resume point at or before ts_ms; reading from it reaches every tick at ts_ms
+    // and later. O(log n) in the index size.
+    TickIndexEntry seek(int64_t ts_ms) const;
+    TickIndexEntry begin() const { return TickIndexEntry{first_ts_, data_offset_, 0, 0}; }
+    // Ticks in file order from `from` until on_tick returns false. NDJSON is decoded on
+    // decode_threads workers when above 1.
+    bool scan(const TickIndexEntry &from, const std::function<bool(MarketTick &)> &on_tick, int decode_threads = 1) const;
+    // Ticks with from_ms <= ingest_ts_ms < to_ms, of one symbol unless `symbol` is empty
+    bool range(int64_t from_ms, int64_t to_ms, const std::string &symbol, const std::function<bool(const MarketTick &)> &on_tick) const;
+
+    // "1792374160000" (epoch ms) or "14:30", "14:30:15" (UTC time of day on the day of
+    // anchor_ms, e.g. firstTs()); false if the text is neither
+    static bool parseTime(const std::string &text, int64_t anchor_ms, int64_t &ts_ms);
+
+private:
+    // Like scan(), also passing each tick's resume point (offset and skip)
+    bool scanAt(const TickIndexEntry &from, const std::function<bool(MarketTick &, uint64_t, uint32_t)> &on_tick) const;
+
+    std::string path_;
+    int64_t index_interval_ms_;
+    TickFileFormat format_;
+    uint64_t data_offset_;
+    uint64_t ticks_;
+    int64_t first_ts_;
+    int64_t last_ts_;
+    std::vector<TickIndexEntry> index_;
+};
@@ -0,0 +1,297 @@
+// Backtest over a tick recording (or a synthetic random walk) with signals precomputed by the
+// vectorized indicator kernels: each instrument's price/size columns go through
+// IStrategy::precompute once, then a single pass only simulates execution (mark to market, risk
+// check, OrderBook::submitOrder). --compare also runs the per-tick path (onMarketTick per tick)
+// on the same data, reports both timings and counts ticks where the two paths disagree.
+//
+//   tradepulse_backtest [--replay_file=PATH [--decode_threads=N] | --ticks=N --venues=N] [--strategy=NAME]
+//                       [--lookback=N] [--order_qty=N] [--simd=scalar|sse2|avx2] [--runs=N] [--compare]
+//
+// The orders/sec risk bucket is disabled: it refills on wall-clock time, which means nothing
+// when a recording is replayed as fast as possible.
+
+#include "indicator_kernels.h"
+#include "replay_feed.h"
+#include "risk.h"
+#include "strategies/strategy_factory.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <random>
+#include <vector>
+
+static bool starts_with(const char *s, const char *p) { return std::strncmp(s, p, std::strlen(p)) == 0; }
+
+static std::vector<MarketTick> loadTicks(const std::string &path, int decode_threads)
+{
+    std::vector<MarketTick> ticks;
+    ReplayFeed::forEachTick(path, [&](MarketTick &tick)
+                            {
+        ticks.push_back(tick);
+        return true; }, decode_threads);
+    return ticks;
+}
+
+static std::vector<MarketTick> makeTicks(int count, int venues)
+{
+    std::mt19937_64 rng(42);
+    std::normal_distribution<double> step(0.0, 0.05);
+    std::uniform_real_distribution<double> size(0.1, 5.0);
+    std::vector<double> prices(venues, 100.0);
+    std::vector<MarketTick> ticks;
+    ticks.reserve(count);
+    for (int i = 0; i < count; ++i)
+    {
+        int v = i % venues;
+        prices[v] += step(rng);
+        MarketTick t;
+        t.venue = "V" + std::to_string(v);
+        t.symbol = "BTC-USD";
+        t.price = prices[v];
+        t.size = size(rng);
+        t.exchange_recv_ts_ms = i;
+        t.ingest_ts_ms = i;
+        ticks.push_back(t);
+    }
+    return ticks;
+}
+
+struct Params
+{
+    int lookback{0}; // 0 keeps the strategy default
+    int order_qty{0};
+};
+
+static std::unique_ptr<IStrategy> build(const std::string &name, OrderBook &book, const Params &params)
+{
+    std::unique_ptr<IStrategy> strategy = makeStrategy(name, book);
+    if (params.lookback > 0)
+        strategy->setLookback(params.lookback);
+    if (params.order_qty > 0)
+        strategy->setOrderQuantity(params.order_qty);
+    return strategy;
+}
+
+static void configureRisk(RiskGate &risk)
+{
+    RiskLimits limits;
+    limits.max_orders_per_sec = 0.0;
+    risk.setDefaultLimits(limits);
+}
+
+struct RunResult
+{
+    double signal_ms{0.0};   // per-tick path: whole run
+    double simulate_ms{0.0}; // batch path only
+    int trades{0};
+    double pnl{0.0};
+    std::vector<int32_t> orders; // signed quantity emitted at each tick
+};
+
+static double msSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static RunResult runPerTick(const std::string &name, const Params &params, const std::vector<MarketTick> &ticks)
+{
+    RunResult result;
+    result.orders.assign(ticks.size(), 0);
+    OrderBook book;
+    RiskGate risk;
+    configureRisk(risk);
+    std::unique_ptr<IStrategy> strategy = build(name, book, params);
+    size_t current = 0;
+    strategy->on_order = [&](const Order &order)
+    {
+        result.orders[current] = order.side == OrderSide::BUY ? order.quantity : -order.quantity;
+        if (risk.check(order) == RiskReject::NONE)
+            book.submitOrder(order);
+    };
+    auto start = std::chrono::steady_clock::now();
+    for (current = 0; current < ticks.size(); ++current)
+    {
+        const MarketTick &tick = ticks[current];
+        book.markToMarket(tick);
+        risk.onMarketTick(tick);
+        strategy->onMarketTick(tick);
+    }
+    result.signal_ms = msSince(start);
+    result.trades = book.getTradeCount();
+    result.pnl = book.getTotalPnL();
+    return result;
+}
+
+static bool runBatch(const std::string &name, const Params &params, const std::vector<MarketTick> &ticks, RunResult &result)
+{
+    OrderBook book;
+    RiskGate risk;
+    configureRisk(risk);
+    std::unique_ptr<IStrategy> strategy = build(name, book, params);
+
+    // Columnar copy per instrument; strategies keep per-instrument state, so each (venue, symbol)
+    // is one series
+    struct Columns
+    {
+        std::vector<double> price;
+        std::vector<double> size;
+        std::vector<size_t> rows;
+    };
+    std::map<InstrumentId, Columns> instruments;
+    for (size_t i = 0; i < ticks.size(); ++i)
+    {
+        Columns &c = instruments[InstrumentId(ticks[i].venue, ticks[i].symbol)];
+        c.price.push_back(ticks[i].price);
+        c.size.push_back(ticks[i].size);
+        c.rows.push_back(i);
+    }
+
+    result.orders.assign(ticks.size(), 0);
+    auto start = std::chrono::steady_clock::now();
+    std::vector<int32_t> instrument_orders;
+    for (auto &entry : instruments)
+    {
+        Columns &c = entry.second;
+        instrument_orders.resize(c.price.size());
+        if (!strategy->precompute(c.price.data(), c.size.data(), c.price.size(), instrument_orders.data()))
+            return false;
+        for (size_t j = 0; j < c.rows.size(); ++j)
+            result.orders[c.rows[j]] = instrument_orders[j];
+    }
+    result.signal_ms = msSince(start);
+
+    start = std::chrono::steady_clock::now();
+    uint64_t order_id = 0;
+    for (size_t i = 0; i < ticks.size(); ++i)
+    {
+        const MarketTick &tick = ticks[i];
+        book.markToMarket(tick);
+        risk.onMarketTick(tick);
+        int32_t qty = result.orders[i];
+        if (qty == 0)
+            continue;
+        Order order;
+        order.id = ++order_id;
+        order.venue = tick.venue;
+        order.symbol = tick.symbol;
+        order.side = qty > 0 ? OrderSide::BUY : OrderSide::SELL;
+        order.price = tick.price;
+        order.quantity = qty > 0 ? qty : -qty;
+        order.timestamp = std::chrono::system_clock::now();
+        order.exchange_recv_ts_ms = tick.exchange_recv_ts_ms;
+        order.ingest_ts_ms = tick.ingest_ts_ms;
+        if (risk.check(order) == RiskReject::NONE)
+            book.submitOrder(order);
+    }
+    result.simulate_ms = msSince(start);
+    result.trades = book.getTradeCount();
+    result.pnl = book.getTotalPnL();
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    std::string replay_file;
+    std::string only_strategy;
+    int tick_count = 1000000;
+    int venues = 4;
+    int runs = 3;
+    bool compare = false;
+    int decode_threads = 1;
+    Params params;
+    for (int i = 1; i < argc; ++i)
+    {
+        const char *a = argv[i];
+        if (starts_with(a, "--replay_file="))
+            replay_file = a + 14;
+        else if (starts_with(a, "--strategy="))
+            only_strategy = a + 11;
+        else if (starts_with(a, "--ticks="))
+            tick_count = std::atoi(a + 8);
+        else if (starts_with(a, "--venues="))
+            venues = std::max(1, std::atoi(a + 9));
+        else if (starts_with(a, "--lookback="))
+            params.lookback = std::atoi(a + 11);
+        else if (starts_with(a, "--order_qty="))
+            params.order_qty = std::atoi(a + 12);
+        else if (starts_with(a, "--runs="))
+            runs = std::max(1, std::atoi(a + 7));
+        else if (starts_with(a, "--decode_threads="))
+            decode_threads = std::max(1, std::atoi(a + 17));
+        else if (starts_with(a, "--simd="))
+        {
+            const char *level = a + 7;
+            SimdLevel requested = std::strcmp(level, "scalar") == 0 ? SimdLevel::SCALAR
+                                  : std::strcmp(level, "sse2") == 0 ? SimdLevel::SSE2
+                                                                    : SimdLevel::AVX2;
+            setSimdLevel(requested);
+        }
+        else if (std::strcmp(a, "--compare") == 0)
+            compare = true;
+    }
+
+    auto load_start = std::chrono::steady_clock::now();
+    std::vector<MarketTick> ticks = replay_file.empty() ? makeTicks(tick_count, venues) : loadTicks(replay_file, decode_threads);
+    double load_ms = msSince(load_start);
+    if (ticks.empty())
+    {
+        std::fprintf(stderr, "no ticks to backtest\n");
+        return 1;
+    }
+    std::printf("%zu ticks loaded in %.1f ms (%d decode threads), kernels: %s\n", ticks.size(), load_ms, decode_threads,
+                simdLevelName(activeSimdLevel()));
+    std::printf("%-16s %12s %12s %12s %10s %14s", "strategy", "signals ms", "simulate ms", "per-tick ms", "trades",
+                "pnl");
+    if (compare)
+        std::printf(" %8s %10s", "speedup", "mismatches");
+    std::printf("\n");
+
+    std::vector<std::string> names = only_strategy.empty() ? strategyNames() : std::vector<std::string>{only_strategy};
+    int status = 0;
+    for (const auto &name : names)
+    {
+        // Best of N to keep scheduler noise out of the timings
+        RunResult batch;
+        RunResult tick;
+        batch.signal_ms = tick.signal_ms = 1e18;
+        bool supported = true;
+        for (int r = 0; r < runs && supported; ++r)
+        {
+            RunResult b;
+            supported = runBatch(name, params, ticks, b);
+            if (supported && b.signal_ms + b.simulate_ms < batch.signal_ms + batch.simulate_ms)
+                batch = std::move(b);
+            if (compare)
+            {
+                RunResult t = runPerTick(name, params, ticks);
+                if (t.signal_ms < tick.signal_ms)
+                    tick = std::move(t);
+            }
+        }
+        if (!supported)
+        {
+            std::printf("%-16s no batch form\n", name.c_str());
+            continue;
+        }
+        std::printf("%-16s %12.2f %12.2f", name.c_str(), batch.signal_ms, batch.simulate_ms);
+        if (compare)
+            std::printf(" %12.2f", tick.signal_ms);
+        else
+            std::printf(" %12s", "-");
+        std::printf(" %10d %14.2f", batch.trades, batch.pnl);
+        if (compare)
+        {
+            size_t mismatches = 0;
+            for (size_t i = 0; i < ticks.size(); ++i)
+                mismatches += batch.orders[i] != tick.orders[i];
+            std::printf(" %7.2fx %10zu", tick.signal_ms / (batch.signal_ms + batch.simulate_ms), mismatches);
+            if (mismatches > 0)
+                status = 1;
+        }
+        std::printf("\n");
+    }
+    return status;
+}
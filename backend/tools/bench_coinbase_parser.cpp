@@ -0,0 +1,257 @@
+// Coinbase market_trades parsing: the in-place parser (coinbase_parser.h) against the previous
+// find/substr/atof loop, in ns per message and per trade, with heap allocations counted. Payloads
+// come from --payloads (one raw WebSocket message per line, e.g. captured from the live feed) or
+// are generated in the same shape: a 100-trade subscribe snapshot, then updates of mostly 1-3
+// trades with occasional bursts of up to 60. The run fails if the parser misses a trade or a
+// price/size disagrees with the old loop.
+//
+//   tradepulse_bench_coinbase [--payloads=PATH] [--messages=N] [--runs=N]
+
+#include "coinbase_parser.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+static std::atomic<uint64_t> g_allocations{0};
+
+void *operator new(size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = std::malloc(size))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, size_t) noexcept { std::free(p); }
+
+static bool starts_with(const char *s, const char *p) { return std::strncmp(s, p, std::strlen(p)) == 0; }
+
+struct LegacyTrade
+{
+    double price;
+    double size;
+    int64_t exch_ms;
+};
+
+// The loop LiveFeedCoinbase::run used before the in-place parser, minus its 10-trade cap
+static void parseLegacy(const std::string &raw, std::vector<LegacyTrade> &out)
+{
+    out.clear();
+    std::string msg = raw; // stands in for buffers_to_string
+    if (msg.find("\"channel\":\"market_trades\"") == std::string::npos)
+        return;
+    size_t pos = 0;
+    while (true)
+    {
+        size_t ppos = msg.find("\"price\":\"", pos);
+        if (ppos == std::string::npos)
+            break;
+        size_t pend = msg.find('"', ppos + 9);
+        if (pend == std::string::npos)
+            break;
+        std::string price_str = msg.substr(ppos + 9, pend - (ppos + 9));
+        size_t spos = msg.find("\"size\":\"", pend);
+        if (spos == std::string::npos)
+        {
+            pos = pend + 1;
+            continue;
+        }
+        size_t send = msg.find('"', spos + 8);
+        if (send == std::string::npos)
+        {
+            pos = spos + 1;
+            continue;
+        }
+        std::string size_str = msg.substr(spos + 8, send - (spos + 8));
+        int64_t exch_ms = -1;
+        size_t tpos = msg.find("\"time\":\"", send);
+        if (tpos != std::string::npos)
+        {
+            size_t tend = msg.find('"', tpos + 8);
+            if (tend != std::string::npos)
+            {
+                std::string tstr = msg.substr(tpos + 8, tend - (tpos + 8));
+                if (tstr.size() >= 13)
+                    exch_ms = std::atoll(tstr.substr(0, 13).c_str());
+            }
+        }
+        double price = std::atof(price_str.c_str());
+        if (price > 0.0)
+            out.push_back(LegacyTrade{price, std::atof(size_str.c_str()), exch_ms});
+        pos = send + 1;
+    }
+}
+
+static std::string isoTime(int64_t ms, int fraction_digits)
+{
+    time_t secs = static_cast<time_t>(ms / 1000);
+    struct tm tm;
+    gmtime_r(&secs, &tm);
+    char buf[64];
+    size_t n = std::strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%S", &tm);
+    // Coinbase sends microsecond-or-finer fractions; pad the millis out to the requested width
+    std::snprintf(buf + n, sizeof(buf) - n, ".%03d%0*dZ", static_cast<int>(ms % 1000), fraction_digits - 3, 0);
+    return buf;
+}
+
+static std::vector<std::string> generatePayloads(int messages)
+{
+    std::mt19937_64 rng(7);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::vector<std::string> out;
+    int64_t now_ms = 1760000000000;
+    int64_t trade_id = 800000000;
+    double price = 64213.57;
+    for (int m = 0; m < messages; ++m)
+    {
+        int trades = m == 0 ? 100 : unit(rng) < 0.02 ? 20 + static_cast<int>(unit(rng) * 40) : 1 + static_cast<int>(unit(rng) * 3);
+        now_ms += 1 + static_cast<int64_t>(unit(rng) * 50);
+        std::string msg = "{\"channel\":\"market_trades\",\"client_id\":\"\",\"timestamp\":\"" + isoTime(now_ms, 9) +
+                          "\",\"sequence_num\":" + std::to_string(m) + ",\"events\":[{\"type\":\"" +
+                          (m == 0 ? "snapshot" : "update") + "\",\"trades\":[";
+        // Newest first, as Coinbase sends them
+        for (int t = 0; t < trades; ++t)
+        {
+            price = std::max(0.01, price + std::round((unit(rng) - 0.5) * 200) / 100.0);
+            char fields[256];
+            std::snprintf(fields, sizeof(fields),
+                          "%s{\"trade_id\":\"%lld\",\"product_id\":\"BTC-USD\",\"price\":\"%.2f\",\"size\":\"%.8f\",\"side\":\"%s\",\"time\":\"%s\"}",
+                          t > 0 ? "," : "", static_cast<long long>(trade_id + trades - t), price, unit(rng) * 0.5,
+                          unit(rng) < 0.5 ? "BUY" : "SELL", isoTime(now_ms - t, 6).c_str());
+            msg += fields;
+        }
+        trade_id += trades;
+        msg += "]}]}";
+        out.push_back(std::move(msg));
+    }
+    return out;
+}
+
+int main(int argc, char **argv)
+{
+    std::string payload_file;
+    int messages = 20000;
+    int runs = 5;
+    for (int i = 1; i < argc; ++i)
+    {
+        const char *a = argv[i];
+        if (starts_with(a, "--payloads="))
+            payload_file = a + 11;
+        else if (starts_with(a, "--messages="))
+            messages = std::max(1, std::atoi(a + 11));
+        else if (starts_with(a, "--runs="))
+            runs = std::max(1, std::atoi(a + 7));
+    }
+
+    std::vector<std::string> payloads;
+    if (!payload_file.empty())
+    {
+        std::ifstream in(payload_file);
+        if (!in.is_open())
+        {
+            std::fprintf(stderr, "Failed to open %s\n", payload_file.c_str());
+            return 1;
+        }
+        std::string line;
+        while (std::getline(in, line))
+        {
+            if (!line.empty())
+                payloads.push_back(line);
+        }
+    }
+    else
+        payloads = generatePayloads(messages);
+
+    // Correctness: every trade found, prices and sizes identical to the old loop
+    size_t bytes = 0, trades = 0, failures = 0;
+    CoinbaseMessage message;
+    std::vector<LegacyTrade> legacy;
+    for (const auto &payload : payloads)
+    {
+        bytes += payload.size();
+        parseLegacy(payload, legacy);
+        if (!parseCoinbaseMessage(payload, message))
+        {
+            ++failures;
+            continue;
+        }
+        if (message.channel != "market_trades")
+            continue;
+        size_t priced = 0;
+        for (const auto &trade : message.trades)
+            priced += trade.price > 0.0;
+        if (priced != legacy.size())
+            ++failures;
+        for (size_t i = 0, j = 0; i < message.trades.size() && j < legacy.size(); ++i)
+        {
+            if (!(message.trades[i].price > 0.0))
+                continue;
+            if (message.trades[i].price != legacy[j].price || message.trades[i].size != legacy[j].size)
+                ++failures;
+            ++j;
+        }
+        trades += message.trades.size();
+    }
+    int64_t check_ms = 0;
+    if (!parseIso8601Ms("2019-08-14T20:42:27.265123456Z", check_ms) || check_ms != 1565815347265 ||
+        !parseIso8601Ms("2019-08-14T22:42:27+02:00", check_ms) || check_ms != 1565815347000)
+        ++failures;
+
+    auto best_of = [&](auto &&fn, uint64_t &allocations)
+    {
+        double best = 1e18;
+        for (int r = 0; r < runs; ++r)
+        {
+            uint64_t before = g_allocations.load();
+            auto start = std::chrono::steady_clock::now();
+            fn();
+            best = std::min(best, std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count());
+            allocations = g_allocations.load() - before;
+        }
+        return best;
+    };
+
+    size_t sink = 0;
+    uint64_t legacy_allocs = 0, parser_allocs = 0;
+    double legacy_ns = best_of([&]
+                               {
+        for (const auto &payload : payloads)
+        {
+            parseLegacy(payload, legacy);
+            sink += legacy.size();
+        } }, legacy_allocs);
+    double parser_ns = best_of([&]
+                               {
+        for (const auto &payload : payloads)
+        {
+            parseCoinbaseMessage(payload, message);
+            sink += message.trades.size();
+        } }, parser_allocs);
+
+    std::printf("%zu messages, %zu trades, %.1f KB (%s), best of %d\n", payloads.size(), trades, bytes / 1024.0,
+                payload_file.empty() ? "generated" : payload_file.c_str(), runs);
+    std::printf("%-10s %10s %10s %10s %12s\n", "parser", "ns/msg", "ns/trade", "MB/s", "allocs/msg");
+    auto row = [&](const char *name, double ns, uint64_t allocs)
+    {
+        std::printf("%-10s %10.1f %10.1f %10.0f %12.2f\n", name, ns / payloads.size(), ns / std::max<size_t>(1, trades),
+                    bytes / ns * 1e3, static_cast<double>(allocs) / payloads.size());
+    };
+    row("find/atof", legacy_ns, legacy_allocs);
+    row("in-place", parser_ns, parser_allocs);
+    std::printf("speedup %.1fx%s\n", legacy_ns / parser_ns, sink == 0 ? " (no trades)" : "");
+    if (failures > 0)
+    {
+        std::fprintf(stderr, "%zu messages parsed differently\n", failures);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,185 @@
+// Batch indicator kernels at each instruction set against the per-tick IndicatorRegistry (and
+// the per-tick RSI / rolling min-max the strategies use), in ns per input element. Every kernel
+// is also checked against the scalar form; results that differ by more than 1e-9 relative fail
+// the run.
+//
+//   tradepulse_bench_indicators [--n=N] [--period=N] [--runs=N]
+
+#include "indicator_kernels.h"
+#include "indicators.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <random>
+#include <vector>
+
+static bool starts_with(const char *s, const char *p) { return std::strncmp(s, p, std::strlen(p)) == 0; }
+
+static int runs = 5;
+
+// Best of N, in ns per element
+static double timeIt(size_t n, const std::function<void()> &fn)
+{
+    double best = 1e18;
+    for (int r = 0; r < runs; ++r)
+    {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        best = std::min(best, ns / static_cast<double>(n));
+    }
+    return best;
+}
+
+static double maxRelativeError(const std::vector<double> &a, const std::vector<double> &b)
+{
+    double worst = 0.0;
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+        if (std::isnan(a[i]) != std::isnan(b[i]))
+            return 1.0;
+        if (std::isnan(a[i]))
+            continue;
+        double scale = std::max(1.0, std::fabs(a[i]));
+        worst = std::max(worst, std::fabs(a[i] - b[i]) / scale);
+    }
+    return worst;
+}
+
+struct Kernel
+{
+    const char *name;
+    // Writes its primary output (mean, ema, rsi, max) into out
+    std::function<void(const std::vector<double> &, std::vector<double> &)> batch;
+    std::function<void(const std::vector<double> &)> per_tick;
+};
+
+int main(int argc, char **argv)
+{
+    size_t n = 1000000;
+    int period = 20;
+    for (int i = 1; i < argc; ++i)
+    {
+        const char *a = argv[i];
+        if (starts_with(a, "--n="))
+            n = static_cast<size_t>(std::max(1, std::atoi(a + 4)));
+        else if (starts_with(a, "--period="))
+            period = std::max(1, std::atoi(a + 9));
+        else if (starts_with(a, "--runs="))
+            runs = std::max(1, std::atoi(a + 7));
+    }
+
+    std::mt19937_64 rng(42);
+    std::normal_distribution<double> step(0.0, 0.05);
+    std::vector<double> prices(n);
+    double p = 100.0;
+    for (auto &x : prices)
+        x = p += step(rng);
+    std::vector<MarketTick> ticks(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        ticks[i].venue = "V0";
+        ticks[i].symbol = "BTC-USD";
+        ticks[i].price = prices[i];
+        ticks[i].size = 1.0;
+    }
+
+    volatile double sink = 0.0;
+    auto registry = [&](std::vector<IndicatorSpec> specs)
+    {
+        return [&, specs](const std::vector<double> &)
+        {
+            IndicatorRegistry reg;
+            for (const auto &spec : specs)
+                reg.declare(spec);
+            for (const auto &tick : ticks)
+                sink = sink + reg.update(tick).values[0];
+        };
+    };
+    std::vector<double> scratch(n);
+    std::vector<Kernel> kernels{
+        {"mean+stddev",
+         [&](const std::vector<double> &x, std::vector<double> &out) { rollingMeanStd(x.data(), n, period, out.data(), scratch.data()); },
+         registry({{IndicatorType::SMA, period}, {IndicatorType::STDDEV, period}})},
+        {"ema",
+         [&](const std::vector<double> &x, std::vector<double> &out) { emaSeries(x.data(), n, period, out.data()); },
+         registry({{IndicatorType::EMA, period}})},
+        {"rsi",
+         [&](const std::vector<double> &x, std::vector<double> &out) { rsiSeries(x.data(), n, period, out.data()); },
+         // RsiStrategy re-sums its deque every tick
+         [&](const std::vector<double> &x)
+         {
+             std::deque<double> window;
+             for (double v : x)
+             {
+                 window.push_back(v);
+                 if (window.size() > static_cast<size_t>(period + 1))
+                     window.pop_front();
+                 double gains = 0.0, losses = 0.0;
+                 for (size_t i = 1; i < window.size(); ++i)
+                 {
+                     double diff = window[i] - window[i - 1];
+                     (diff > 0 ? gains : losses) += std::fabs(diff);
+                 }
+                 sink = sink + gains - losses;
+             }
+         }},
+        {"min+max",
+         [&](const std::vector<double> &x, std::vector<double> &out) { rollingMinMax(x.data(), n, period, scratch.data(), out.data()); },
+         // BreakoutStrategy scans its deque every tick
+         [&](const std::vector<double> &x)
+         {
+             std::deque<double> window;
+             for (double v : x)
+             {
+                 window.push_back(v);
+                 if (window.size() > static_cast<size_t>(period))
+                     window.pop_front();
+                 auto range = std::minmax_element(window.begin(), window.end());
+                 sink = sink + *range.first + *range.second;
+             }
+         }},
+    };
+
+    std::vector<SimdLevel> levels{SimdLevel::SCALAR};
+    if (detectSimdLevel() >= SimdLevel::SSE2)
+        levels.push_back(SimdLevel::SSE2);
+    if (detectSimdLevel() >= SimdLevel::AVX2)
+        levels.push_back(SimdLevel::AVX2);
+
+    std::printf("n=%zu period=%d (ns/element, best of %d)\n", n, period, runs);
+    std::printf("%-12s %10s", "kernel", "per-tick");
+    for (SimdLevel level : levels)
+        std::printf(" %10s", simdLevelName(level));
+    std::printf(" %10s\n", "speedup");
+
+    bool mismatch = false;
+    for (const auto &kernel : kernels)
+    {
+        double per_tick = timeIt(n, [&] { kernel.per_tick(prices); });
+        std::printf("%-12s %10.2f", kernel.name, per_tick);
+        std::vector<double> reference(n), out(n);
+        double best = 1e18;
+        for (SimdLevel level : levels)
+        {
+            setSimdLevel(level);
+            std::vector<double> &target = level == SimdLevel::SCALAR ? reference : out;
+            double ns = timeIt(n, [&] { kernel.batch(prices, target); });
+            best = std::min(best, ns);
+            std::printf(" %10.2f", ns);
+            if (level != SimdLevel::SCALAR && maxRelativeError(reference, out) > 1e-9)
+            {
+                std::fprintf(stderr, "%s: %s differs from scalar\n", kernel.name, simdLevelName(level));
+                mismatch = true;
+            }
+        }
+        std::printf(" %9.1fx\n", per_tick / best);
+    }
+    setSimdLevel(detectSimdLevel());
+    return mismatch ? 1 : 0;
+}
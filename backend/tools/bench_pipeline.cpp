@@ -0,0 +1,241 @@
+// Per-tick latency of the dynamic strategy path (virtual onMarketTick + std::function on_order)
+// against the compile-time StaticPipeline, for every strategy. Both paths run the same chain:
+// markToMarket -> risk tick -> strategy -> risk check -> OrderBook::submitOrder.
+// --count_only replaces submitOrder with a counter to isolate the dispatch cost from the book.
+// Heap allocations are counted after a warm-up pass; any allocation while submitting an order
+// (risk check + OrderBook::submitOrder) in steady state fails the run. Tracing is off unless
+// --trace turns it on for both paths.
+//
+//   tradepulse_bench_pipeline [--ticks=N] [--venues=N] [--runs=N] [--count_only] [--trace]
+
+#include "pipeline.h"
+#include "strategies/strategy_factory.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <random>
+#include <vector>
+
+// Single-threaded tool, so a plain counter is enough
+static uint64_t allocations = 0;
+
+void *operator new(size_t size)
+{
+    ++allocations;
+    if (void *p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, size_t) noexcept { std::free(p); }
+
+static bool starts_with(const char *s, const char *p) { return std::strncmp(s, p, std::strlen(p)) == 0; }
+
+static std::vector<MarketTick> makeTicks(int count, int venues)
+{
+    std::mt19937_64 rng(42);
+    std::normal_distribution<double> step(0.0, 0.05);
+    std::uniform_real_distribution<double> size(0.1, 5.0);
+    std::vector<double> prices(venues, 100.0);
+    std::vector<MarketTick> ticks;
+    ticks.reserve(count);
+    for (int i = 0; i < count; ++i)
+    {
+        int v = i % venues;
+        prices[v] += step(rng);
+        MarketTick t;
+        t.venue = "V" + std::to_string(v);
+        t.symbol = "BTC-USD";
+        t.price = prices[v];
+        t.size = size(rng);
+        t.exchange_recv_ts_ms = i;
+        t.ingest_ts_ms = i;
+        ticks.push_back(t);
+    }
+    return ticks;
+}
+
+// Limits of zero disable every check so each signal reaches the book on both paths
+static RiskLimits openLimits()
+{
+    RiskLimits limits;
+    limits.max_position = 0;
+    limits.max_notional = 0.0;
+    limits.max_orders_per_sec = 0.0;
+    limits.price_band_pct = 0.0;
+    return limits;
+}
+
+struct RunResult
+{
+    double ns_per_tick;
+    int trades;
+    double allocs_per_tick;
+    uint64_t submit_allocs;
+};
+
+static bool count_only = false;
+static constexpr size_t WARMUP_TICKS = 1000;
+
+// Wraps one order submission and charges any allocation inside it to `total`
+template <typename Fn>
+static void countSubmit(uint64_t &total, Fn &&fn)
+{
+    uint64_t before = allocations;
+    fn();
+    total += allocations - before;
+}
+
+static RunResult runDynamic(const std::string &name, const std::vector<MarketTick> &ticks)
+{
+    OrderBook book;
+    RiskGate risk;
+    risk.setDefaultLimits(openLimits());
+    int orders = 0;
+    uint64_t submit_allocs = 0;
+    std::unique_ptr<IStrategy> strategy = makeStrategy(name, book);
+    strategy->on_order = [&](const Order &order)
+    {
+        countSubmit(submit_allocs, [&]
+                    {
+            if (risk.check(order) != RiskReject::NONE)
+                return;
+            if (count_only)
+                ++orders;
+            else
+                book.submitOrder(order); });
+    };
+    IStrategy *s = strategy.get();
+    auto step = [&](const MarketTick &tick)
+    {
+        book.markToMarket(tick);
+        risk.onMarketTick(tick);
+        // Traced like StrategySlot::onTick, the dynamic path in the engine
+        TraceScope trace("onMarketTick");
+        s->onMarketTick(tick);
+    };
+    for (size_t i = 0; i < std::min(WARMUP_TICKS, ticks.size()); ++i)
+        step(ticks[i]);
+    submit_allocs = 0;
+    orders = 0;
+    int base_trades = book.getTradeCount();
+    uint64_t allocs_before = allocations;
+    auto start = std::chrono::steady_clock::now();
+    for (const auto &tick : ticks)
+        step(tick);
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    return {static_cast<double>(ns) / ticks.size(), count_only ? orders : book.getTradeCount() - base_trades,
+            static_cast<double>(allocations - allocs_before) / ticks.size(), submit_allocs};
+}
+
+template <typename Strategy>
+static RunResult runStatic(const std::vector<MarketTick> &ticks)
+{
+    OrderBook book;
+    RiskGate risk;
+    risk.setDefaultLimits(openLimits());
+    int orders = 0;
+    uint64_t submit_allocs = 0;
+    // The risk check runs inside the pipeline's sink, so only the execute step is charged here
+    auto execute = [&orders, &submit_allocs](OrderBook &b, const Order &order)
+    {
+        countSubmit(submit_allocs, [&]
+                    {
+            if (count_only)
+                ++orders;
+            else
+                b.submitOrder(order); });
+    };
+    StaticPipeline<Strategy, decltype(execute)> pipeline(book, risk, execute);
+    for (size_t i = 0; i < std::min(WARMUP_TICKS, ticks.size()); ++i)
+        pipeline.onTick(ticks[i]);
+    submit_allocs = 0;
+    orders = 0;
+    int base_trades = book.getTradeCount();
+    uint64_t allocs_before = allocations;
+    auto start = std::chrono::steady_clock::now();
+    for (const auto &tick : ticks)
+        pipeline.onTick(tick);
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    return {static_cast<double>(ns) / ticks.size(), count_only ? orders : book.getTradeCount() - base_trades,
+            static_cast<double>(allocations - allocs_before) / ticks.size(), submit_allocs};
+}
+
+static RunResult runStaticByName(const std::string &name, const std::vector<MarketTick> &ticks)
+{
+    if (name == "momentum")
+        return runStatic<MomentumStrategy>(ticks);
+    if (name == "mean_reversion")
+        return runStatic<MeanReversionStrategy>(ticks);
+    if (name == "breakout")
+        return runStatic<BreakoutStrategy>(ticks);
+    if (name == "vwap_reversion")
+        return runStatic<VwapReversionStrategy>(ticks);
+    if (name == "macd")
+        return runStatic<MacdStrategy>(ticks);
+    if (name == "rsi")
+        return runStatic<RsiStrategy>(ticks);
+    return runStatic<BollingerStrategy>(ticks);
+}
+
+int main(int argc, char **argv)
+{
+    int tick_count = 1000000;
+    int venues = 4;
+    int runs = 5;
+    bool trace = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        const char *a = argv[i];
+        if (starts_with(a, "--ticks="))
+            tick_count = std::atoi(a + 8);
+        else if (starts_with(a, "--venues="))
+            venues = std::max(1, std::atoi(a + 9));
+        else if (starts_with(a, "--runs="))
+            runs = std::max(1, std::atoi(a + 7));
+        else if (std::strcmp(a, "--count_only") == 0)
+            count_only = true;
+        else if (std::strcmp(a, "--trace") == 0)
+            trace = true;
+    }
+    // Both paths open the same onMarketTick scope; off by default so the numbers show the pipeline
+    // itself rather than the ring writes
+    setTracingEnabled(trace);
+
+    std::vector<MarketTick> ticks = makeTicks(tick_count, venues);
+    std::printf("%-16s %14s %14s %8s %10s %12s %13s\n", "strategy", "dynamic ns/tick", "static ns/tick", "speedup",
+                count_only ? "orders" : "trades", "allocs/tick", "submit allocs");
+    bool submit_allocated = false;
+    for (const auto &name : strategyNames())
+    {
+        // Best of N to keep scheduler noise out of the comparison
+        RunResult dyn{1e18, 0, 0.0, 0};
+        RunResult stat{1e18, 0, 0.0, 0};
+        for (int r = 0; r < runs; ++r)
+        {
+            RunResult d = runDynamic(name, ticks);
+            RunResult s = runStaticByName(name, ticks);
+            if (d.ns_per_tick < dyn.ns_per_tick)
+                dyn = d;
+            if (s.ns_per_tick < stat.ns_per_tick)
+                stat = s;
+        }
+        if (dyn.trades != stat.trades)
+            std::fprintf(stderr, "%s: trade count mismatch (dynamic %d, static %d)\n", name.c_str(), dyn.trades, stat.trades);
+        uint64_t submit_allocs = dyn.submit_allocs + stat.submit_allocs;
+        submit_allocated = submit_allocated || submit_allocs > 0;
+        std::printf("%-16s %14.1f %14.1f %7.2fx %10d %12.3f %13llu\n", name.c_str(), dyn.ns_per_tick, stat.ns_per_tick,
+                    dyn.ns_per_tick / stat.ns_per_tick, stat.trades, stat.allocs_per_tick,
+                    static_cast<unsigned long long>(submit_allocs));
+    }
+    if (submit_allocated)
+    {
+        std::fprintf(stderr, "order submission allocated on the steady-state path\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,367 @@
+// Local stand-in for the Coinbase Advanced Trade WebSocket: a TLS WebSocket server that answers
+// market_trades subscriptions, so the live feed's reconnect, resubscribe and gap handling can be
+// exercised without the exchange. Each connection gets its own sequence_num counter, starting
+// at 0, with a subscriptions ack, then a snapshot of the last 50 trades per product. After that
+// it sends captured messages from --messages (one raw message per line, replayed in a loop with
+// their sequence_num rewritten) or generated trades for the subscribed products. Trade ids run
+// on across connections, so the snapshot after a reconnect overlaps trades already delivered,
+// as it does on the exchange.
+//
+// The server certificate is self-signed for localhost and written to --cert_out, so the feed can
+// verify it:
+//
+//   tradepulse_coinbase_standin [--port=8443] [--cert_out=standin-cert.pem] [--cert=PEM --key=PEM]
+//       [--messages=PATH] [--rate=MSGS_PER_SEC] [--gap_every=N] [--drop_after=N]
+//   tradepulse --source=live --feed_url=wss://localhost:8443 --feed_ca=standin-cert.pem
+//       --products=BTC-USD,ETH-USD --feed_connections=2
+//
+// --gap_every=N skips one sequence number every N messages; --drop_after=N closes each
+// connection without a close frame after N messages.
+
+#include <boost/asio.hpp>
+#include <boost/beast.hpp>
+#include <boost/beast/ssl.hpp>
+#include <boost/beast/websocket.hpp>
+#include <boost/beast/websocket/ssl.hpp>
+#include <openssl/pem.h>
+#include <openssl/x509v3.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using tcp = boost::asio::ip::tcp;
+namespace asio = boost::asio;
+namespace beast = boost::beast;
+namespace ssl = boost::asio::ssl;
+namespace websocket = boost::beast::websocket;
+
+static bool starts_with(const char *s, const char *p) { return std::strncmp(s, p, std::strlen(p)) == 0; }
+
+struct StandinConfig
+{
+    unsigned short port{8443};
+    std::string cert_out{"standin-cert.pem"};
+    std::string cert_file;
+    std::string key_file;
+    std::string messages_file;
+    double rate{50.0};
+    int gap_every{0};
+    int drop_after{0};
+};
+
+// Shared by every connection, so trade ids and prices carry on across reconnects
+struct ProductState
+{
+    int64_t last_trade_id{100000000};
+    double price{100.0};
+};
+
+static std::mutex g_products_mutex;
+static std::map<std::string, ProductState> g_products;
+static std::vector<std::string> g_captured;
+static std::atomic<int> g_next_connection{0};
+
+// Caller holds g_products_mutex. Products start 100 apart (100, 200, ...) in first-seen order, so
+// a client that mixed two products' prices would show it at once.
+static ProductState &productState(const std::string &product)
+{
+    auto it = g_products.find(product);
+    if (it == g_products.end())
+    {
+        ProductState state;
+        state.price = 100.0 * static_cast<double>(g_products.size() + 1);
+        it = g_products.emplace(product, state).first;
+    }
+    return it->second;
+}
+
+static int64_t nowMs()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+static std::string isoTime(int64_t ms)
+{
+    time_t secs = static_cast<time_t>(ms / 1000);
+    struct tm tm;
+    gmtime_r(&secs, &tm);
+    char buf[64];
+    size_t n = std::strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%S", &tm);
+    std::snprintf(buf + n, sizeof(buf) - n, ".%03d000Z", static_cast<int>(ms % 1000));
+    return buf;
+}
+
+// Self-signed P-256 certificate for localhost / 127.0.0.1, valid for a day
+static bool makeSelfSigned(ssl::context &ctx, const std::string &cert_out)
+{
+    EVP_PKEY *key = EVP_EC_gen("P-256");
+    X509 *cert = X509_new();
+    if (!key || !cert)
+        return false;
+    X509_set_version(cert, 2);
+    ASN1_INTEGER_set(X509_get_serialNumber(cert), static_cast<long>(std::time(nullptr)));
+    X509_gmtime_adj(X509_getm_notBefore(cert), -3600);
+    X509_gmtime_adj(X509_getm_notAfter(cert), 86400);
+    X509_set_pubkey(cert, key);
+    X509_NAME *name = X509_get_subject_name(cert);
+    X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC, reinterpret_cast<const unsigned char *>("localhost"), -1, -1, 0);
+    X509_set_issuer_name(cert, name);
+    X509V3_CTX v3;
+    X509V3_set_ctx_nodb(&v3);
+    X509V3_set_ctx(&v3, cert, cert, nullptr, nullptr, 0);
+    X509_EXTENSION *san = X509V3_EXT_conf_nid(nullptr, &v3, NID_subject_alt_name, "DNS:localhost,IP:127.0.0.1");
+    bool ok = san && X509_add_ext(cert, san, -1) && X509_sign(cert, key, EVP_sha256()) &&
+              SSL_CTX_use_certificate(ctx.native_handle(), cert) == 1 && SSL_CTX_use_PrivateKey(ctx.native_handle(), key) == 1;
+    if (ok)
+    {
+        FILE *out = std::fopen(cert_out.c_str(), "w");
+        ok = out && PEM_write_X509(out, cert) == 1;
+        if (out)
+            std::fclose(out);
+    }
+    X509_EXTENSION_free(san);
+    X509_free(cert);
+    EVP_PKEY_free(key);
+    return ok;
+}
+
+// "product_ids":["A","B"] out of a subscribe message
+static std::vector<std::string> subscribedProducts(const std::string &msg)
+{
+    std::vector<std::string> products;
+    size_t pos = msg.find("\"product_ids\"");
+    pos = pos == std::string::npos ? pos : msg.find('[', pos);
+    size_t end = pos == std::string::npos ? pos : msg.find(']', pos);
+    while (end != std::string::npos)
+    {
+        size_t open = msg.find('"', pos);
+        size_t close = open < end ? msg.find('"', open + 1) : std::string::npos;
+        if (close == std::string::npos || close > end)
+            break;
+        products.push_back(msg.substr(open + 1, close - open - 1));
+        pos = close + 1;
+    }
+    return products;
+}
+
+static std::string tradeJson(const std::string &product, int64_t trade_id, double price, double size, bool buy, int64_t ms)
+{
+    char buf[256];
+    std::snprintf(buf, sizeof(buf),
+                  "{\"trade_id\":\"%lld\",\"product_id\":\"%s\",\"price\":\"%.2f\",\"size\":\"%.8f\",\"side\":\"%s\",\"time\":\"%s\"}",
+                  static_cast<long long>(trade_id), product.c_str(), price, size, buy ? "BUY" : "SELL", isoTime(ms).c_str());
+    return buf;
+}
+
+static std::string envelope(const char *channel, int64_t seq, const std::string &events)
+{
+    return std::string("{\"channel\":\"") + channel + "\",\"client_id\":\"\",\"timestamp\":\"" + isoTime(nowMs()) +
+           "\",\"sequence_num\":" + std::to_string(seq) + ",\"events\":[" + events + "]}";
+}
+
+// The 50 most recent trades of each product, newest first
+static std::string snapshotMessage(const std::vector<std::string> &products, int64_t seq)
+{
+    std::string trades;
+    int64_t now = nowMs();
+    std::lock_guard<std::mutex> lock(g_products_mutex);
+    for (const auto &product : products)
+    {
+        ProductState &state = productState(product);
+        for (int i = 0; i < 50; ++i)
+        {
+            if (!trades.empty())
+                trades += ",";
+            trades += tradeJson(product, state.last_trade_id - i, state.price, 0.01, i % 2 == 0, now - i);
+        }
+    }
+    return envelope("market_trades", seq, "{\"type\":\"snapshot\",\"trades\":[" + trades + "]}");
+}
+
+static std::string updateMessage(const std::vector<std::string> &products, int64_t seq, std::mt19937_64 &rng)
+{
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    const std::string &product = products[static_cast<size_t>(unit(rng) * products.size()) % products.size()];
+    int count = 1 + static_cast<int>(unit(rng) * 3);
+    int64_t now = nowMs();
+    std::string trades;
+    std::lock_guard<std::mutex> lock(g_products_mutex);
+    ProductState &state = productState(product);
+    int64_t first_id = state.last_trade_id + 1;
+    state.last_trade_id += count;
+    // Newest first, as Coinbase sends them
+    for (int t = count - 1; t >= 0; --t)
+    {
+        state.price = std::max(0.01, state.price + std::round((unit(rng) - 0.5) * 20) / 100.0);
+        if (!trades.empty())
+            trades += ",";
+        trades += tradeJson(product, first_id + t, state.price, unit(rng) * 0.5, unit(rng) < 0.5, now);
+    }
+    return envelope("market_trades", seq, "{\"type\":\"update\",\"trades\":[" + trades + "]}");
+}
+
+// A captured message with its sequence_num replaced
+static std::string resequenced(const std::string &msg, int64_t seq)
+{
+    size_t pos = msg.find("\"sequence_num\":");
+    if (pos == std::string::npos)
+        return msg;
+    size_t start = pos + 15;
+    size_t end = msg.find_first_not_of("0123456789 ", start);
+    return msg.substr(0, start) + std::to_string(seq) + msg.substr(end == std::string::npos ? msg.size() : end);
+}
+
+static void serveConnection(tcp::socket socket, ssl::context &ctx, const StandinConfig &cfg)
+{
+    int id = g_next_connection++;
+    std::mt19937_64 rng(static_cast<uint64_t>(id) * 7919 + 1);
+    try
+    {
+        websocket::stream<beast::ssl_stream<tcp::socket>> ws(std::move(socket), ctx);
+        ws.next_layer().handshake(ssl::stream_base::server);
+        ws.accept();
+        ws.text(true);
+
+        // Wait for the market_trades subscription; any later subscribe (heartbeats) stays unread
+        std::vector<std::string> products;
+        while (products.empty())
+        {
+            beast::flat_buffer buffer;
+            ws.read(buffer);
+            std::string msg = beast::buffers_to_string(buffer.data());
+            if (msg.find("\"market_trades\"") != std::string::npos)
+                products = subscribedProducts(msg);
+        }
+        std::cout << "connection " << id << ": subscribed to " << products.size() << " product(s)" << std::endl;
+
+        int64_t seq = 0;
+        int sent = 0;
+        auto send = [&](const std::string &msg)
+        {
+            ws.write(asio::buffer(msg));
+            ++sent;
+            if (cfg.gap_every > 0 && sent % cfg.gap_every == 0)
+                ++seq; // the message that would have carried this number is "lost"
+        };
+        send(envelope("subscriptions", seq++, "{\"subscriptions\":{\"market_trades\":[]}}"));
+        send(snapshotMessage(products, seq++));
+
+        auto interval = std::chrono::microseconds(static_cast<int64_t>(1e6 / std::max(0.1, cfg.rate)));
+        auto next = std::chrono::steady_clock::now();
+        auto next_heartbeat = next + std::chrono::seconds(1);
+        size_t captured = 0;
+        int64_t heartbeats = 0;
+        for (;;)
+        {
+            if (cfg.drop_after > 0 && sent >= cfg.drop_after)
+            {
+                std::cout << "connection " << id << ": dropping after " << sent << " messages" << std::endl;
+                beast::error_code ignored;
+                beast::get_lowest_layer(ws).shutdown(tcp::socket::shutdown_both, ignored);
+                beast::get_lowest_layer(ws).close(ignored);
+                return;
+            }
+            next += interval;
+            std::this_thread::sleep_until(next);
+            if (!g_captured.empty())
+                send(resequenced(g_captured[captured++ % g_captured.size()], seq++));
+            else
+                send(updateMessage(products, seq++, rng));
+            if (std::chrono::steady_clock::now() >= next_heartbeat)
+            {
+                next_heartbeat += std::chrono::seconds(1);
+                std::string beat = "{\"current_time\":\"" + isoTime(nowMs()) + "\",\"heartbeat_counter\":" + std::to_string(++heartbeats) + "}";
+                send(envelope("heartbeats", seq++, beat));
+            }
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cout << "connection " << id << ": closed (" << e.what() << ")" << std::endl;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    StandinConfig cfg;
+    for (int i = 1; i < argc; ++i)
+    {
+        const char *a = argv[i];
+        if (starts_with(a, "--port="))
+            cfg.port = static_cast<unsigned short>(std::atoi(a + 7));
+        else if (starts_with(a, "--cert_out="))
+            cfg.cert_out = a + 11;
+        else if (starts_with(a, "--cert="))
+            cfg.cert_file = a + 7;
+        else if (starts_with(a, "--key="))
+            cfg.key_file = a + 6;
+        else if (starts_with(a, "--messages="))
+            cfg.messages_file = a + 11;
+        else if (starts_with(a, "--rate="))
+            cfg.rate = std::atof(a + 7);
+        else if (starts_with(a, "--gap_every="))
+            cfg.gap_every = std::atoi(a + 12);
+        else if (starts_with(a, "--drop_after="))
+            cfg.drop_after = std::atoi(a + 13);
+    }
+
+    if (!cfg.messages_file.empty())
+    {
+        std::ifstream in(cfg.messages_file);
+        if (!in.is_open())
+        {
+            std::fprintf(stderr, "Failed to open %s\n", cfg.messages_file.c_str());
+            return 1;
+        }
+        std::string line;
+        while (std::getline(in, line))
+        {
+            if (!line.empty())
+                g_captured.push_back(line);
+        }
+    }
+
+    ssl::context ctx(ssl::context::tlsv12_server);
+    try
+    {
+        if (!cfg.cert_file.empty())
+        {
+            ctx.use_certificate_chain_file(cfg.cert_file);
+            ctx.use_private_key_file(cfg.key_file.empty() ? cfg.cert_file : cfg.key_file, ssl::context::pem);
+        }
+        else if (!makeSelfSigned(ctx, cfg.cert_out))
+        {
+            std::fprintf(stderr, "Failed to create a certificate at %s\n", cfg.cert_out.c_str());
+            return 1;
+        }
+
+        asio::io_context ioc;
+        tcp::acceptor acceptor(ioc, tcp::endpoint(tcp::v4(), cfg.port));
+        std::cout << "Coinbase stand-in on wss://localhost:" << cfg.port << " ("
+                  << (g_captured.empty() ? std::string("generated trades") : std::to_string(g_captured.size()) + " captured messages")
+                  << ")" << std::endl;
+        for (;;)
+        {
+            tcp::socket socket(ioc);
+            acceptor.accept(socket);
+            std::thread(serveConnection, std::move(socket), std::ref(ctx), std::cref(cfg)).detach();
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+}
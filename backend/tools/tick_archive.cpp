@@ -0,0 +1,136 @@
+// Converts a tick recording (NDJSON, binary or an existing archive) into the compressed archive
+// format, checks that every tick decodes back bit for bit, and times column decoding.
+//
+//   tradepulse_archive --in=PATH --out=PATH [--block_rows=N] [--no_checksum] [--runs=N]
+
+#include "replay_feed.h"
+#include "tick_archive.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static bool starts_with(const char *s, const char *p) { return std::strncmp(s, p, std::strlen(p)) == 0; }
+
+static uint64_t fileSize(const std::string &path)
+{
+    struct stat st;
+    return ::stat(path.c_str(), &st) == 0 ? static_cast<uint64_t>(st.st_size) : 0;
+}
+
+static bool sameBits(double a, double b) { return std::memcmp(&a, &b, sizeof(a)) == 0; }
+
+int main(int argc, char **argv)
+{
+    std::string in_path;
+    std::string out_path;
+    size_t block_rows = 65536;
+    bool checksum = true;
+    int runs = 5;
+    for (int i = 1; i < argc; ++i)
+    {
+        const char *a = argv[i];
+        if (starts_with(a, "--in="))
+            in_path = a + 5;
+        else if (starts_with(a, "--out="))
+            out_path = a + 6;
+        else if (starts_with(a, "--block_rows="))
+            block_rows = static_cast<size_t>(std::max(1, std::atoi(a + 13)));
+        else if (std::strcmp(a, "--no_checksum") == 0)
+            checksum = false;
+        else if (starts_with(a, "--runs="))
+            runs = std::max(1, std::atoi(a + 7));
+    }
+    if (in_path.empty() || out_path.empty())
+    {
+        std::fprintf(stderr, "usage: %s --in=PATH --out=PATH [--block_rows=N] [--no_checksum] [--runs=N]\n", argv[0]);
+        return 2;
+    }
+
+    int fd = ::open(out_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+        std::fprintf(stderr, "Failed to open %s\n", out_path.c_str());
+        return 1;
+    }
+    std::string out(TICK_ARCHIVE_MAGIC, sizeof(TICK_ARCHIVE_MAGIC));
+    TickArchiveEncoder encoder(checksum);
+    bool write_ok = true;
+    auto flush = [&]()
+    {
+        encoder.finish(out);
+        write_ok = write_ok && ::write(fd, out.data(), out.size()) == static_cast<ssize_t>(out.size());
+        out.clear();
+    };
+
+    std::vector<MarketTick> source;
+    auto t0 = std::chrono::steady_clock::now();
+    if (!ReplayFeed::forEachTick(in_path, [&](MarketTick &tick)
+                                 {
+            source.push_back(tick);
+            encoder.add(tick);
+            if (encoder.rows() >= block_rows)
+                flush();
+            return true; }))
+    {
+        std::fprintf(stderr, "Failed to open %s\n", in_path.c_str());
+        return 1;
+    }
+    flush();
+    ::close(fd);
+    double encode_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    if (!write_ok)
+    {
+        std::fprintf(stderr, "Failed to write %s\n", out_path.c_str());
+        return 1;
+    }
+
+    uint64_t in_bytes = fileSize(in_path);
+    uint64_t out_bytes = fileSize(out_path);
+    std::printf("%zu ticks: %llu -> %llu bytes (%.1fx, %.1f bytes/tick), read+encode %.1f ms\n", source.size(),
+                static_cast<unsigned long long>(in_bytes), static_cast<unsigned long long>(out_bytes),
+                out_bytes > 0 ? static_cast<double>(in_bytes) / out_bytes : 0.0,
+                source.empty() ? 0.0 : static_cast<double>(out_bytes) / source.size(), encode_ms);
+
+    // Round trip through ReplayFeed, as a replay would read it
+    size_t index = 0, mismatches = 0;
+    ReplayFeed::forEachTick(out_path, [&](MarketTick &tick)
+                            {
+        if (index >= source.size())
+        {
+            ++mismatches;
+            return true;
+        }
+        const MarketTick &s = source[index++];
+        if (tick.venue != s.venue || tick.symbol != s.symbol || !sameBits(tick.price, s.price) || !sameBits(tick.size, s.size) ||
+            tick.exchange_recv_ts_ms != s.exchange_recv_ts_ms || tick.ingest_ts_ms != s.ingest_ts_ms)
+            ++mismatches;
+        return true; });
+    mismatches += source.size() - std::min(index, source.size());
+    std::printf("round trip: %zu mismatches\n", mismatches);
+
+    // Column decode only (file in page cache), best of `runs`
+    double best_ms = 0;
+    for (int r = 0; r < runs; ++r)
+    {
+        size_t rows = 0;
+        auto start = std::chrono::steady_clock::now();
+        TickArchive::read(out_path, [&](const ReplayBatch &batch)
+                          {
+            rows += batch.rows();
+            return true; });
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (r == 0 || ms < best_ms)
+            best_ms = ms;
+        if (rows != source.size())
+            ++mismatches;
+    }
+    double secs = best_ms / 1000.0;
+    std::printf("decode %s checksum: %.2f ms, %.1f M ticks/s, %.0f MB/s archive, %.2f GB/s source-equivalent\n",
+                checksum ? "with" : "without", best_ms, source.size() / secs / 1e6, out_bytes / secs / 1e6,
+                in_bytes / secs / 1e9);
+    return mismatches == 0 ? 0 : 1;
+}
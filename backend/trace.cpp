@@ -0,0 +1,172 @@
+#include "trace.h"
+#include "data_source.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+std::atomic<bool> g_trace_enabled{true};
+
+// Fields are relaxed atomics so a concurrent export is not a data race; the owning thread is
+// the only writer and publishes each event by bumping head with release
+struct TraceRecord
+{
+    std::atomic<const char *> name{nullptr};
+    std::atomic<uint64_t> start{0};
+    std::atomic<uint64_t> end{0};
+};
+
+struct ThreadTrace
+{
+    std::atomic<uint64_t> head{0};
+    TraceRecord ring[TRACE_RING_EVENTS];
+    int tid{0};
+    bool in_use{false};
+    char name[32]{};
+};
+
+// Buffers outlive their threads and are handed to the next thread that starts tracing
+static std::mutex registry_mutex;
+static std::vector<std::unique_ptr<ThreadTrace>> registry;
+
+// TSC -> steady clock mapping, anchored at startup and re-measured on every export
+static const uint64_t base_ticks = traceNow();
+static const int64_t base_ns = steadyNowNs();
+
+static ThreadTrace *acquireBuffer()
+{
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    for (auto &buffer : registry)
+    {
+        if (!buffer->in_use)
+        {
+            buffer->in_use = true;
+            buffer->head.store(0, std::memory_order_relaxed);
+            std::snprintf(buffer->name, sizeof(buffer->name), "thread %d", buffer->tid);
+            return buffer.get();
+        }
+    }
+    registry.push_back(std::make_unique<ThreadTrace>());
+    ThreadTrace *buffer = registry.back().get();
+    buffer->tid = static_cast<int>(registry.size());
+    buffer->in_use = true;
+    std::snprintf(buffer->name, sizeof(buffer->name), "thread %d", buffer->tid);
+    return buffer;
+}
+
+struct ThreadTraceOwner
+{
+    ThreadTrace *buffer{nullptr};
+    ~ThreadTraceOwner()
+    {
+        if (!buffer)
+            return;
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        buffer->in_use = false;
+    }
+};
+
+static thread_local ThreadTraceOwner owner;
+
+static ThreadTrace &threadBuffer()
+{
+    if (!owner.buffer)
+        owner.buffer = acquireBuffer();
+    return *owner.buffer;
+}
+
+struct ExportedEvent
+{
+    const char *name;
+    uint64_t start;
+    uint64_t end;
+};
+
+void setTracingEnabled(bool enabled) { g_trace_enabled.store(enabled, std::memory_order_relaxed); }
+
+void setTraceThreadName(const char *name)
+{
+    ThreadTrace &buffer = threadBuffer();
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    std::snprintf(buffer.name, sizeof(buffer.name), "%s", name);
+}
+
+uint64_t traceNow()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(steadyNowNs());
+#endif
+}
+
+void traceEvent(const char *name, uint64_t start, uint64_t end)
+{
+    ThreadTrace &buffer = threadBuffer();
+    uint64_t head = buffer.head.load(std::memory_order_relaxed);
+    TraceRecord &record = buffer.ring[head & (TRACE_RING_EVENTS - 1)];
+    record.name.store(name, std::memory_order_relaxed);
+    record.start.store(start, std::memory_order_relaxed);
+    record.end.store(end, std::memory_order_relaxed);
+    buffer.head.store(head + 1, std::memory_order_release);
+}
+
+std::string traceToChromeJson(int64_t window_ms)
+{
+    static_assert((TRACE_RING_EVENTS & (TRACE_RING_EVENTS - 1)) == 0, "ring size must be a power of two");
+
+    uint64_t now_ticks = traceNow();
+    int64_t now_ns = steadyNowNs();
+    double ns_per_tick = now_ticks > base_ticks ? static_cast<double>(now_ns - base_ns) / static_cast<double>(now_ticks - base_ticks) : 1.0;
+    int64_t cutoff_ns = now_ns - window_ms * 1000000;
+    auto toUs = [&](uint64_t ticks)
+    { return (base_ns + static_cast<double>(static_cast<int64_t>(ticks - base_ticks)) * ns_per_tick) / 1000.0; };
+
+    std::string out = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first = true;
+    char line[256];
+    std::vector<ExportedEvent> events;
+
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    for (const auto &buffer : registry)
+    {
+        std::snprintf(line, sizeof(line), "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+                      first ? "" : ",", buffer->tid, buffer->name);
+        out += line;
+        first = false;
+
+        // Copy the live window, then drop anything the writer lapped while we were reading
+        uint64_t head = buffer->head.load(std::memory_order_acquire);
+        uint64_t begin = head > TRACE_RING_EVENTS ? head - TRACE_RING_EVENTS : 0;
+        events.clear();
+        for (uint64_t i = begin; i < head; ++i)
+        {
+            const TraceRecord &record = buffer->ring[i & (TRACE_RING_EVENTS - 1)];
+            events.push_back({record.name.load(std::memory_order_relaxed), record.start.load(std::memory_order_relaxed),
+                              record.end.load(std::memory_order_relaxed)});
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t head_after = buffer->head.load(std::memory_order_relaxed);
+        uint64_t valid_from = head_after > TRACE_RING_EVENTS ? head_after - TRACE_RING_EVENTS : 0;
+        size_t skip = valid_from > begin ? std::min<size_t>(valid_from - begin, events.size()) : 0;
+
+        for (size_t i = skip; i < events.size(); ++i)
+        {
+            const ExportedEvent &event = events[i];
+            if (!event.name || toUs(event.end) * 1000.0 < static_cast<double>(cutoff_ns))
+                continue;
+            double start_us = toUs(event.start);
+            double dur_us = std::max(0.0, toUs(event.end) - start_us);
+            std::snprintf(line, sizeof(line), ",{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                          event.name, buffer->tid, start_us, dur_us);
+            out += line;
+        }
+    }
+    out += "]}";
+    return out;
+}
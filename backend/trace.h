@@ -0,0 +1,48 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Always-on hot-path tracing. Each thread that traces owns a fixed ring of complete events
+// (name, start, end) stamped with the TSC where available; recording is two timestamp reads and
+// a few relaxed stores into the thread's own ring, with no lock and no allocation. The newest
+// TRACE_RING_EVENTS events per thread are kept, older ones are overwritten.
+//
+// Event names must be string literals (only the pointer is stored).
+
+static constexpr size_t TRACE_RING_EVENTS = 8192;
+
+extern std::atomic<bool> g_trace_enabled;
+
+void setTracingEnabled(bool enabled);
+inline bool tracingEnabled() { return g_trace_enabled.load(std::memory_order_relaxed); }
+
+// Label for the calling thread in exported traces (e.g. "feed", "latency", "shard 2")
+void setTraceThreadName(const char *name);
+
+uint64_t traceNow();
+// Records one complete event on the calling thread's ring
+void traceEvent(const char *name, uint64_t start, uint64_t end);
+
+// Events of every thread that ended within the last window_ms, as Chrome trace_event JSON
+// (load in chrome://tracing or Perfetto)
+std::string traceToChromeJson(int64_t window_ms);
+
+// Traces the enclosing scope
+class TraceScope
+{
+public:
+    explicit TraceScope(const char *name) : name_(name), start_(tracingEnabled() ? traceNow() : 0) {}
+    ~TraceScope()
+    {
+        if (start_ != 0)
+            traceEvent(name_, start_, traceNow());
+    }
+    TraceScope(const TraceScope &) = delete;
+    TraceScope &operator=(const TraceScope &) = delete;
+
+private:
+    const char *name_;
+    uint64_t start_;
+};
@@ -1,9 +1,12 @@
 #include "websocket_server.h"
+#include "trace.h"
 #include <iostream>
 #include <sstream>
 #include <cstring>
 #include <unistd.h>
 #include <sys/socket.h>
+#include <sys/ioctl.h>
+#include <linux/sockios.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <openssl/sha.h>
@@ -36,26 +39,7 @@ void WebSocketServer::start()
         while (running_)
         {
             auto now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
-            std::string hb = heartbeatToJson(now_ms);
-            std::lock_guard<std::mutex> lock(clients_mutex_);
-            for (auto it = connected_clients_.begin(); it != connected_clients_.end();)
-            {
-                int client = *it;
-                try
-                {
-                    sendWebSocketFrame(client, hb);
-                    ++it;
-                }
-                catch (...)
-                {
-                    close(client);
-                    it = connected_clients_.erase(it);
-                    if (client_disconnected_callback_)
-                    {
-                        client_disconnected_callback_(client);
-                    }
-                }
-            }
+            broadcastRaw(heartbeatToJson(now_ms));
             std::this_thread::sleep_for(std::chrono::seconds(5));
         } });
 }
@@ -94,8 +78,22 @@ void WebSocketServer::stop()
 
 void WebSocketServer::broadcastMessage(const WebSocketMessage &message)
 {
-    std::string json_message = messageToJson(message);
+    TraceScope trace("broadcastMessage");
+    broadcastRaw(messageToJson(message));
+}
+
+void WebSocketServer::broadcastPnl(double realized_pnl, double unrealized_pnl, int64_t server_ts_ms)
+{
+    broadcastRaw(pnlToJson(realized_pnl, unrealized_pnl, server_ts_ms));
+}
+
+void WebSocketServer::broadcastBar(const Bar &bar)
+{
+    broadcastRaw(barToJson(bar));
+}
 
+void WebSocketServer::broadcastRaw(const std::string &json_message)
+{
     std::lock_guard<std::mutex> lock(clients_mutex_);
     for (auto it = connected_clients_.begin(); it != connected_clients_.end();)
     {
@@ -133,12 +131,98 @@ void WebSocketServer::setHttpHandler(std::function<std::string(const std::string
     http_handler_ = handler;
 }
 
+void WebSocketServer::addHttpStream(const std::string &prefix, const std::string &content_type, HttpStreamHandler handler)
+{
+    http_streams_.push_back(HttpStream{prefix, content_type, std::move(handler)});
+}
+
+const WebSocketServer::HttpStream *WebSocketServer::findStream(const std::string &method, const std::string &path) const
+{
+    if (method != "GET")
+        return nullptr;
+    for (const auto &stream : http_streams_)
+    {
+        if (path.rfind(stream.prefix, 0) == 0)
+            return &stream;
+    }
+    return nullptr;
+}
+
+// Whole buffer or false; MSG_NOSIGNAL so a client hanging up mid-stream is an error, not SIGPIPE
+static bool sendAll(int socket, const char *data, size_t len)
+{
+    while (len > 0)
+    {
+        ssize_t n = send(socket, data, len, MSG_NOSIGNAL);
+        if (n <= 0)
+            return false;
+        data += n;
+        len -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+void WebSocketServer::serveStream(int client_socket, const std::string &path, const std::string &content_type,
+                                  const HttpStreamHandler &handler)
+{
+    // Headers go out with the first piece of the body, so an error found up front can still be a 400
+    bool started = false;
+    bool open = true;
+    auto write = [&](const std::string &piece)
+    {
+        if (!open || piece.empty())
+            return open;
+        std::ostringstream chunk;
+        if (!started)
+        {
+            chunk << "HTTP/1.1 200 OK\r\n"
+                  << "Content-Type: " << content_type << "\r\n"
+                  << "Access-Control-Allow-Origin: *\r\n"
+                  << "Transfer-Encoding: chunked\r\n\r\n";
+            started = true;
+        }
+        chunk << std::hex << piece.size() << "\r\n"
+              << piece << "\r\n";
+        std::string bytes = chunk.str();
+        open = sendAll(client_socket, bytes.data(), bytes.size());
+        return open;
+    };
+    std::string error = handler(path, write);
+    if (!started)
+    {
+        std::ostringstream resp;
+        resp << "HTTP/1.1 " << (error.empty() ? "200 OK" : "400 Bad Request") << "\r\n"
+             << "Content-Type: " << (error.empty() ? content_type : "text/plain") << "\r\n"
+             << "Access-Control-Allow-Origin: *\r\n"
+             << "Content-Length: " << error.size() << "\r\n\r\n"
+             << error;
+        std::string bytes = resp.str();
+        sendAll(client_socket, bytes.data(), bytes.size());
+    }
+    else if (open)
+        sendAll(client_socket, "0\r\n\r\n", 5);
+}
+
 int WebSocketServer::getConnectedClients() const
 {
     std::lock_guard<std::mutex> lock(clients_mutex_);
     return connected_clients_.size();
 }
 
+std::vector<std::pair<int, int>> WebSocketServer::getClientBacklogs() const
+{
+    std::vector<std::pair<int, int>> backlogs;
+    std::lock_guard<std::mutex> lock(clients_mutex_);
+    for (int client : connected_clients_)
+    {
+        int queued = 0;
+        if (ioctl(client, SIOCOUTQ, &queued) != 0)
+            queued = -1;
+        backlogs.emplace_back(client, queued);
+    }
+    return backlogs;
+}
+
 void WebSocketServer::serverLoop()
 {
     // Create socket
@@ -255,6 +339,10 @@ void WebSocketServer::handleConnection(int client_socket)
                 "Content-Length: 0\r\n\r\n";
             send(client_socket, headers.c_str(), headers.size(), 0);
         }
+        else if (const HttpStream *stream = findStream(method, path))
+        {
+            serveStream(client_socket, path, stream->content_type, stream->handler);
+        }
         else
         {
             std::string body;
@@ -266,7 +354,7 @@ void WebSocketServer::handleConnection(int client_socket)
                 body = "TradePulse WebSocket Server";
             std::ostringstream resp;
             resp << "HTTP/1.1 200 OK\r\n"
-                 << "Content-Type: text/plain\r\n"
+                 << "Content-Type: " << (body[0] == '{' ? "application/json" : "text/plain") << "\r\n"
                  << "Access-Control-Allow-Origin: *\r\n"
                  << "Access-Control-Allow-Methods: GET, OPTIONS\r\n"
                  << "Access-Control-Allow-Headers: *\r\n"
@@ -342,8 +430,11 @@ void WebSocketServer::sendWebSocketFrame(int client_socket, const std::string &m
     int bytes_sent = send(client_socket, frame.c_str(), frame.length(), 0);
     if (bytes_sent <= 0)
     {
+        frames_dropped_.add();
         throw std::runtime_error("Failed to send WebSocket frame");
     }
+    frames_sent_.add();
+    bytes_sent_.add(static_cast<uint64_t>(bytes_sent));
 }
 
 std::string WebSocketServer::createWebSocketFrame(const std::string &message)
@@ -398,7 +489,8 @@ std::string WebSocketServer::messageToJson(const WebSocketMessage &message)
          << "\"ingest_ts_ms\":" << message.ingest_ts_ms << ","
          << "\"order_created_ts_ms\":" << message.order_created_ts_ms << ","
          << "\"order_executed_ts_ms\":" << message.order_executed_ts_ms << ","
-         << "\"server_broadcast_ts_ms\":" << message.server_broadcast_ts_ms
+         << "\"server_broadcast_ts_ms\":" << message.server_broadcast_ts_ms << ","
+         << "\"strategy\":\"" << message.strategy << "\""
          << "}";
     return json.str();
 }
@@ -408,4 +500,34 @@ std::string WebSocketServer::heartbeatToJson(int64_t server_ts_ms)
     std::ostringstream json;
     json << "{\"type\":\"hb\",\"server_ts_ms\":" << server_ts_ms << "}";
     return json.str();
-}
\ No newline at end of file
+}
+
+std::string WebSocketServer::pnlToJson(double realized_pnl, double unrealized_pnl, int64_t server_ts_ms)
+{
+    std::ostringstream json;
+    json << std::fixed << std::setprecision(6);
+    json << "{\"type\":\"pnl\","
+         << "\"realized_pnl\":" << realized_pnl << ","
+         << "\"unrealized_pnl\":" << unrealized_pnl << ","
+         << "\"total_pnl\":" << (realized_pnl + unrealized_pnl) << ","
+         << "\"server_ts_ms\":" << server_ts_ms << "}";
+    return json.str();
+}
+
+std::string WebSocketServer::barToJson(const Bar &bar)
+{
+    std::ostringstream json;
+    json << std::fixed << std::setprecision(6);
+    json << "{\"type\":\"bar\","
+         << "\"venue\":\"" << bar.venue << "\","
+         << "\"symbol\":\"" << bar.symbol << "\","
+         << "\"open\":" << bar.open << ","
+         << "\"high\":" << bar.high << ","
+         << "\"low\":" << bar.low << ","
+         << "\"close\":" << bar.close << ","
+         << "\"volume\":" << bar.volume << ","
+         << "\"ticks\":" << bar.ticks << ","
+         << "\"start_ts_ms\":" << bar.start_ts_ms << ","
+         << "\"end_ts_ms\":" << bar.end_ts_ms << "}";
+    return json.str();
+}
@@ -8,6 +8,8 @@
 #include <set>
 #include <mutex>
 #include <queue>
+#include "bars.h"
+#include "metrics.h"
 
 struct WebSocketMessage
 {
@@ -26,6 +28,7 @@ struct WebSocketMessage
     int64_t order_created_ts_ms;
     int64_t order_executed_ts_ms;
     int64_t server_broadcast_ts_ms;
+    std::string strategy;
 };
 
 class WebSocketServer
@@ -38,20 +41,37 @@ public:
     void stop();
 
     void broadcastMessage(const WebSocketMessage &message);
+    void broadcastPnl(double realized_pnl, double unrealized_pnl, int64_t server_ts_ms);
+    void broadcastBar(const Bar &bar);
     void setClientConnectedCallback(std::function<void(int)> callback);
     void setClientDisconnectedCallback(std::function<void(int)> callback);
     void setHttpHandler(std::function<std::string(const std::string &, const std::string &, const std::string &)> handler);
+    // GETs under `prefix` stream their body with chunked transfer encoding. The handler gets the
+    // path and a write function (false once the client has gone) and returns an error message,
+    // sent as a 400 if nothing was written yet, or "" on success.
+    using HttpStreamHandler = std::function<std::string(const std::string &, const std::function<bool(const std::string &)> &)>;
+    void addHttpStream(const std::string &prefix, const std::string &content_type, HttpStreamHandler handler);
 
     int getConnectedClients() const;
+    uint64_t getFramesSent() const { return frames_sent_.get(); }
+    uint64_t getBytesSent() const { return bytes_sent_.get(); }
+    // Frames not delivered because the send failed (the client is then dropped)
+    uint64_t getFramesDropped() const { return frames_dropped_.get(); }
+    // (client id, bytes queued in the kernel send buffer not yet acknowledged by the peer)
+    std::vector<std::pair<int, int>> getClientBacklogs() const;
 
 private:
     void serverLoop();
+    void broadcastRaw(const std::string &json_message);
     void handleConnection(int client_socket);
+    void serveStream(int client_socket, const std::string &path, const std::string &content_type, const HttpStreamHandler &handler);
     std::string performWebSocketHandshake(const std::string &request);
     void sendWebSocketFrame(int client_socket, const std::string &message);
     std::string createWebSocketFrame(const std::string &message);
     std::string messageToJson(const WebSocketMessage &message);
     std::string heartbeatToJson(int64_t server_ts_ms);
+    std::string pnlToJson(double realized_pnl, double unrealized_pnl, int64_t server_ts_ms);
+    std::string barToJson(const Bar &bar);
 
     int port_;
     int server_socket_;
@@ -69,4 +89,16 @@ private:
 
     std::thread heartbeat_thread_;
     std::function<std::string(const std::string &, const std::string &, const std::string &)> http_handler_;
+    struct HttpStream
+    {
+        std::string prefix;
+        std::string content_type;
+        HttpStreamHandler handler;
+    };
+    std::vector<HttpStream> http_streams_; // registered before start()
+    const HttpStream *findStream(const std::string &method, const std::string &path) const;
+
+    PaddedCounter frames_sent_;
+    PaddedCounter bytes_sent_;
+    PaddedCounter frames_dropped_;
 };
\ No newline at end of file
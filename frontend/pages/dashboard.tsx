@@ -1,6 +1,6 @@
 import React, { useState, useEffect, useCallback } from 'react';
 import Head from 'next/head';
-import { WebSocketClient, TradeData, HeartbeatData } from '../utils/websocket';
+import { WebSocketClient, TradeData, HeartbeatData, PnLData, BarData } from '../utils/websocket';
 import { TradeStream } from '../components/TradeStream';
 import { LatencyChart } from '../components/LatencyChart';
 import { PnLChart } from '../components/PnLChart';
@@ -9,9 +9,11 @@ export default function Dashboard() {
   const [trades, setTrades] = useState<TradeData[]>([]);
   const [connectionStatus, setConnectionStatus] = useState<'disconnected' | 'connecting' | 'connected'>('disconnected');
   const [wsClient, setWsClient] = useState<WebSocketClient | null>(null);
+  const [lastBar, setLastBar] = useState<BarData | null>(null);
   const [stats, setStats] = useState({
     totalTrades: 0,
     totalPnL: 0,
+    unrealizedPnL: 0,
     avgModelledLatency: 0,
     rttMs: 0,
     lastMessageAgeMs: 0,
@@ -48,6 +50,14 @@ export default function Dashboard() {
       setTrades(prevTrades => [...prevTrades, trade]);
     });
 
+    client.onPnL((pnl: PnLData) => {
+      setStats(prev => ({ ...prev, unrealizedPnL: pnl.unrealized_pnl }));
+    });
+
+    client.onBar((bar: BarData) => {
+      setLastBar(bar);
+    });
+
     client.onHeartbeat((hb: HeartbeatData) => {
       const now = Date.now();
       const rtt = Math.max(0, now - hb.server_ts_ms);
@@ -204,6 +214,7 @@ export default function Dashboard() {
               }`}>
                 {formatPnL(stats.totalPnL)}
               </div>
+              <div className="text-xs text-gray-400">Unrealized {formatPnL(stats.unrealizedPnL)}</div>
             </div>
             
             <div className="metric-card">
@@ -219,6 +230,16 @@ export default function Dashboard() {
             </div>
           </div>
 
+          {/* Last closed bar (only streamed when the backend runs with --bars) */}
+          {lastBar && (
+            <div className="metric-card mb-8">
+              <div className="text-sm text-gray-400">Last Bar ({lastBar.venue} {lastBar.symbol}, {lastBar.ticks} ticks)</div>
+              <div className="text-sm text-white font-mono">
+                O {lastBar.open.toFixed(2)} H {lastBar.high.toFixed(2)} L {lastBar.low.toFixed(2)} C {lastBar.close.toFixed(2)} V {lastBar.volume.toFixed(2)}
+              </div>
+            </div>
+          )}
+
           {/* Controls removed; backend controlled via CLI flags */}
 
           {/* Charts Grid */}
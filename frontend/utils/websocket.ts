@@ -13,6 +13,7 @@ export interface TradeData {
   order_created_ts_ms: number;
   order_executed_ts_ms: number;
   server_broadcast_ts_ms: number;
+  strategy?: string;
 }
 
 export interface LatencyData {
@@ -22,6 +23,28 @@ export interface LatencyData {
   ts: number;
 }
 
+export interface PnLData {
+  type: 'pnl';
+  realized_pnl: number;
+  unrealized_pnl: number;
+  total_pnl: number;
+  server_ts_ms: number;
+}
+
+export interface BarData {
+  type: 'bar';
+  venue: string;
+  symbol: string;
+  open: number;
+  high: number;
+  low: number;
+  close: number;
+  volume: number;
+  ticks: number;
+  start_ts_ms: number;
+  end_ts_ms: number;
+}
+
 export interface HeartbeatData {
   type: 'hb';
   server_ts_ms: number;
@@ -39,6 +62,8 @@ export class WebSocketClient {
   private onDisconnectCallback?: () => void;
   private onErrorCallback?: (error: Error) => void;
   private onHeartbeatCallback?: (hb: HeartbeatData) => void;
+  private onPnLCallback?: (pnl: PnLData) => void;
+  private onBarCallback?: (bar: BarData) => void;
   public lastServerTsMs: number = 0;
   public lastMessageAtMs: number = 0;
   public drops: number = 0;
@@ -95,6 +120,34 @@ export class WebSocketClient {
       this.onHeartbeatCallback?.(hb);
       return;
     }
+    if (data.type === 'pnl') {
+      const pnl: PnLData = {
+        type: 'pnl',
+        realized_pnl: data.realized_pnl ?? 0,
+        unrealized_pnl: data.unrealized_pnl ?? 0,
+        total_pnl: data.total_pnl ?? 0,
+        server_ts_ms: data.server_ts_ms ?? now,
+      };
+      this.onPnLCallback?.(pnl);
+      return;
+    }
+    if (data.type === 'bar') {
+      const bar: BarData = {
+        type: 'bar',
+        venue: data.venue,
+        symbol: data.symbol,
+        open: data.open,
+        high: data.high,
+        low: data.low,
+        close: data.close,
+        volume: data.volume ?? 0,
+        ticks: data.ticks ?? 0,
+        start_ts_ms: data.start_ts_ms ?? -1,
+        end_ts_ms: data.end_ts_ms ?? -1,
+      };
+      this.onBarCallback?.(bar);
+      return;
+    }
     if (data.type === 'latency') {
       const latency: LatencyData = {
         type: 'latency',
@@ -121,6 +174,7 @@ export class WebSocketClient {
         order_created_ts_ms: data.order_created_ts_ms ?? -1,
         order_executed_ts_ms: data.order_executed_ts_ms ?? -1,
         server_broadcast_ts_ms: data.server_broadcast_ts_ms ?? now,
+        strategy: data.strategy || undefined,
       };
       this.onTradeCallback?.(trade);
       return;
@@ -174,4 +228,12 @@ export class WebSocketClient {
   onHeartbeat(callback: (hb: HeartbeatData) => void) {
     this.onHeartbeatCallback = callback;
   }
+
+  onPnL(callback: (pnl: PnLData) => void) {
+    this.onPnLCallback = callback;
+  }
+
+  onBar(callback: (bar: BarData) => void) {
+    this.onBarCallback = callback;
+  }
 } 
\ No newline at end of file